@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -52,6 +52,13 @@ public:
 		if ((_mask & makeMask(Type::Prefab)) == 0) _node.removeKey("speedOfSound");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(referenceDistance)>::feedToHash(referenceDistance, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(lastPos)>::feedToHash(lastPos, _context, _hasher, makeMask(Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(speedOfSound)>::feedToHash(speedOfSound, _context, _hasher, makeMask(Type::Prefab));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "referenceDistance") {
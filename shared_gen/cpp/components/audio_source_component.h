@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -69,6 +69,16 @@ public:
 		if ((_mask & makeMask(Type::Prefab)) == 0) _node.removeKey("canAutoVel");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(event)>::feedToHash(event, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(rangeMin)>::feedToHash(rangeMin, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(rangeMax)>::feedToHash(rangeMax, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(rollOff)>::feedToHash(rollOff, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(curve)>::feedToHash(curve, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(canAutoVel)>::feedToHash(canAutoVel, _context, _hasher, makeMask(Type::Prefab));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "event") {
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -46,6 +46,12 @@ public:
 		if ((_mask & makeMask(Type::Prefab, Type::Dynamic)) == 0) _node.removeKey("intensity");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(colour)>::feedToHash(colour, _context, _hasher, makeMask(Type::Prefab, Type::Dynamic));
+		Halley::EntityConfigNodeSerializer<decltype(intensity)>::feedToHash(intensity, _context, _hasher, makeMask(Type::Prefab, Type::Dynamic));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "colour") {
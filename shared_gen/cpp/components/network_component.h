@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -43,6 +43,12 @@ public:
 		if ((_mask & makeMask(Type::SaveData, Type::Dynamic, Type::Network)) == 0) _node.removeKey("sendUpdates");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(locks)>::feedToHash(locks, _context, _hasher, makeMask(Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(sendUpdates)>::feedToHash(sendUpdates, _context, _hasher, makeMask(Type::SaveData, Type::Dynamic, Type::Network));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "sendUpdates") {
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -61,6 +61,15 @@ public:
 		if ((_mask & makeMask(Type::Prefab)) == 0) _node.removeKey("mask");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(particles)>::feedToHash(particles, _context, _hasher, makeMask(Type::Prefab));
+		Halley::EntityConfigNodeSerializer<decltype(sprites)>::feedToHash(sprites, _context, _hasher, makeMask(Type::Prefab));
+		Halley::EntityConfigNodeSerializer<decltype(animation)>::feedToHash(animation, _context, _hasher, makeMask(Type::Prefab));
+		Halley::EntityConfigNodeSerializer<decltype(layer)>::feedToHash(layer, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(mask)>::feedToHash(mask, _context, _hasher, makeMask(Type::Prefab));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "layer") {
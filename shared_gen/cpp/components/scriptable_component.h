@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -65,6 +65,16 @@ public:
 		if ((_mask & makeMask(Type::Prefab, Type::Dynamic)) == 0) _node.removeKey("entityParams");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(activeStates)>::feedToHash(activeStates, _context, _hasher, makeMask(Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(tags)>::feedToHash(tags, _context, _hasher, makeMask(Type::Prefab, Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(scripts)>::feedToHash(scripts, _context, _hasher, makeMask(Type::Prefab));
+		Halley::EntityConfigNodeSerializer<decltype(variables)>::feedToHash(variables, _context, _hasher, makeMask(Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(entityReferences)>::feedToHash(entityReferences, _context, _hasher, makeMask(Type::Prefab, Type::Dynamic));
+		Halley::EntityConfigNodeSerializer<decltype(entityParams)>::feedToHash(entityParams, _context, _hasher, makeMask(Type::Prefab, Type::Dynamic));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "tags") {
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -50,6 +50,13 @@ public:
 		if ((_mask & makeMask(Type::Prefab)) == 0) _node.removeKey("playOnStart");
 	}
 
+	void feedToHash(const Halley::EntitySerializationContext& _context, Halley::Hash::Hasher& _hasher) const {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(timeline)>::feedToHash(timeline, _context, _hasher, makeMask(Type::Prefab));
+		Halley::EntityConfigNodeSerializer<decltype(player)>::feedToHash(player, _context, _hasher, makeMask(Type::SaveData, Type::Dynamic, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(playOnStart)>::feedToHash(playOnStart, _context, _hasher, makeMask(Type::Prefab));
+	}
+
 	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "player") {
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 137
 #pragma once
 
 #include <halley.hpp>
@@ -19,7 +19,7 @@ public:
 		AudioListenerComponent& audioListener;
 		const Transform2DComponent& transform2D;
 	
-		using Type = Halley::FamilyType<AudioListenerComponent, Transform2DComponent>;
+		using Type = Halley::FamilyType<AudioListenerComponent, const Transform2DComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&audioListener);
@@ -40,7 +40,7 @@ public:
 		const Transform2DComponent& transform2D;
 		const Halley::MaybeRef<VelocityComponent> velocity{};
 	
-		using Type = Halley::FamilyType<AudioSourceComponent, Transform2DComponent, Halley::MaybeRef<VelocityComponent>>;
+		using Type = Halley::FamilyType<AudioSourceComponent, const Transform2DComponent, Halley::MaybeRef<const VelocityComponent>>;
 	
 		void prefetch() const {
 			prefetchL2(&audioSource);
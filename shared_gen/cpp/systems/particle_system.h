@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 137
 #pragma once
 
 #include <halley.hpp>
@@ -20,7 +20,7 @@ public:
 		ParticlesComponent& particles;
 		const Transform2DComponent& transform2D;
 	
-		using Type = Halley::FamilyType<ParticlesComponent, Transform2DComponent>;
+		using Type = Halley::FamilyType<ParticlesComponent, const Transform2DComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&particles);
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 137
 #pragma once
 
 #include <halley.hpp>
@@ -64,7 +64,7 @@ public:
 	public:
 		const ScriptTargetComponent& scriptTarget;
 	
-		using Type = Halley::FamilyType<ScriptTargetComponent>;
+		using Type = Halley::FamilyType<const ScriptTargetComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&scriptTarget);
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 137
 #pragma once
 
 #include <halley.hpp>
@@ -15,7 +15,7 @@ public:
 	public:
 		const ScriptableComponent& scriptable;
 	
-		using Type = Halley::FamilyType<ScriptableComponent>;
+		using Type = Halley::FamilyType<const ScriptableComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&scriptable);
@@ -32,7 +32,7 @@ public:
 	public:
 		const ScriptTagTargetComponent& scriptTagTarget;
 	
-		using Type = Halley::FamilyType<ScriptTagTargetComponent>;
+		using Type = Halley::FamilyType<const ScriptTagTargetComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&scriptTagTarget);
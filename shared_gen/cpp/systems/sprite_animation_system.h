@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 137
 #pragma once
 
 #include <halley.hpp>
@@ -22,7 +22,7 @@ public:
 		SpriteAnimationComponent& spriteAnimation;
 		const Transform2DComponent& transform2D;
 	
-		using Type = Halley::FamilyType<SpriteComponent, SpriteAnimationComponent, Transform2DComponent>;
+		using Type = Halley::FamilyType<SpriteComponent, SpriteAnimationComponent, const Transform2DComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&sprite);
@@ -45,7 +45,7 @@ public:
 		SpriteAnimationComponent& spriteAnimation;
 		const SpriteAnimationReplicatorComponent& spriteAnimationReplicator;
 	
-		using Type = Halley::FamilyType<SpriteComponent, SpriteAnimationComponent, SpriteAnimationReplicatorComponent>;
+		using Type = Halley::FamilyType<SpriteComponent, SpriteAnimationComponent, const SpriteAnimationReplicatorComponent>;
 	
 		void prefetch() const {
 			prefetchL2(&sprite);
@@ -19,7 +19,7 @@
 #endif
 
 #ifndef CTR
-  #define CTR 0
+  #define CTR 1
 #endif
 
 
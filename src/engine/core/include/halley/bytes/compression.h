@@ -5,6 +5,8 @@
 #include <optional>
 
 namespace Halley {
+	class ExecutionQueue;
+
 	class Compression {
 	public:
 		static Bytes compress(const Bytes& bytes, int level = -1);
@@ -42,5 +44,25 @@ namespace Halley {
 		static Bytes lz4CompressFile(gsl::span<const gsl::byte> src, gsl::span<const gsl::byte> header, LZ4Options options = {});
 		static Bytes lz4DecompressFile(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> header);
 		static std::shared_ptr<const char> lz4DecompressFileToSharedPtr(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> header, size_t& outSize);
+
+		// Chunked LZ4 files are split into independently compressed chunks, which can be decompressed in parallel, or one at a time by streams.
+		// Layout is LZ4ChunkedHeader, then the end offset of each chunk (relative to the end of that table) as uint64_t, then the chunks.
+		// Chunks that don't compress are stored as-is.
+		struct LZ4ChunkedHeader {
+			std::array<char, 4> id;
+			uint32_t chunkSize;
+			uint64_t size;
+
+			size_t getNumChunks() const;
+			size_t getChunkSize(size_t idx) const;
+			size_t getTableSize() const;
+		};
+
+		static Bytes lz4CompressChunked(gsl::span<const gsl::byte> src, LZ4Options options = {}, size_t chunkSize = 64 * 1024);
+		static std::optional<LZ4ChunkedHeader> readLZ4ChunkedHeader(gsl::span<const gsl::byte> src);
+		static void lz4DecompressChunk(const LZ4ChunkedHeader& header, size_t idx, gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst);
+
+		// Decompresses either a chunked or a regular LZ4 file. If queue is set, chunks are spread over it.
+		static std::shared_ptr<const char> lz4DecompressAnyToSharedPtr(gsl::span<const gsl::byte> src, size_t& outSize, ExecutionQueue* queue = nullptr);
 	};
 }
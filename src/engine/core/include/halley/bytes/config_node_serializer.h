@@ -12,10 +12,12 @@
 #include "halley/entity/entity_id.h"
 #include "halley/resources/resource_reference.h"
 #include "halley/support/logger.h"
+#include "halley/utils/hash.h"
 
 namespace Halley {
 	namespace Detail {
 		template<class T> using VoidDeserializer = decltype(std::declval<ConfigNodeSerializer<T>>().deserialize(std::declval<const EntitySerializationContext&>(), std::declval<const ConfigNode&>(), std::declval<T&>()));
+		template<class T> using HashFeeder = decltype(std::declval<ConfigNodeSerializer<T>>().feedToHash(std::declval<const T&>(), std::declval<const EntitySerializationContext&>(), std::declval<Hash::Hasher&>()));
 	}
 
 	template <typename T>
@@ -39,6 +41,18 @@ namespace Halley {
 			}
 		}
 		
+		// Uses the serializer's feedToHash if it has one; padding-free values are fed as bytes, anything else goes through ConfigNode
+		static void feedToHash(const T& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			if constexpr (is_detected<Detail::HashFeeder, T>::value) {
+				ConfigNodeSerializer<T>().feedToHash(value, context, hasher);
+			} else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::has_unique_object_representations_v<T>) {
+				hasher.feed(value);
+			} else {
+				serialize(value, context).feedToHash(hasher);
+			}
+		}
+
 		static void deserialize(T& dst, const EntitySerializationContext& context, const ConfigNode& node)
 		{
 			if (node.getType() == ConfigNodeType::Undefined || node.getType() == ConfigNodeType::Del) {
@@ -219,6 +233,12 @@ namespace Halley {
         {
 			return node.asVector2f(Vector2f());
         }
+
+		void feedToHash(Vector2f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.x);
+			hasher.feed(value.y);
+		}
     };
 
 	template <>
@@ -233,6 +253,12 @@ namespace Halley {
         {
 			return node.asFloatRange(Range<float>());
         }
+
+		void feedToHash(Range<float> value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.start);
+			hasher.feed(value.end);
+		}
     };
 
 	template <>
@@ -275,6 +301,13 @@ namespace Halley {
         {
 			return node.asVector3f(Vector3f());
         }
+
+		void feedToHash(Vector3f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.x);
+			hasher.feed(value.y);
+			hasher.feed(value.z);
+		}
     };
 
 	template <>
@@ -303,6 +336,14 @@ namespace Halley {
         {
 			return node.asVector4f(Vector4f());
         }
+
+		void feedToHash(Vector4f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.x);
+			hasher.feed(value.y);
+			hasher.feed(value.z);
+			hasher.feed(value.w);
+		}
     };
 
 	template <>
@@ -317,6 +358,11 @@ namespace Halley {
         {
 			return Angle1f::fromDegrees(node.asFloat(0.0f));
         }
+
+		void feedToHash(Angle1f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.getRadians());
+		}
     };
 
 	template <>
@@ -331,6 +377,14 @@ namespace Halley {
         {
 			return Colour4f::fromString(node.asString("#000000"));
         }
+
+		void feedToHash(Colour4f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.r);
+			hasher.feed(value.g);
+			hasher.feed(value.b);
+			hasher.feed(value.a);
+		}
     };
 
 	template <>
@@ -371,6 +425,14 @@ namespace Halley {
 				return Rect4f();
 			}
         }
+
+		void feedToHash(Rect4f value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.getX());
+			hasher.feed(value.getY());
+			hasher.feed(value.getWidth());
+			hasher.feed(value.getHeight());
+		}
     };
 
 	template <typename T>
@@ -393,6 +455,14 @@ namespace Halley {
 				return std::optional<T>(ConfigNodeSerializer<T>().deserialize(context, node));
 			}
         }
+
+		void feedToHash(const std::optional<T>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.has_value());
+			if (value) {
+				ConfigNodeHelper<T>::feedToHash(value.value(), context, hasher);
+			}
+		}
     };
 
 	template <typename T>
@@ -435,6 +505,18 @@ namespace Halley {
 				target.clear();
 			}
         }
+
+		void feedToHash(const Vector<T>& values, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			hasher.feed(values.size());
+			if constexpr (std::has_unique_object_representations_v<T>) {
+				hasher.feedBytes(gsl::as_bytes(gsl::span<const T>(values.data(), values.size())));
+			} else {
+				for (const auto& value: values) {
+					ConfigNodeHelper<T>::feedToHash(value, context, hasher);
+				}
+			}
+		}
 	};
 
 	template <typename T>
@@ -497,6 +579,12 @@ namespace Halley {
 			
 			return result;
 		}
+
+		void feedToHash(const std::pair<A, B>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			ConfigNodeHelper<A>::feedToHash(value.first, context, hasher);
+			ConfigNodeHelper<B>::feedToHash(value.second, context, hasher);
+		}
 	};
 
 	template <typename T>
@@ -577,6 +665,15 @@ namespace Halley {
 				}				
 			}
 		}
+
+		void feedToHash(const ResourceReference<T>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			if (value) {
+				ConfigNodeHelper<String>::feedToHash(value->getAssetId(), context, hasher);
+			} else {
+				hasher.feed(size_t(0));
+			}
+		}
 	};
 	
 	template<>
@@ -591,6 +688,12 @@ namespace Halley {
 		{
 			return node.asString("");
 		}
+
+		void feedToHash(const String& value, const EntitySerializationContext&, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.size());
+			hasher.feed(value);
+		}
 	};
 
 	template <>
@@ -741,6 +844,14 @@ namespace Halley {
 				return OptionalLite<T>(ConfigNodeSerializer<T>().deserialize(context, node));
 			}
 		}
+
+		void feedToHash(const OptionalLite<T>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			hasher.feed(value.has_value());
+			if (value) {
+				ConfigNodeHelper<T>::feedToHash(value.value(), context, hasher);
+			}
+		}
 	};
 
 	template <typename T>
@@ -764,6 +875,11 @@ namespace Halley {
 		{
 			dst = ConfigNodeSerializer<std::optional<T>>().deserialize(context, node);
 		}
+
+		static void feedToHash(const std::optional<T>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			ConfigNodeSerializer<std::optional<T>>().feedToHash(value, context, hasher);
+		}
 	};
 
 	template <typename T>
@@ -787,6 +903,11 @@ namespace Halley {
 		{
 			dst = ConfigNodeSerializer<OptionalLite<T>>().deserialize(context, node);
 		}
+
+		static void feedToHash(const OptionalLite<T>& value, const EntitySerializationContext& context, Hash::Hasher& hasher)
+		{
+			ConfigNodeSerializer<OptionalLite<T>>().feedToHash(value, context, hasher);
+		}
 	};
 	
 	namespace Detail
@@ -861,6 +982,14 @@ namespace Halley {
 			}
 		}
 
+		static void feedToHash(const T& value, const EntitySerializationContext& context, Hash::Hasher& hasher, int serializationMask)
+		{
+			// Cheap change detection; this doesn't need to match the serialized form, only change whenever it would
+			if (context.matchType(serializationMask)) {
+				ConfigNodeHelper<T>::feedToHash(value, context, hasher);
+			}
+		}
+
 		static void deserialize(T& value, const T& defaultValue, const EntitySerializationContext& context, const ConfigNode& node, std::string_view componentName, std::string_view fieldName, int serializationMask)
 		{
 			if ((context.matchType(serializationMask) || node.getType() != ConfigNodeType::Undefined) && node.getType() != ConfigNodeType::Noop) {
@@ -1,6 +1,11 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <halley/text/halleystring.h>
 #include "executor.h"
 #include "future.h"
@@ -20,6 +25,29 @@ namespace Halley
 
 	namespace Concurrent
 	{
+		namespace Detail {
+			// Shared between a parallelFor call and its helper tasks, which may only get to run after the call has returned
+			class ParallelForState {
+			public:
+				std::atomic<size_t> next = 0;
+
+				bool tryEnter();
+				void leave();
+				void close();
+
+				void setException(std::exception_ptr e, size_t n);
+				void rethrowException();
+
+			private:
+				std::atomic<int> active = 0;
+				std::atomic<bool> closed = false;
+				std::mutex mutex;
+				std::exception_ptr exception;
+			};
+
+			size_t getDefaultGrainSize(ExecutionQueue& e, size_t n);
+		}
+
 		template <typename F>
 		auto execute(ExecutionQueue& e, F f) -> Future<typename std::invoke_result<F>::type>
 		{
@@ -43,28 +71,90 @@ namespace Halley
 			return future.getFuture();
 		}
 
-		template <typename T, typename F>
-		void foreach(ExecutionQueue& e, T begin, T end, F f)
+		// Calls f(start, end) for chunks of up to grainSize elements of [0, n), with a grainSize of 0 picking one automatically.
+		// Chunks are claimed dynamically by the caller and by up to one helper task per thread of e. The caller only waits for
+		// helpers that have already started, so it's safe to call this from inside tasks running on e, including nested calls.
+		template <typename F>
+		void parallelFor(ExecutionQueue& e, size_t n, size_t grainSize, F f)
 		{
-			const size_t n = end - begin;
-			constexpr size_t maxThreads = 8;
-			size_t nThreads = std::max(size_t(1), std::min(maxThreads, e.threadCount()));
-			std::array<Future<void>, maxThreads> futures;
-
-			size_t prevEnd = 0;
-			for (size_t j = 0; j < nThreads; ++j) {
-				size_t curStart = prevEnd;
-				size_t curEnd = n * (j + 1) / nThreads;
-				prevEnd = curEnd;
-
-				futures[j] = execute([begin, f, curStart, curEnd]() {
-					for (auto i = begin + curStart; i < begin + curEnd; ++i) {
-						f(*i);
+			if (n == 0) {
+				return;
+			}
+			if (grainSize == 0) {
+				grainSize = Detail::getDefaultGrainSize(e, n);
+			}
+			const size_t nChunks = (n + grainSize - 1) / grainSize;
+			const size_t nHelpers = std::min(nChunks - 1, e.threadCount());
+			if (nHelpers == 0) {
+				f(size_t(0), n);
+				return;
+			}
+
+			auto state = std::make_shared<Detail::ParallelForState>();
+			auto run = [&] () {
+				try {
+					for (size_t start = state->next.fetch_add(grainSize); start < n; start = state->next.fetch_add(grainSize)) {
+						f(start, std::min(start + grainSize, n));
+					}
+				} catch (...) {
+					state->setException(std::current_exception(), n);
+				}
+			};
+
+			for (size_t i = 0; i < nHelpers; ++i) {
+				e.addToQueue([state, &run] () {
+					if (state->tryEnter()) {
+						run();
+						state->leave();
 					}
 				});
 			}
 
-			whenAll(futures.data(), futures.data() + nThreads).wait();
+			run();
+			state->close();
+			state->rethrowException();
+		}
+
+		template <typename F>
+		void parallelFor(size_t n, size_t grainSize, F f)
+		{
+			parallelFor(ExecutionQueue::getDefault(), n, grainSize, std::move(f));
+		}
+
+		// Reduces the results of f(start, end) for each chunk in order, so the result doesn't depend on scheduling
+		template <typename T, typename F, typename R>
+		T parallelReduce(ExecutionQueue& e, size_t n, size_t grainSize, T identity, F f, R reduce)
+		{
+			if (grainSize == 0) {
+				grainSize = Detail::getDefaultGrainSize(e, n);
+			}
+
+			Vector<T> partials((n + grainSize - 1) / grainSize, identity);
+			parallelFor(e, n, grainSize, [&] (size_t start, size_t end) {
+				partials[start / grainSize] = f(start, end);
+			});
+
+			T result = std::move(identity);
+			for (auto& partial: partials) {
+				result = reduce(std::move(result), std::move(partial));
+			}
+			return result;
+		}
+
+		template <typename T, typename F, typename R>
+		T parallelReduce(size_t n, size_t grainSize, T identity, F f, R reduce)
+		{
+			return parallelReduce(ExecutionQueue::getDefault(), n, grainSize, std::move(identity), std::move(f), std::move(reduce));
+		}
+
+		template <typename T, typename F>
+		void foreach(ExecutionQueue& e, T begin, T end, F f)
+		{
+			parallelFor(e, size_t(end - begin), 0, [&] (size_t start, size_t chunkEnd) {
+				for (auto i = begin + start; i != begin + chunkEnd; ++i) {
+					f(*i);
+				}
+			});
 		}
 
 		template <typename T, typename F>
@@ -5,17 +5,81 @@
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <array>
+#include <memory>
+#include <type_traits>
 #include "halley/data_structures/vector.h"
 #include "halley/text/halleystring.h"
 
 namespace Halley
 {
-	using TaskBase = std::function<void()>;
+	// Move-only callable, stored inline when small enough to avoid a heap allocation per task
+	class TaskBase
+	{
+	public:
+		TaskBase() = default;
+
+		template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, TaskBase>>>
+		TaskBase(F&& f)
+		{
+			using T = std::decay_t<F>;
+			if constexpr (sizeof(T) <= inlineSize && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>) {
+				new (&storage) T(std::forward<F>(f));
+				ops = &InlineOps<T>::ops;
+			} else {
+				*reinterpret_cast<T**>(&storage) = new T(std::forward<F>(f));
+				ops = &HeapOps<T>::ops;
+			}
+		}
+
+		TaskBase(TaskBase&& other) noexcept;
+		TaskBase& operator=(TaskBase&& other) noexcept;
+		TaskBase(const TaskBase& other) = delete;
+		TaskBase& operator=(const TaskBase& other) = delete;
+		~TaskBase();
+
+		void operator()();
+		explicit operator bool() const;
+
+	private:
+		constexpr static size_t inlineSize = 48;
+
+		struct Ops {
+			void (*invoke)(void* storage);
+			void (*move)(void* dst, void* src);
+			void (*destroy)(void* storage);
+		};
+
+		template <typename T>
+		struct InlineOps {
+			static void invoke(void* storage) { (*static_cast<T*>(storage))(); }
+			static void move(void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); static_cast<T*>(src)->~T(); }
+			static void destroy(void* storage) { static_cast<T*>(storage)->~T(); }
+			constexpr static Ops ops = { &invoke, &move, &destroy };
+		};
+
+		template <typename T>
+		struct HeapOps {
+			static void invoke(void* storage) { (**static_cast<T**>(storage))(); }
+			static void move(void* dst, void* src) { *static_cast<T**>(dst) = *static_cast<T**>(src); }
+			static void destroy(void* storage) { delete *static_cast<T**>(storage); }
+			constexpr static Ops ops = { &invoke, &move, &destroy };
+		};
+
+		alignas(std::max_align_t) std::array<std::byte, inlineSize> storage;
+		const Ops* ops = nullptr;
+
+		void reset();
+	};
 
 	class ExecutionQueue
 	{
+		friend class Executor;
+
 	public:
 		ExecutionQueue();
+		~ExecutionQueue();
+
 		void addToQueue(TaskBase task);
 
 		TaskBase getNext();
@@ -29,18 +93,40 @@ namespace Halley
 
 		void setImmediate(bool immediate);
 
+		// Gives each thread running this queue forever its own deque, which other threads steal from when idle.
+		// Tasks queued from inside a worker are then no longer run in FIFO order, so only enable this on pools.
+		void setWorkStealing(bool enabled);
+
 		static ExecutionQueue& getDefault();
 
 	private:
+		class WorkerQueue;
+		constexpr static size_t maxWorkers = 64;
+
 		std::deque<TaskBase> queue;
 		std::mutex mutex;
 		std::condition_variable condition;
 
+		std::array<std::unique_ptr<WorkerQueue>, maxWorkers> workers;
+		std::atomic<size_t> workerCount;
+		Vector<size_t> freeWorkers;
+
 		std::atomic<int> attachedCount;
+		std::atomic<int> pendingCount;
+		std::atomic<int> sleepingCount;
 		std::atomic<bool> hasTasks;
 		std::atomic<bool> aborted;
 
 		bool immediate = false;
+		bool workStealing = false;
+
+		bool tryGetNext(TaskBase& result);
+		void getTasks(Vector<TaskBase>& result, size_t n);
+		void onTaskAdded();
+		void discardPending();
+
+		void attachWorkerThread();
+		void detachWorkerThread();
 	};
 
 	class Executors
@@ -50,6 +136,7 @@ namespace Halley
 
 		static Executors& get();
 		static void setInstance(Executors& e);
+		static void resetInstance();
 
 		static ExecutionQueue& getCPU() { return instance->cpu; }
 		static ExecutionQueue& getCPUAux() { return instance->cpuAux; }
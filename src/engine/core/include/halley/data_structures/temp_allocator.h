@@ -15,6 +15,7 @@ namespace Halley {
 
 		void reset();
 		void resize(size_t size);
+		size_t getCapacity() const { return capacity; }
 
 	private:
 		size_t capacity = 0;
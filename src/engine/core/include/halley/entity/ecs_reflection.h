@@ -25,6 +25,7 @@ namespace Halley {
 		virtual int getIndex() const = 0;
 
 		virtual ConfigNode serialize(const EntitySerializationContext& context, const Component& component) const = 0;
+		virtual void feedToHash(const EntitySerializationContext& context, const Component& component, Hash::Hasher& hasher) const = 0;
 		virtual CreateComponentFunctionResult createComponent(const EntityFactoryContext& context, EntityRef& e, const ConfigNode& node) const = 0;
 
 		virtual ConfigNode serializeField(const EntitySerializationContext& context, const Component& component, std::string_view fieldName) const = 0;
@@ -2,8 +2,13 @@
 #include "ecs_reflection.h"
 #include "halley/data_structures/config_node.h"
 #include "halley/entity/entity_factory.h"
+#include "halley/utils/hash.h"
 
 namespace Halley {
+	// True if T::feedToHash(const EntitySerializationContext&, Hash::Hasher&) exists
+	template <class, class = std::void_t<>> struct HasFeedToHashMember : std::false_type {};
+	template <class T> struct HasFeedToHashMember<T, decltype(std::declval<const T&>().feedToHash(std::declval<const EntitySerializationContext&>(), std::declval<Hash::Hasher&>()))> : std::true_type { };
+
 	template <typename T>
 	class ComponentReflectorImpl final : public ComponentReflector {
 	public:
@@ -24,6 +29,15 @@ namespace Halley {
 			return result;
 		}
 
+		void feedToHash(const EntitySerializationContext& context, const Component& component, Hash::Hasher& hasher) const override
+		{
+			if constexpr (HasFeedToHashMember<T>::value) {
+				static_cast<const T&>(component).feedToHash(context, hasher);
+			} else {
+				static_cast<const T&>(component).serialize(context).feedToHash(hasher);
+			}
+		}
+
 		CreateComponentFunctionResult createComponent(const EntityFactoryContext& context, EntityRef& e, const ConfigNode& node) const override
 		{
 			return context.createComponent<T>(e, node);
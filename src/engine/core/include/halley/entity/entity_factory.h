@@ -52,6 +52,9 @@ namespace Halley {
 		EntityData serializeEntity(EntityRef entity, const SerializationOptions& options, bool canStoreParent = true);
 		EntityDataDelta serializeEntityAsDelta(EntityRef entity, const SerializationOptions& options, const EntityDataDelta::Options& deltaOptions, bool canStoreParent = true);
 		EntityDataDelta entityDataToPrefabDelta(EntityData data, std::shared_ptr<const Prefab> prefab, const EntityDataDelta::Options& deltaOptions);
+
+		// Hash of everything serializeEntity would output, without building it. Changes whenever its result would change.
+		uint64_t getSerializationHash(EntityRef entity, const SerializationOptions& options, bool canStoreParent = true);
 		
 		std::shared_ptr<EntityFactoryContext> makeStandaloneContext();
 
@@ -70,6 +73,7 @@ namespace Halley {
 		std::optional<ConfigNode> getComponentsWithPrefabDefaults(EntityRef entity, const EntityFactoryContext& context, const ConfigNode& componentData, const String& componentName);
 
 		EntityData doSerializeEntity(EntityRef entity, const SerializationOptions& options, bool canStoreParent, const String& lastPrefab);
+		void feedEntityToHash(EntityRef entity, const SerializationOptions& options, bool canStoreParent, const String& lastPrefab, const EntitySerializationContext& context, Hash::Hasher& hasher);
 
 		EntityRef tryGetEntity(const UUID& instanceUUID, EntityFactoryContext& context, bool allowWorldLookup);
 		EntityRef getEntity(const UUID& instanceUUID, EntityFactoryContext& context, bool allowWorldLookup);
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <gsl/assert>
 #include "family_type.h"
 #include "family_mask.h"
 #include "entity_id.h"
+#include "halley/data_structures/hash_map.h"
 #include "halley/data_structures/nullable_reference.h"
 #include "halley/support/exception.h"
 #include "halley/support/debug.h"
@@ -42,6 +44,11 @@ namespace Halley {
 		void notifyRemove(void* entities, size_t count);
 		void notifyReload(void* entities, size_t count);
 
+		std::optional<size_t> tryGetElementIndex(EntityId entityId) const;
+
+		// When enabled, elements are kept sorted by the address of their components, so iterating the family walks the component pools linearly
+		void setSortByComponentAddress(bool enabled);
+
 	protected:
 		virtual void addEntity(Entity& entity) = 0;
 		virtual void refreshEntity(Entity& entity) = 0;
@@ -55,6 +62,10 @@ namespace Halley {
 		size_t elemSize = 0;
 		Vector<EntityId> toRemove;
 		Vector<EntityId> toReload;
+		bool sortByComponentAddress = false;
+		bool needsFullSort = false;
+		// Only mutated from World::updateEntities, which never overlaps a parallel system update, so systems may look up concurrently
+		HashMap<EntityId, size_t> entityIndex;
 
 		Vector<FamilyBindingBase*> addEntityCallbacks;
 		Vector<FamilyBindingBase*> removeEntityCallbacks;
@@ -116,8 +127,16 @@ namespace Halley {
 	protected:
 		void addEntity(Entity& entity) override
 		{
+			const auto entityId = entity.getEntityId();
+			const auto [iter, inserted] = entityIndex.emplace(entityId, entities.size());
+			if (!inserted) {
+				// The old entry must be pending removal, and can no longer be found through the index
+				iter->second = entities.size();
+				hasDuplicateEntries = true;
+			}
+
 			auto& e = entities.emplace_back();
-			e.entityId = entity.getEntityId();
+			e.entityId = entityId;
 			T::Type::loadComponents(entity, &e.data[0]);
 
 			dirty = true;
@@ -125,11 +144,9 @@ namespace Halley {
 		
 		void refreshEntity(Entity& entity) override
 		{
-			for (auto& e: entities) {
-				if (e.entityId == entity.getEntityId()) {
-					T::Type::loadComponents(entity, &e.data[0]);
-					break;
-				}
+			// Also covers entities added since the last update, which tryGetElementIndex doesn't return yet
+			if (const auto iter = entityIndex.find(entity.getEntityId()); iter != entityIndex.end()) {
+				T::Type::loadComponents(entity, &entities[iter->second].data[0]);
 			}
 		}
 
@@ -144,18 +161,33 @@ namespace Halley {
 				Expects(curSize >= prevSize);
 				if (curSize > prevSize) {
 					notifyAdd(entities.data() + prevSize, curSize - prevSize);
+					if (sortByComponentAddress && !needsFullSort) {
+						// Everything before prevSize is already sorted, so just merge the new ones in
+						// Elements before the first insertion point don't move, so their index entries stay valid
+						std::sort(entities.begin() + prevSize, entities.end(), &compareComponentAddress);
+						const auto firstMoved = std::upper_bound(entities.begin(), entities.begin() + prevSize, entities[prevSize], &compareComponentAddress);
+						std::inplace_merge(firstMoved, entities.begin() + prevSize, entities.end(), &compareComponentAddress);
+						reindexFrom(size_t(firstMoved - entities.begin()));
+					}
 				}
 
 				dirty = false;
 			}
 
+			if (sortByComponentAddress && needsFullSort) {
+				std::sort(entities.begin(), entities.end(), &compareComponentAddress);
+				needsFullSort = false;
+				rebuildEntityIndex();
+			}
+
 			if (!toReload.empty()) {
 				// Notify reloads
 				HALLEY_DEBUG_TRACE();
 				Vector<StorageType*> reloadedEntities;
-				for (auto& entity : entities) {
-					if (std::find(toReload.begin(), toReload.end(), entity.entityId) != toReload.end()) {
-						reloadedEntities.push_back(&entity);
+				reloadedEntities.reserve(toReload.size());
+				for (const auto& entityId: toReload) {
+					if (const auto idx = tryGetElementIndex(entityId)) {
+						reloadedEntities.push_back(&entities[*idx]);
 					}
 				}
 				notifyReload(reloadedEntities.data(), reloadedEntities.size());
@@ -170,12 +202,15 @@ namespace Halley {
 		{
 			notifyRemove(entities.data(), entities.size());
 			entities.clear();
+			entityIndex.clear();
+			hasDuplicateEntries = false;
 			updateElems();
 		}
 
 	private:
 		Vector<StorageType> entities;
 		bool dirty = false;
+		bool hasDuplicateEntries = false;
 
 		void updateElems()
 		{
@@ -184,42 +219,103 @@ namespace Halley {
 			elemSize = sizeof(StorageType);
 		}
 
+		void reindexFrom(size_t start)
+		{
+			for (size_t i = start; i < entities.size(); ++i) {
+				entityIndex[entities[i].entityId] = i;
+			}
+		}
+
+		void rebuildEntityIndex()
+		{
+			entityIndex.clear();
+			entityIndex.reserve(entities.size());
+			for (size_t i = 0; i < entities.size(); ++i) {
+				entityIndex[entities[i].entityId] = i;
+			}
+		}
+
+		static const void* getComponentAddress(const StorageType& e)
+		{
+			// Optional components might be null, so use the first one present
+			const auto* components = reinterpret_cast<void* const*>(e.data.data());
+			for (size_t i = 0; i < T::Type::getNumComponents(); ++i) {
+				if (components[i]) {
+					return components[i];
+				}
+			}
+			return nullptr;
+		}
+
+		static bool compareComponentAddress(const StorageType& a, const StorageType& b)
+		{
+			return std::less<const void*>()(getComponentAddress(a), getComponentAddress(b));
+		}
+
 		void removeDeadEntities()
 		{
 			// Performance-critical code
-			// Benchmarks suggest that using a Vector is faster than std::set and std::unordered_set
 			if (!toRemove.empty()) {
 				HALLEY_DEBUG_TRACE();
 				size_t removeCount = toRemove.size();
 				Expects(removeCount > 0);
 				Expects(removeCount <= entities.size());
-				std::sort(toRemove.begin(), toRemove.end());
-
-				for (size_t i = 1; i < toRemove.size(); ++i) {
-					Expects(toRemove[i - 1] != toRemove[i]);
-				}
+				size_t firstSortedMoved = 0;
 
 				// Move all entities to be removed to the back of the vector
-				{
-					int n = int(entities.size());
-					// Note: it's important to scan it forward. Scanning backwards would improve performance for short-lived entities,
-					// but it causes an issue where an entity is removed and added to the same family in one frame.
-					for (int i = 0; i < n; i++) {
-						EntityId id = entities[i].entityId;
-						auto iter = std::lower_bound(toRemove.begin(), toRemove.end(), id);
-						if (iter != toRemove.end() && id == *iter) {
-							toRemove.erase(iter);
-							if (i != n - 1) {
-								std::swap(entities[i], entities[n - 1]);
-								i--;
-							}
-							n--;
-							if (toRemove.empty()) {
-								break;
-							}
+				if (sortByComponentAddress || hasDuplicateEntries) {
+					std::sort(toRemove.begin(), toRemove.end());
+					for (size_t i = 1; i < toRemove.size(); ++i) {
+						Expects(toRemove[i - 1] != toRemove[i]);
+					}
+
+					if (hasDuplicateEntries) {
+						removeDuplicateEntries();
+						needsFullSort = sortByComponentAddress;
+					} else {
+						// Keep the relative order, so the family stays sorted
+						// Elements before the first removed one don't move, so only the index entries after it need fixing
+						Vector<size_t> removedIdx;
+						removedIdx.reserve(removeCount);
+						for (const auto& entityId: toRemove) {
+							const auto iter = entityIndex.find(entityId);
+							Expects(iter != entityIndex.end());
+							removedIdx.push_back(iter->second);
+							entityIndex.erase(iter);
+						}
+						std::sort(removedIdx.begin(), removedIdx.end());
+						firstSortedMoved = removedIdx.front();
+
+						// Close each gap by shifting the run after it, then put the removed ones at the back
+						Vector<StorageType> removed;
+						removed.reserve(removeCount);
+						auto dst = entities.begin() + firstSortedMoved;
+						for (size_t i = 0; i < removeCount; ++i) {
+							removed.push_back(std::move(entities[removedIdx[i]]));
+							const auto runEnd = i + 1 < removeCount ? entities.begin() + removedIdx[i + 1] : entities.end();
+							dst = std::move(entities.begin() + removedIdx[i] + 1, runEnd, dst);
+						}
+						std::move(removed.begin(), removed.end(), dst);
+						Ensures(size_t(dst - entities.begin()) + removeCount == entities.size());
+						toRemove.clear();
+					}
+				} else {
+					// Swap each one with the last live entry, fixing the index of the one that moved
+					size_t n = entities.size();
+					for (const auto& entityId: toRemove) {
+						const auto iter = entityIndex.find(entityId);
+						Expects(iter != entityIndex.end());
+						const size_t idx = iter->second;
+						entityIndex.erase(iter);
+
+						--n;
+						if (idx != n) {
+							std::swap(entities[idx], entities[n]);
+							entityIndex[entities[idx].entityId] = idx;
 						}
 					}
-					Ensures(size_t(n) + removeCount == entities.size());
+					Ensures(n + removeCount == entities.size());
+					toRemove.clear();
 				}
 
 				Expects(toRemove.empty());
@@ -232,8 +328,37 @@ namespace Halley {
 				// Remove them
 				entities.resize(newSize);
 				updateElems();
+
+				if (hasDuplicateEntries) {
+					rebuildEntityIndex();
+					hasDuplicateEntries = false;
+				} else if (sortByComponentAddress) {
+					reindexFrom(firstSortedMoved);
+				}
 			}
 			Ensures(toRemove.empty());
 		}
+
+		void removeDuplicateEntries()
+		{
+			// Slow path for when an entity was removed and re-added in one frame, and the index can't tell both entries apart
+			int n = int(entities.size());
+			// Note: it's important to scan it forward, so the old entry is the one that gets removed.
+			for (int i = 0; i < n; i++) {
+				EntityId id = entities[i].entityId;
+				auto iter = std::lower_bound(toRemove.begin(), toRemove.end(), id);
+				if (iter != toRemove.end() && id == *iter) {
+					toRemove.erase(iter);
+					if (i != n - 1) {
+						std::swap(entities[i], entities[n - 1]);
+						i--;
+					}
+					n--;
+					if (toRemove.empty()) {
+						break;
+					}
+				}
+			}
+		}
 	};
 }
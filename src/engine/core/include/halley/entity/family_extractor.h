@@ -6,12 +6,12 @@ namespace Halley {
 	{
 		template <typename T>
 		struct StripMaybeRef {
-			using type = T;
+			using type = std::remove_const_t<T>;
 		};
 
 		template <typename T>
 		struct StripMaybeRef<MaybeRef<T>> {
-			using type = T;
+			using type = std::remove_const_t<T>;
 		};
 
 
@@ -70,6 +70,12 @@ namespace Halley {
 			static constexpr int componentIndex = T::componentIndex;
 		};
 
+		template <typename T>
+		struct IsConstComponent : std::is_const<T> {};
+
+		template <typename T>
+		struct IsConstComponent<MaybeRef<T>> : std::is_const<T> {};
+
 
 
 
@@ -112,10 +118,10 @@ namespace Halley {
 		template <typename T, typename... Ts>
 		struct MutableEvaluator <T, Ts...> {
 			constexpr static void makeMask(RealType& mask) {
-				if constexpr (!std::is_const<T>::value) {
+				if constexpr (!IsConstComponent<T>::value) {
 					FamilyMask::setBit(mask, RetrieveComponentIndex<T>::componentIndex);
 				}
-				Evaluator<Ts...>::makeMask(mask);
+				MutableEvaluator<Ts...>::makeMask(mask);
 			}
 
 			constexpr static HandleType getMask(MaskStorage& storage) {
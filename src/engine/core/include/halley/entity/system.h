@@ -60,6 +60,9 @@ namespace Halley {
 		void processSystemMessages();
 		size_t getSystemMessagesInInbox() const;
 
+		bool isConcurrent() const { return concurrent; }
+		bool canRunConcurrentlyWith(const System& other) const;
+
 		void sendEntityMessage(EntityId target, int msgId, gsl::span<const std::byte> data, uint8_t fromPeerId);
 		void sendSystemMessage(const String& targetSystem, int msgId, gsl::span<const std::byte> data, SystemMessageCallback callback, uint8_t fromPeerId);
 		void sendEntityMessageConfig(EntityId target, const String& messageType, const ConfigNode& data);
@@ -71,6 +74,10 @@ namespace Halley {
 		Resources& doGetResources() const { return *resources; }
 		SystemMessageBridge doGetMessageBridge() { return SystemMessageBridge(*this); }
 
+		// Declares that this system only touches the world through its families, the messages it sends and receives, and the listed services
+		// This allows World to update it in parallel with other systems that don't conflict with it
+		void declareConcurrentAccess(Vector<int> messageTypesSent, Vector<String> servicesUsed);
+
 		virtual void initBase() {}
 		virtual void deInit() {}
 		virtual void updateBase(Time) {}
@@ -196,6 +203,12 @@ namespace Halley {
 		Vector<const SystemMessageContext*> systemMessageInbox;
 		Vector<const SystemMessageContext*> systemMessages;
 
+		bool concurrent = false;
+		Vector<int> messageTypesSent;
+		Vector<String> servicesUsed;
+		FamilyMask::RealType componentsRead;
+		FamilyMask::RealType componentsWritten;
+
 		World* world = nullptr;
 		const HalleyAPI* api = nullptr;
 		Resources* resources = nullptr;
@@ -204,6 +217,8 @@ namespace Halley {
 		bool initialised = false;
 
 		void doUpdate(Time time);
+		void purgeSentMessages();
+		void runUpdate(Time time);
 		void doRender(RenderContext& rc);
 		void onAddedToWorld(World& world, int id);
 
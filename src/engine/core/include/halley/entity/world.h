@@ -217,6 +217,14 @@ namespace Halley {
 		bool isHeadless() const;
 		void setHeadless(bool headless);
 
+		// When enabled, systems that declared concurrent access are updated in parallel with non-conflicting ones
+		// Entity spawning and message dispatch are deferred until every system in that batch finishes
+		void setParallelUpdate(bool enabled);
+		bool isParallelUpdate() const;
+
+		// When enabled, families are kept sorted by component address, trading some sorting on add/remove for linear iteration
+		void setSortFamiliesByComponentAddress(bool enabled);
+
 		TempMemoryPool& getUpdateMemoryPool() const;
 		TempMemoryPool& getRenderMemoryPool() const;
 
@@ -225,6 +233,8 @@ namespace Halley {
 		Vector<std::pair<MessageEntry, EntityId>>* getEntityMessageInbox(int messageType);
 
 	private:
+		friend class TestWorld;
+
 		const HalleyAPI& api;
 		Resources& resources;
 		std::array<Vector<std::unique_ptr<System>>, static_cast<int>(TimeLine::NUMBER_OF_TIMELINES)> systems;
@@ -236,6 +246,9 @@ namespace Halley {
 		bool terminating = false;
 		bool headless = false;
 		bool canDeleteEntities = true;
+		bool parallelUpdate = false;
+		bool concurrentBatchRunning = false;
+		bool sortFamiliesByComponentAddress = false;
 		
 		Vector<Entity*> entities;
 		Vector<Entity*> entitiesPendingCreation;
@@ -261,8 +274,16 @@ namespace Halley {
 
 		std::unique_ptr<TempMemoryPool> updateMemoryPool;
 		std::unique_ptr<TempMemoryPool> renderMemoryPool;
+		Vector<std::unique_ptr<TempMemoryPool>> concurrentUpdateMemoryPools;
 
-		HashMap<int, Vector<std::pair<MessageEntry, EntityId>>> entityMessageInbox;
+		std::array<Vector<Vector<System*>>, static_cast<int>(TimeLine::NUMBER_OF_TIMELINES)> systemBatches;
+
+		struct EntityMessageInbox {
+			// Kept grouped by target (in send order within each target) up to sortedCount
+			Vector<std::pair<MessageEntry, EntityId>> messages;
+			size_t sortedCount = 0;
+		};
+		HashMap<int, EntityMessageInbox> entityMessageInbox;
 
 		struct StagingWorldTag{};
 		World(World& world, StagingWorldTag tag);
@@ -276,6 +297,10 @@ namespace Halley {
 		void deleteEntity(Entity* entity);
 
 		void updateSystems(TimeLine timeline, Time elapsed);
+		void updateSystemsParallel(TimeLine timeline, Time elapsed);
+		// Systems of the timeline grouped in update order, where the systems in each batch can update in parallel
+		const Vector<Vector<System*>>& getSystemBatches(TimeLine timeline);
+		void invalidateSystemBatches();
 		void renderSystems(RenderContext& rc) const;
 
 		NOINLINE Family& addFamily(std::unique_ptr<Family> family) noexcept;
@@ -286,5 +311,8 @@ namespace Halley {
 		const Vector<Family*>& getFamiliesFor(const FamilyMaskType& mask);
 
 		void processSystemMessages(TimeLine timeline);
+
+		void sortEntityMessageInbox(EntityMessageInbox& inbox);
+		void sortEntityMessageInboxes();
 	};
 }
@@ -89,6 +89,7 @@ namespace Halley {
 	class UIWidget;
 	class UIRoot;
 
+	// Built by UIRoot and handed to every frame until the widget hierarchy changes
 	class UIRootFrameData {
 	public:
 		Vector<std::pair<std::shared_ptr<UIWidget>, size_t>> renderWidgets;
@@ -145,7 +146,7 @@ namespace Halley {
 		Vector<DebugWorldText> debugWorldTexts;
 		TreeMap<String, DebugText> debugTexts;
 		Vector<std::pair<Vector2f, std::shared_ptr<ScriptState>>> scriptStates;
-		HashMap<const UIRoot*, UIRootFrameData> uiRootData;
+		HashMap<const UIRoot*, std::shared_ptr<const UIRootFrameData>> uiRootData;
 
 		Vector<std::unique_ptr<IPainter>> painters;
 		Vector<std::pair<String, Camera>> cameras;
@@ -29,6 +29,7 @@ namespace Halley
 	class MaterialDefinition;
 	class Camera;
 	class RenderContext;
+	class RenderTarget;
 	class Core;
 
 	class Painter
@@ -86,6 +87,9 @@ namespace Halley
 		// vertPosOffset is the offset, in bytes, from the start of each vertex's data, to a Vector2f which will be filled with the vertex's position in 0-1 space.
 		void drawSprites(const std::shared_ptr<const Material>& material, size_t numSprites, const void* vertexData);
 
+		// Same, but with a pointer to each sprite's vertex. If parallel, large batches are split across CPU workers, each one writing straight into its own range of the buffers.
+		void drawSprites(const std::shared_ptr<const Material>& material, gsl::span<const void* const> spriteVertexData, bool parallel);
+
 		// Draw one sliced sprite. Slices -> x = left, y = top, z = right, w = bottom, in [0..1] space relative to the texture
 		void drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData);
 
@@ -130,6 +134,9 @@ namespace Halley
 		void startRecording(RenderSnapshot* snapshot);
 		void stopRecording();
 
+		// Renders a whole frame outside of Core's main loop (e.g. offscreen tools and tests), recording it into snapshot if set
+		void renderFrame(const Camera& camera, RenderTarget& renderTarget, const std::function<void(RenderContext&)>& f, RenderSnapshot* snapshot = nullptr);
+
 	protected:
 		virtual void doStartRender() = 0;
 		virtual void doEndRender() = 0;
@@ -11,6 +11,7 @@ namespace Halley
 	{
 		friend class Core;
 		friend class RenderSnapshot;
+		friend class Painter;
 
 	public:
 		void bind(const std::function<void(Painter&)>& f)
@@ -58,6 +58,7 @@ namespace Halley {
             bool hasMaterialParamsChange = false;
             bool hasTextureChange = false;
             size_t numTriangles = 0;
+            size_t numVertices = 0;
             uint64_t materialHash = 0;
             String materialDefinition;
             Vector<String> textures;
@@ -107,6 +107,9 @@ namespace Halley {
 		[[nodiscard]] gsl::span<const Sprite> getSprites() const;
 
 		void setSecondarySpawner(IParticleSpawner* spawner);
+
+		// Defaults to the global generator. Particles updated in parallel must each have their own.
+		void setRNG(Random& rng);
 		void spawnAt(Vector3f pos);
 
 		std::optional<Rect4f> getAABB() const;
@@ -66,6 +66,10 @@ namespace Halley
 		static void draw(gsl::span<const Sprite> sprites, Painter& painter);
 		static void drawMixedMaterials(const Sprite* sprites, size_t n, Painter& painter);
 
+		// Draws sprites that can all go in the same draw call, with vertices optionally generated in parallel. See canDrawBatched().
+		static void drawBatched(gsl::span<const Sprite* const> sprites, Painter& painter, bool parallel);
+		bool canDrawBatched() const;
+
 		Sprite& setMaterial(Resources& resources, String materialName = "");
 		Sprite& setMaterial(std::shared_ptr<const Material> material);
 		Sprite& setMaterial(std::shared_ptr<const MaterialDefinition> definition);
@@ -253,5 +257,6 @@ namespace Halley
 		ConfigNode serialize(const Sprite& sprite, const EntitySerializationContext& context);
 		Sprite deserialize(const EntitySerializationContext& context, const ConfigNode& node);
 		void deserialize(const EntitySerializationContext& context, const ConfigNode& node, Sprite& target);
+		void feedToHash(const Sprite& sprite, const EntitySerializationContext& context, Hash::Hasher& hasher);
 	};
 }
@@ -39,6 +39,7 @@ namespace Halley
 		SpritePainterEntry(SpritePainterEntryType type, size_t spriteIdx, size_t count, int mask, int layer, float tieBreaker, size_t insertOrder, std::optional<Rect4f> clip);
 
 		bool operator<(const SpritePainterEntry& o) const;
+		uint64_t getSortKey() const;
 		SpritePainterEntryType getType() const;
 		gsl::span<const Sprite> getSprites(const Vector<Sprite>& cached) const;
 		gsl::span<const TextRenderer> getTexts(const Vector<TextRenderer>& cached) const;
@@ -55,11 +56,13 @@ namespace Halley
 		uint32_t count = 0;
 		uint32_t index = std::numeric_limits<uint32_t>::max();
 		SpritePainterEntryType type;
-		int layer;
 		int mask;
-		float tieBreaker;
+		uint64_t sortKey;
 		size_t insertOrder;
 		std::optional<Rect4f> clip;
+
+		// Layer and tie breaker, packed so that comparing keys as integers gives the same order
+		static uint64_t makeSortKey(int layer, float tieBreaker);
 	};
 
 	class MaterialUpdater;
@@ -82,9 +85,39 @@ namespace Halley
 		HashMap<String, Callback> handles;
 	};
 
+	// Uniform grid over entry bounds, so entries outside of the view can be skipped without looking at each of them
+	class SpritePainterCullingGrid {
+	public:
+		// Entries with no bounds are never culled
+		void build(gsl::span<const std::optional<Rect4f>> bounds);
+
+		// Indices of every entry which could be in view, in ascending order
+		void query(Rect4f view, Vector<uint32_t>& result);
+
+	private:
+		Rect4f area;
+		Vector2i gridSize;
+		Vector2f cellScale;
+		gsl::span<const std::optional<Rect4f>> bounds;
+		Vector<uint32_t> cellStart;
+		Vector<uint32_t> cellEntries;
+		Vector<uint32_t> unculled;
+		Vector<uint32_t> large;
+		Vector<uint32_t> visitStamp;
+		uint32_t curStamp = 0;
+
+		Rect4i getCells(Rect4f rect) const;
+	};
+
 	class SpritePainter: public IPainter
 	{
 	public:
+		struct Stats {
+			size_t submitted = 0;
+			size_t culled = 0;
+			size_t drawn = 0;
+		};
+
 		SpritePainter();
 
 		void update(Time t, Resources& resources) override;
@@ -108,6 +141,20 @@ namespace Halley
 		void draw(SpriteMaskBase mask, Painter& painter) override;
 		std::optional<Rect4f> getBounds() const;
 
+		// Sorts entries into draw order, if anything was added since the last sort. Called by draw().
+		void sort();
+		gsl::span<const SpritePainterEntry> getEntries() const;
+
+		// Skips sprites that are out of view before working out the draw order, which helps if most of them are off-screen
+		void setCulling(bool enabled);
+		bool isCulling() const;
+
+		// Collects consecutive sprites that can share a draw call, and generates their vertices across CPU worker threads
+		void setParallelVertexGeneration(bool enabled);
+
+		// Sprite and text counts across all draws since the start of the frame
+		const Stats& getStats() const;
+
 		SpritePainterMaterialParamUpdater& getParamUpdater();
 
 	private:
@@ -116,6 +163,17 @@ namespace Halley
 		Vector<TextRenderer> cachedText;
 		Vector<SpritePainterEntry::Callback> callbacks;
 		Vector<Rect4f> extraBounds;
+		Vector<std::pair<uint64_t, uint32_t>> sortKeys;
+		Vector<std::pair<uint64_t, uint32_t>> sortKeysTemp;
+		Vector<SpritePainterEntry> sortedEntries;
+		Vector<std::optional<Rect4f>> entryBounds;
+		Vector<uint32_t> visibleEntries;
+		SpritePainterCullingGrid cullingGrid;
+		bool culling = false;
+		bool cullingDirty = true;
+		bool parallelVertexGeneration = false;
+		mutable Vector<const Sprite*> spriteBatch;
+		mutable Stats stats;
 		bool dirty = false;
 		bool forceCopy = false;
 		bool waitForSpriteLoad = true;
@@ -126,7 +184,10 @@ namespace Halley
 		void draw(gsl::span<const Sprite> sprite, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 		void draw(gsl::span<const TextRenderer> text, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 		void draw(const SpritePainterEntry::Callback& callback, Painter& painter, const std::optional<Rect4f>& clip) const;
+		void flushSpriteBatch(Painter& painter) const;
 
+		void updateCulling(Rect4f view);
+		template <typename F> void forEachVisibleEntry(int mask, F f) const;
 		Vector<uint32_t> getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const;
 		Vector<uint32_t> getSpriteDrawOrderReordered(int mask, Rect4f view) const;
 	};
@@ -64,6 +64,9 @@ namespace Halley
 
 		void addGlyph(const Glyph& glyph);
 
+		// Sets up the material from the font image, which loadResource does already. Only needed for fonts built in code.
+		void loadMaterial(Resources& resources);
+
 		std::shared_ptr<Material> getMaterial() const;
 
 		void serialize(Serializer& deserializer) const;
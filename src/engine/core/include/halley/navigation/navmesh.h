@@ -4,6 +4,7 @@
 #include "navigation_query.h"
 #include "halley/maths/polygon.h"
 #include "halley/maths/base_transform.h"
+#include "halley/data_structures/priority_queue.h"
 
 namespace Halley {
 	class NavmeshSet;
@@ -156,6 +157,7 @@ namespace Halley {
 			NodeAndConn cameFrom;
 			bool inOpenSet = false;
 			bool inClosedSet = false;
+			uint32_t generation = 0;
 		};
 
 		class NodeComparator {
@@ -171,6 +173,23 @@ namespace Halley {
 			const Vector<State>& state;
 		};
 
+		// Scratch space for A*, reused between queries on the same thread.
+		// States are only reset when first touched by a query, by comparing their generation against the current one.
+		class SearchContext {
+		public:
+			SearchContext();
+
+			void begin(size_t nNodes);
+			State& getState(NodeId id);
+			const State& getVisitedState(NodeId id) const { return state[id]; }
+
+			PriorityQueue<NodeId, NodeComparator> openSet;
+
+		private:
+			Vector<State> state;
+			uint32_t generation = 0;
+		};
+
 		uint16_t id;
 
 		Vector<Node> nodes;
@@ -194,7 +213,8 @@ namespace Halley {
 		Circle boundingCircle;
 
 		std::optional<Vector<NodeAndConn>> pathfind(int fromId, int toId) const;
-		Vector<NodeAndConn> makeResult(const Vector<State>& state, int startId, int endId) const;
+		Vector<NodeAndConn> makeResult(const SearchContext& context, int startId, int endId) const;
+		static SearchContext& getSearchContext();
 
 		void processPolygons();
 		void addPolygonsToGrid();
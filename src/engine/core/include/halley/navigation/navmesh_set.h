@@ -3,8 +3,14 @@
 #include "navmesh.h"
 #include "navigation_query.h"
 #include "navigation_path.h"
+#include "halley/concurrency/future.h"
 
 namespace Halley {
+	struct NavigationQueryResult {
+		std::optional<NavigationPath> path;
+		String error;
+	};
+
 	class NavmeshSet : public Resource {
 	public:
 		NavmeshSet();
@@ -34,6 +40,10 @@ namespace Halley {
 		std::optional<NavigationPath> pathfind(const NavigationQuery& query, String* errorOut = nullptr, float anisotropy = 1.0f, float nudge = 0.1f) const;
 		std::optional<NavigationPath> pathfindInRegion(const NavigationQuery& query, uint16_t regionId) const;
 
+		// Resolves all queries in parallel on the CPU executor, results are in the same order as the queries.
+		// The set is only read, but it must outlive the future and not be modified until it completes.
+		Future<Vector<NavigationQueryResult>> pathfindBatch(Vector<NavigationQuery> queries, float anisotropy = 1.0f, float nudge = 0.1f) const;
+
 		gsl::span<const Navmesh> getNavmeshes() const { return navmeshes; }
 		const Navmesh* getNavMeshAt(WorldPosition pos) const;
 		OptionalLite<uint16_t> getNavMeshIdxAt(WorldPosition pos) const;
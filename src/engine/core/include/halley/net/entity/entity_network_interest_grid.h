@@ -0,0 +1,38 @@
+#pragma once
+
+#include <optional>
+#include "halley/data_structures/vector.h"
+#include "halley/maths/rect.h"
+
+namespace Halley {
+	// Uniform grid over the positions of the entities replicated this update, so each peer only looks at entities near its view.
+	// Entities are referred to by their index in the update list; those without a position are returned by every query.
+	class EntityNetworkInterestGrid {
+	public:
+		explicit EntityNetworkInterestGrid(int cellSize = 512);
+
+		void clear();
+		void add(size_t index, std::optional<Vector2i> position);
+		void build();
+
+		// Appends, in ascending order, the indices of every entity inside rect, plus every entity without a position
+		void query(Rect4i rect, Vector<size_t>& result) const;
+		std::optional<Vector2i> getPosition(size_t index) const;
+
+	private:
+		struct Entry {
+			uint64_t cell;
+			uint32_t index;
+
+			bool operator<(const Entry& other) const;
+		};
+
+		int cellSize;
+		Vector<std::optional<Vector2i>> positions;
+		Vector<Entry> entries;
+		Vector<uint32_t> unpositioned;
+
+		Vector2i getCell(Vector2i pos) const;
+		static uint64_t getCellKey(Vector2i cell);
+	};
+}
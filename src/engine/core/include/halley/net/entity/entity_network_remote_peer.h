@@ -18,6 +18,8 @@ namespace Halley {
 		uint8_t ownerId;
 	};
 
+	using EntityNetworkSnapshot = HashMap<EntityId, std::shared_ptr<const EntityData>>;
+
     class EntityNetworkRemotePeer {
         constexpr static Time maxSendInterval = 1.0;
     	
@@ -36,7 +38,9 @@ namespace Halley {
         void sendLobbyInfo(ConfigNode data);
         void setLobbyInfo(ConfigNode info);
 
-    	void sendEntities(Time t, gsl::span<const EntityNetworkUpdateInfo> entityIds, const EntityClientSharedData& clientData);
+    	bool prepareEntities(Time t, gsl::span<const EntityNetworkUpdateInfo> entityIds, const EntityClientSharedData& clientData);
+        void getEntitiesToSerialize(Vector<EntityId>& result) const;
+    	void sendEntities(const EntityNetworkSnapshot& snapshot);
         void receiveNetworkMessage(NetworkSession::PeerId fromPeerId, EntityNetworkMessage msg);
 
     private:
@@ -45,7 +49,7 @@ namespace Halley {
             bool alive = true;
             Time timeSinceSend = 0;
             EntityNetworkId networkId = 0;
-            EntityData data;
+            std::shared_ptr<const EntityData> data;
         };
 
         class InboundEntity {
@@ -68,9 +72,14 @@ namespace Halley {
 
         Time timeSinceSend = 0;
 
+        Vector<EntityRef> toCreate;
+        Vector<std::pair<EntityRef, OutboundEntity*>> toUpdate;
+        Vector<size_t> interestCandidates;
+
         uint16_t assignId();
-        void sendCreateEntity(EntityRef entity);
-        void sendUpdateEntity(Time t, OutboundEntity& remote, EntityRef entity);
+        void prepareEntity(Time t, EntityRef entity);
+        void sendCreateEntity(EntityRef entity, std::shared_ptr<const EntityData> data);
+        void sendUpdateEntity(OutboundEntity& remote, EntityRef entity, std::shared_ptr<const EntityData> data);
         void sendDestroyEntity(OutboundEntity& remote);
         void sendKeepAlive();
         void send(EntityNetworkMessage message);
@@ -5,6 +5,7 @@
 
 #include "halley/time/halleytime.h"
 #include "../session/network_session.h"
+#include "entity_network_interest_grid.h"
 #include "entity_network_remote_peer.h"
 #include "halley/bytes/serialization_dictionary.h"
 #include "halley/entity/system.h"
@@ -32,6 +33,23 @@ namespace Halley {
 		void deserialize(Deserializer& s) override;
 	};
 
+	struct EntityNetworkViewInterest {
+		int enterMargin = 256; // Positioned entities start being sent once they're this close to the peer's view rect...
+		int leaveMargin = 384; // ...and stop once they're further than this, so entities near the edge don't keep being created and destroyed
+	};
+
+	struct EntityNetworkSerializationStats {
+		size_t requested = 0; // Entity serializations peers needed in the last update
+		size_t serialized = 0; // Serializations actually done, each shared by every peer that needed it
+		size_t unchanged = 0; // Entities whose replicated fields hashed the same as last time, so the previous serialization was reused
+		Time serializationTime = 0; // CPU time spent serializing
+		Time savedTime = 0; // Estimated CPU time saved by sharing and reuse
+
+		// unique is the number of distinct entities among the requested ones, unchanged of those were reused
+		void update(size_t requested, size_t unique, size_t unchanged, Time serializationTime);
+		size_t getSaved() const { return requested - serialized; }
+	};
+
 	class EntityNetworkSession : NetworkSession::IListener, NetworkSession::ISharedDataHandler, public IWorldNetworkInterface {
     public:
 		class IEntityNetworkSessionListener {
@@ -42,6 +60,8 @@ namespace Halley {
 			virtual void onRemoteEntityCreated(EntityRef entity, NetworkSession::PeerId peerId) {}
 			virtual void setupInterpolators(DataInterpolatorSet& interpolatorSet, EntityRef entity, bool remote) = 0;
 			virtual bool isEntityInView(EntityRef entity, const EntityClientSharedData& clientData, NetworkSession::PeerId peerId) = 0;
+			// Return a value to have entities with a Transform2DComponent replicated to that peer based on their distance to its view rect, without calling isEntityInView on them
+			virtual std::optional<EntityNetworkViewInterest> getViewInterest(NetworkSession::PeerId peerId) const { return {}; }
 			virtual ConfigNode getLobbyInfo() = 0;
 			virtual bool setLobbyInfo(NetworkSession::PeerId fromPeerId, const ConfigNode& lobbyInfo) = 0;
 			virtual void onReceiveLobbyInfo(const ConfigNode& lobbyInfo) = 0;
@@ -68,6 +88,7 @@ namespace Halley {
 		SerializationDictionary& getSerializationDictionary();
 
 		Time getMinSendInterval() const;
+		const EntityNetworkSerializationStats& getSerializationStats() const;
 
 		void onRemoteEntityCreated(EntityRef entity, NetworkSession::PeerId peerId);
 		void requestSetupInterpolators(DataInterpolatorSet& interpolatorSet, EntityRef entity, bool remote);
@@ -80,6 +101,8 @@ namespace Halley {
 		bool isLobbyReady() const;
 
 		bool isEntityInView(EntityRef entity, const EntityClientSharedData& clientData, NetworkSession::PeerId peerId) const;
+		std::optional<EntityNetworkViewInterest> getViewInterest(NetworkSession::PeerId peerId) const;
+		const EntityNetworkInterestGrid& getInterestGrid() const;
 		Vector<Rect4i> getRemoteViewPorts() const;
 
 		bool isHost() const override;
@@ -129,6 +152,18 @@ namespace Halley {
 
 		HashMap<int, Vector<EntityNetworkMessage>> outbox;
 
+		struct CachedEntity {
+			uint64_t hash = 0;
+			std::shared_ptr<const EntityData> data;
+			uint32_t lastUsedTick = 0;
+		};
+
+		EntityNetworkInterestGrid interestGrid;
+		EntityNetworkSnapshot snapshot;
+		HashMap<EntityId, CachedEntity> serializationCache;
+		EntityNetworkSerializationStats serializationStats;
+		uint32_t serializationTick = 0;
+
 		bool readyToStartGame = false;
 		bool gameStarted = false;
 		bool lobbyReady = false;
@@ -148,6 +183,9 @@ namespace Halley {
 		void onReceiveSetLobbyInfo(NetworkSession::PeerId fromPeerId, const EntityNetworkMessageSetLobbyInfo& msg);
 
 		void sendMessages();
+		void buildInterestGrid(gsl::span<const EntityNetworkUpdateInfo> entityIds);
+		void serializeSnapshot(Vector<EntityId> entityIds);
+		void pruneSerializationCache();
 		
 		void setupDictionary();
 
@@ -5,6 +5,7 @@
 #include <gsl/span>
 #include "halley/resources/resource_data.h"
 #include "halley/utils/encrypt.h"
+#include "halley/resources/asset_pack_index.h"
 
 namespace Halley {
 	enum class AssetType;
@@ -20,7 +21,11 @@ namespace Halley {
 		uint64_t assetDbStartPos;
 		uint64_t dataStartPos;
 
-		void init(size_t assetDbSize);
+		// Version 1 packs have no index, and are encrypted with CBC as a whole.
+		// Version 2 packs store an AssetPackIndex between the header and the asset database, and are encrypted with CTR.
+		void init(int version, size_t indexSize, size_t assetDbSize);
+		int getVersion() const;
+		size_t getIndexSize() const;
 	};
 
     class AssetPack {
@@ -44,12 +49,15 @@ namespace Halley {
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream);
 
 		void readToMemory();
+
+		// Encrypts with AES-CTR, so that assets can later be decrypted individually as they're read
 		void encrypt(Encrypt::AESKey key);
 		void decrypt(Encrypt::AESKey key);
 	    
+		// Safe to call from several threads at once. Don't call readToMemory or extractReader while reads might still be happening.
     	void readData(size_t pos, gsl::span<gsl::byte> dst);
 
-		std::unique_ptr<ResourceDataReader> extractReader();
+		std::shared_ptr<ResourceDataReader> extractReader();
 
 		std::shared_ptr<bool> getAliveToken() const;
 
@@ -57,13 +65,21 @@ namespace Halley {
 
     private:
 		std::unique_ptr<AssetDatabase> assetDb;
-		std::unique_ptr<ResourceDataReader> reader;
+		AssetPackIndex index;
+		std::shared_ptr<ResourceDataReader> reader; // Shared with zero-copy views into its mapping, so they outlive the pack
 		std::atomic<bool> hasReader;
+		bool lockFreeReader = false; // Reader supports readAt, so reads don't need readerMutex
+		gsl::span<const gsl::byte> mappedData; // Data section, if the reader has the file memory mapped
 		std::mutex readerMutex;
 		size_t dataOffset = 0;
 		Bytes data;
 		std::array<uint8_t, 16> iv;
+		bool streamEncrypted = false; // Data is AES-CTR encrypted, rather than CBC encrypted as a whole (as in older packs)
+		std::optional<std::array<uint8_t, 16>> readKey; // Set if data is still encrypted, and must be decrypted as it's read
 		mutable std::shared_ptr<bool> aliveToken;
+
+		void readRawData(size_t pos, gsl::span<gsl::byte> dst);
+		void readIndex(const AssetPackHeader& header);
     };
 
 
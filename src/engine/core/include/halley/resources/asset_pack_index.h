@@ -0,0 +1,64 @@
+#pragma once
+#include "halley/utils/utils.h"
+#include "halley/text/halleystring.h"
+#include <gsl/span>
+
+namespace Halley {
+	enum class AssetType;
+	class AssetDatabase;
+
+	// Flat, sorted table of where each asset lives in a pack's data section.
+	// It's stored in the pack as-is, so it can be used straight from a memory mapped file, and lookups don't allocate.
+	class AssetPackIndex {
+	public:
+		struct Entry {
+			uint64_t nameHash;
+			uint64_t pos;
+			uint64_t size;
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			int32_t type;
+			std::array<uint8_t, 4> padding; // Always zero
+		};
+		static_assert(sizeof(Entry) == 40);
+
+		AssetPackIndex() = default;
+		AssetPackIndex(const AssetPackIndex& other) = delete;
+		AssetPackIndex(AssetPackIndex&& other) noexcept = default;
+
+		AssetPackIndex& operator=(const AssetPackIndex& other) = delete;
+		AssetPackIndex& operator=(AssetPackIndex&& other) noexcept = default;
+
+		// Builds from a database whose paths are "pos:size", as written by the packer
+		static AssetPackIndex fromDatabase(const AssetDatabase& db);
+
+		// Uses data in place, so it must outlive this index. Throws if data isn't a valid index.
+		static AssetPackIndex fromView(gsl::span<const gsl::byte> data);
+		static AssetPackIndex fromBytes(Bytes data);
+
+		// Copies the data, if this is a view, so it no longer depends on it
+		void makeOwned();
+
+		const Entry* tryGet(std::string_view name, AssetType type) const;
+		std::string_view getName(const Entry& entry) const;
+
+		size_t size() const;
+		bool empty() const;
+		gsl::span<const gsl::byte> getBytes() const;
+		size_t getMemoryUsage() const;
+
+		static uint64_t hashName(std::string_view name);
+
+	private:
+		struct Header {
+			uint32_t numEntries;
+			uint32_t namesSize;
+		};
+
+		Bytes ownedData;
+		gsl::span<const Entry> entries;
+		std::string_view names;
+
+		void setView(gsl::span<const gsl::byte> data);
+	};
+}
@@ -28,6 +28,7 @@ This file is subject to the terms of halley_license.txt.
 #include <halley/concurrency/future.h>
 #include <gsl/gsl>
 #include "metadata.h"
+#include "halley/bytes/compression.h"
 
 namespace Halley {
 	enum class AssetType;
@@ -42,6 +43,13 @@ namespace Halley {
 		virtual void close() = 0;
 		virtual bool isAvailable() const { return true; }
 
+		// Readers that return true here can be read at any position from several threads at once, through readAt
+		virtual bool supportsReadAt() const { return false; }
+		virtual int readAt(size_t pos, gsl::span<gsl::byte> dst);
+
+		// The whole file, if the reader has it memory mapped
+		virtual gsl::span<const gsl::byte> getMappedData() const { return {}; }
+
 		Bytes readAll();
 	};
 
@@ -60,6 +68,63 @@ namespace Halley {
 		size_t fileSize = 0;
 	};
 
+	// Maps the whole file into memory, or uses positioned reads if it can't be mapped
+	class ResourceDataReaderMappedFile : public ResourceDataReader {
+	public:
+		// Returns null if the file can't be opened this way, e.g. if it's not on the native file system
+		static std::unique_ptr<ResourceDataReaderMappedFile> tryOpen(const Path& path);
+		~ResourceDataReaderMappedFile() override;
+
+		size_t size() const override;
+		int read(gsl::span<gsl::byte> dst) override;
+		void seek(int64_t pos, int whence) override;
+		size_t tell() const override;
+		void close() override;
+		bool isAvailable() const override;
+
+		bool supportsReadAt() const override;
+		int readAt(size_t pos, gsl::span<gsl::byte> dst) override;
+		gsl::span<const gsl::byte> getMappedData() const override;
+
+	private:
+		ResourceDataReaderMappedFile() = default;
+
+		bool open(const Path& path);
+
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+		int fd = -1;
+		const gsl::byte* mapped = nullptr;
+		size_t fileSize = 0;
+		size_t curPos = 0;
+	};
+
+	// Reads a chunked LZ4 file (see Compression::lz4CompressChunked), decompressing one chunk at a time as it's needed
+	class ResourceDataReaderLZ4Chunked : public ResourceDataReader {
+	public:
+		explicit ResourceDataReaderLZ4Chunked(std::unique_ptr<ResourceDataReader> src);
+
+		size_t size() const override;
+		int read(gsl::span<gsl::byte> dst) override;
+		void seek(int64_t pos, int whence) override;
+		size_t tell() const override;
+		void close() override;
+		bool isAvailable() const override;
+
+	private:
+		std::unique_ptr<ResourceDataReader> src;
+		Compression::LZ4ChunkedHeader header;
+		Vector<uint64_t> chunkEnds;
+		size_t dataStart = 0;
+		size_t curPos = 0;
+
+		Bytes compressed;
+		Bytes chunk;
+		std::optional<size_t> chunkIdx;
+
+		void loadChunk(size_t idx);
+	};
+
 	class ResourceData {
 	public:
 		ResourceData(String path);
@@ -75,6 +140,7 @@ namespace Halley {
 	public:
 		ResourceDataStatic(String path);
 		ResourceDataStatic(const void* data, size_t size, String path, bool owning = true);
+		ResourceDataStatic(std::shared_ptr<const char> data, size_t size, String path); // e.g. an aliasing pointer that keeps a mapping alive
 
 		void set(const void* data, size_t size, bool owning = true);
 		bool isLoaded() const;
@@ -84,7 +150,7 @@ namespace Halley {
 		size_t getSize() const;
 		String getString() const;
 		void inflate();
-		void lz4Decompress();
+		void lz4Decompress(ExecutionQueue* queue = nullptr);
 
 		static std::unique_ptr<ResourceDataStatic> loadFromFileSystem(Path path);
 		void writeToFileSystem(String path) const;
@@ -19,6 +19,7 @@ namespace Halley {
 	class InputDevice;
 	class IAudioHandle;
 	class UIToolTip;
+	class UIRootFrameData;
 
 	enum class UIInputType {
 		Undefined,
@@ -66,6 +67,8 @@ namespace Halley {
 		void setFocus(const std::shared_ptr<UIWidget>& newFocus, bool byClicking = false);
 		void focusNext(bool reverse);
 		void onWidgetRemoved(const UIWidget& widget);
+		void onHierarchyChanged();
+		void onRenderListChanged();
 
 		UIWidget* getCurrentFocus() const;
 		UIWidget* getCurrentMouseOver() const;
@@ -122,7 +125,17 @@ namespace Halley {
 		std::shared_ptr<UIToolTip> toolTip;
 		UIInputType lastInputType = UIInputType::Keyboard;
 
-		Vector<std::shared_ptr<UIWidget>> widgetsCache;
+		// Kept between updates and only collected again when the hierarchy changes
+		Vector<UIWidget*> widgetsCache;
+		Vector<size_t> widgetsCacheChildrenStart;
+		bool widgetsCacheDirty = true;
+
+		// Widgets removed while updating stay alive until the update is done, since widgetsCache doesn't own them
+		Vector<std::shared_ptr<const UIWidget>> removedWidgets;
+		bool updatingWidgets = false;
+
+		std::shared_ptr<UIRootFrameData> renderData;
+		bool renderDataDirty = true;
 
 		void updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType);
 
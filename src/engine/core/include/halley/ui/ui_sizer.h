@@ -182,5 +182,6 @@ namespace Halley {
 		float getRowProportion(int row) const;
 
 		void sortChildrenBySizerOrder();
+		void markParentAsNeedingLayout();
 	};
 }
@@ -184,6 +184,7 @@ namespace Halley {
 
 		bool needsLayout() const;
 		void markAsNeedingLayout() final override;
+		void markLayoutDirty() final override;
 
 		virtual bool canReceiveFocus() const;
 		virtual bool canReceiveMouseExclusive() const;
@@ -209,7 +210,7 @@ namespace Halley {
 		virtual std::optional<Vector2f> transformToChildSpace(Vector2f pos) const;
 		virtual std::optional<MouseCursorMode> getMouseCursorMode() const;
 
-		virtual void collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst);
+		virtual void collectWidgetsForUpdating(Vector<UIWidget*>& dst);
 		virtual void collectWidgetsForRendering(size_t curRootIdx, Vector<std::pair<std::shared_ptr<UIWidget>, size_t>>& dst, Vector<std::shared_ptr<UIWidget>>& dstRoots);
 
 	protected:
@@ -259,7 +260,7 @@ namespace Halley {
 
 	private:
 		void doDraw(UIPainter& painter) const;
-		void doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<std::shared_ptr<UIWidget>>& dst);
+		bool doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType);
 		void doPostUpdate();
 
 		void setParent(UIParent* parent);
@@ -295,6 +296,8 @@ namespace Halley {
 		std::optional<UISizer> sizer;
 
 		mutable Vector2f layoutSize;
+		Rect4f lastLayoutRect;
+		Rect4f lastLayoutArea;
 
 		std::shared_ptr<UIEventHandler> eventHandler;
 		std::shared_ptr<UIValidator> validator;
@@ -317,6 +320,7 @@ namespace Halley {
 		bool mouseBlocker = true;
 		bool mouseInteraction = false;
 		bool shrinkOnLayout = true;
+		bool layoutDirty = true;
 		bool destroying = false;
 		bool canSendEvents = true;
 		bool dontClipChildren = false;
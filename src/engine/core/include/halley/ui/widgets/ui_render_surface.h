@@ -40,6 +40,9 @@ namespace Halley {
 
         bool ignoreClip() const override;
 
+    protected:
+        void onEnabledChanged() override;
+
     private:
         std::unique_ptr<RenderSurface> renderSurface;
 
@@ -73,5 +76,6 @@ namespace Halley {
         mutable Vector2f origScale;
 
         void drawOnPainter(Painter& painter) const;
+        void onRenderingChanged();
     };
 }
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../ui_widget.h"
+#include "ui_clickable.h"
+
+namespace Halley {
+	class UIVirtualList;
+
+	// Row of a UIVirtualList, holding the widgets made by the list's row factory.
+	// Rows are reused for other items as the list scrolls.
+	class UIVirtualListRow : public UIClickable {
+	public:
+		UIVirtualListRow(UIVirtualList& parent, UIStyle style, std::shared_ptr<UIWidget> contents);
+
+		void pressMouse(Vector2f mousePos, int button, KeyMods keyMods) override;
+		void onDoubleClicked(Vector2f mousePos, KeyMods keyMods) override;
+
+		const std::shared_ptr<UIWidget>& getContents() const;
+		std::optional<size_t> getItemIndex() const;
+		bool isSelected() const;
+
+		void setClickableInnerBorder(Vector4f innerBorder);
+
+	protected:
+		void draw(UIPainter& painter) const override;
+		void update(Time t, bool moved) override;
+		void doSetState(State state) override;
+
+	private:
+		friend class UIVirtualList;
+
+		UIVirtualList& parent;
+		UIStyle style;
+		Sprite sprite;
+		std::shared_ptr<UIWidget> contents;
+		std::optional<size_t> itemIndex;
+		Vector4f innerBorder;
+		bool selected = false;
+
+		void setSelected(bool selected);
+		void updateSpritePosition();
+	};
+
+	// Vertical list which only has widgets for the items in view, plus a margin, instead of one widget tree per item like UIList.
+	// Items are just ids. The row factory makes an empty row, and the binder fills it in for an item; rows are then reused as the list scrolls.
+	// Item heights are estimated until they've been in view, then cached by id.
+	// Place it inside a UIScrollPane, which is what decides what is in view.
+	class UIVirtualList : public UIWidget {
+		friend class UIVirtualListRow;
+
+	public:
+		using RowFactory = std::function<std::shared_ptr<UIWidget>()>;
+		using RowBinder = std::function<void(UIWidget& contents, size_t itemIdx)>;
+
+		UIVirtualList(String id, UIStyle style, RowFactory rowFactory = {}, RowBinder rowBinder = {});
+
+		void setItems(Vector<String> ids);
+		void refreshItem(size_t idx);
+		void refreshItems();
+		void clear() override;
+
+		size_t getCount() const;
+		const String& getItemId(size_t idx) const;
+		std::optional<size_t> tryGetItemIndex(const String& id) const;
+
+		void setEstimatedItemHeight(float height);
+		void setViewMargin(float margin);
+
+		bool setSelectedOption(int option);
+		bool setSelectedOptionId(const String& id);
+		int getSelectedOption() const;
+		String getSelectedOptionId() const;
+
+		void setScrollToSelection(bool value);
+		void showItem(size_t idx, bool centre);
+		Rect4f getOptionRect(int option) const;
+
+		// Range of items which currently have a row
+		std::pair<size_t, size_t> getItemsInView() const;
+		size_t getNumRows() const;
+
+		bool canReceiveFocus() const override;
+		bool ignoreClip() const override;
+		void readFromDataBind() override;
+
+	protected:
+		Vector2f getLayoutMinimumSize(bool force) const override;
+		void update(Time t, bool moved) override;
+		void draw(UIPainter& painter) const override;
+		bool onKeyPress(KeyboardKeyPress key) override;
+
+		virtual std::shared_ptr<UIWidget> makeRowContents();
+		virtual void bindRow(UIVirtualListRow& row, size_t idx);
+		virtual void onRowClicked(UIVirtualListRow& row, int button, KeyMods keyMods);
+		virtual void onRowDoubleClicked(UIVirtualListRow& row, KeyMods keyMods);
+
+		UIVirtualListRow* tryGetRow(size_t idx) const;
+
+	private:
+		RowFactory rowFactory;
+		RowBinder rowBinder;
+		Sprite sprite;
+
+		Vector<String> ids;
+		HashMap<String, size_t> idToIndex;
+		Vector<float> heights; // Negative until measured
+		mutable Vector<float> offsets;
+		mutable bool offsetsDirty = true;
+		float estimatedHeight = 0;
+		float measuredTotal = 0;
+		size_t numMeasured = 0;
+		float maxRowWidth = 0;
+		float viewMargin = 100;
+		float gap = 0;
+
+		Vector<std::shared_ptr<UIVirtualListRow>> rows;
+		Vector<UIVirtualListRow*> rowsInView;
+		Vector<UIVirtualListRow*> freeRows;
+		size_t firstInView = 0;
+		size_t lastInView = 0;
+
+		int curOption = -1;
+		bool scrollToSelection = true;
+
+		float getItemHeight(size_t idx) const;
+		float getEstimatedItemHeight() const;
+		void updateOffsets() const;
+		size_t getItemAt(float y) const;
+		std::optional<Rect4f> getViewRect() const;
+
+		void updateRows();
+		bool layoutRows();
+		UIVirtualListRow& makeRow();
+		void unbindRows();
+		void onAccept();
+	};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ui_virtual_list.h"
+#include "halley/text/i18n.h"
+
+namespace Halley {
+	// Tree version of UIVirtualList, drawn like UITreeList.
+	// Only the items in view have widgets; collapsed branches cost nothing beyond their data.
+	class UIVirtualTreeList : public UIVirtualList {
+	public:
+		UIVirtualTreeList(String id, UIStyle style);
+
+		void addTreeItem(const String& id, const String& parentId, size_t childIndex, const LocalisedString& label, Sprite icon = Sprite(), bool expanded = true);
+		void removeItem(const String& id);
+		void setLabel(const String& id, const LocalisedString& label, Sprite icon);
+		void clear() override;
+
+		void setExpanded(const String& id, bool expanded);
+		void setAllExpanded(bool expanded);
+		bool isExpanded(const String& id) const;
+		void makeParentsOfItemExpanded(const String& id);
+
+		void refresh();
+
+	protected:
+		void update(Time t, bool moved) override;
+		std::shared_ptr<UIWidget> makeRowContents() override;
+		void bindRow(UIVirtualListRow& row, size_t idx) override;
+
+	private:
+		struct Node {
+			String id;
+			LocalisedString label;
+			Sprite icon;
+			Node* parent = nullptr;
+			Vector<std::unique_ptr<Node>> children;
+			bool expanded = true;
+		};
+
+		struct VisibleNode {
+			const Node* node;
+			Vector<int> itemsLeftPerDepth;
+		};
+
+		Node root;
+		HashMap<String, Node*> nodes;
+		Vector<VisibleNode> visibleNodes;
+		bool needsRefresh = false;
+
+		Node& getNodeOrRoot(const String& id);
+		void collectVisible(const Node& node, Vector<int>& itemsLeftPerDepth);
+		void forgetNode(const Node& node);
+		void setupEvents();
+	};
+}
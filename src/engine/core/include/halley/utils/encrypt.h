@@ -12,5 +12,9 @@ namespace Halley {
 
 		static Bytes encryptAES(AESIV iv, AESKey key, const Bytes& data);
 		static Bytes decryptAES(AESIV iv, AESKey key, const Bytes& data);
+
+		// AES in counter mode, in place. Encrypting and decrypting are the same operation.
+		// offset is the position of data within the whole stream, so any range can be processed on its own.
+		static void applyAESCTR(AESIV iv, AESKey key, size_t offset, gsl::span<gsl::byte> data);
 	};
 }
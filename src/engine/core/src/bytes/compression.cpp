@@ -5,6 +5,7 @@
 #include "../../../../contrib/zlib/zutil.h"
 #include "halley/support/exception.h"
 #include "halley/text/string_converter.h"
+#include "halley/concurrency/concurrent.h"
 #include "lz4/lz4.h"
 #include "lz4/lz4hc.h"
 
@@ -309,3 +310,133 @@ std::optional<size_t> Compression::lz4Decompress(gsl::span<const Byte> src, gsl:
 {
 	return lz4Decompress(gsl::as_bytes(src), gsl::as_writable_bytes(dst));
 }
+
+namespace {
+	constexpr std::array<char, 4> lz4ChunkedId = { 'L', 'Z', '4', 'C' };
+}
+
+size_t Compression::LZ4ChunkedHeader::getNumChunks() const
+{
+	return chunkSize == 0 ? 0 : size_t((size + chunkSize - 1) / chunkSize);
+}
+
+size_t Compression::LZ4ChunkedHeader::getChunkSize(size_t idx) const
+{
+	return size_t(std::min(uint64_t(chunkSize), size - uint64_t(idx) * chunkSize));
+}
+
+size_t Compression::LZ4ChunkedHeader::getTableSize() const
+{
+	return getNumChunks() * sizeof(uint64_t);
+}
+
+Bytes Compression::lz4CompressChunked(gsl::span<const gsl::byte> src, LZ4Options options, size_t chunkSize)
+{
+	Expects(chunkSize > 0 && chunkSize <= std::numeric_limits<uint32_t>::max());
+
+	LZ4ChunkedHeader header;
+	header.id = lz4ChunkedId;
+	header.chunkSize = uint32_t(chunkSize);
+	header.size = uint64_t(src.size());
+
+	const size_t nChunks = header.getNumChunks();
+	const size_t dataStart = sizeof(header) + header.getTableSize();
+	const size_t maxChunkSize = size_t(LZ4_compressBound(int(chunkSize)));
+
+	Bytes result;
+	result.resize_no_init(dataStart + nChunks * maxChunkSize);
+	memcpy(result.data(), &header, sizeof(header));
+
+	size_t pos = dataStart;
+	for (size_t i = 0; i < nChunks; ++i) {
+		const auto chunk = src.subspan(i * chunkSize, header.getChunkSize(i));
+		const auto dst = result.byte_span().subspan(pos, maxChunkSize);
+		size_t outSize = lz4Compress(chunk, dst, options);
+		if (outSize == 0 || outSize >= size_t(chunk.size())) {
+			memcpy(dst.data(), chunk.data(), chunk.size());
+			outSize = chunk.size();
+		}
+		pos += outSize;
+
+		const uint64_t end = pos - dataStart;
+		memcpy(result.data() + sizeof(header) + i * sizeof(uint64_t), &end, sizeof(end));
+	}
+
+	result.resize(pos);
+	return result;
+}
+
+std::optional<Compression::LZ4ChunkedHeader> Compression::readLZ4ChunkedHeader(gsl::span<const gsl::byte> src)
+{
+	if (size_t(src.size()) < sizeof(LZ4ChunkedHeader)) {
+		return std::nullopt;
+	}
+
+	LZ4ChunkedHeader header;
+	memcpy(&header, src.data(), sizeof(header));
+	if (header.id != lz4ChunkedId || (header.chunkSize == 0 && header.size != 0)) {
+		return std::nullopt;
+	}
+	return header;
+}
+
+void Compression::lz4DecompressChunk(const LZ4ChunkedHeader& header, size_t idx, gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst)
+{
+	const size_t expected = header.getChunkSize(idx);
+	if (size_t(dst.size()) < expected) {
+		throw Exception("Destination too small for LZ4 chunk", HalleyExceptions::Compression);
+	}
+
+	if (size_t(src.size()) == expected) {
+		// Stored uncompressed
+		memcpy(dst.data(), src.data(), expected);
+	} else {
+		const auto result = lz4Decompress(src, dst.subspan(0, expected));
+		if (result != expected) {
+			throw Exception("Failed to decompress LZ4 chunk " + toString(idx), HalleyExceptions::Compression);
+		}
+	}
+}
+
+std::shared_ptr<const char> Compression::lz4DecompressAnyToSharedPtr(gsl::span<const gsl::byte> src, size_t& outSize, ExecutionQueue* queue)
+{
+	const auto header = readLZ4ChunkedHeader(src);
+	if (!header) {
+		return lz4DecompressFileToSharedPtr(src, {}, outSize);
+	}
+
+	const size_t nChunks = header->getNumChunks();
+	const size_t dataStart = sizeof(LZ4ChunkedHeader) + header->getTableSize();
+	if (size_t(src.size()) < dataStart) {
+		throw Exception("Chunked LZ4 file is truncated", HalleyExceptions::Compression);
+	}
+
+	auto output = std::shared_ptr<char>(new char[header->size], deleter);
+	const auto dst = gsl::as_writable_bytes(gsl::span<char>(output.get(), header->size));
+	const auto data = src.subspan(dataStart);
+
+	auto decompressChunks = [&] (size_t start, size_t end)
+	{
+		for (size_t i = start; i < end; ++i) {
+			uint64_t chunkStart = 0;
+			uint64_t chunkEnd = 0;
+			if (i > 0) {
+				memcpy(&chunkStart, src.data() + sizeof(LZ4ChunkedHeader) + (i - 1) * sizeof(uint64_t), sizeof(uint64_t));
+			}
+			memcpy(&chunkEnd, src.data() + sizeof(LZ4ChunkedHeader) + i * sizeof(uint64_t), sizeof(uint64_t));
+			if (chunkStart > chunkEnd || chunkEnd > uint64_t(data.size())) {
+				throw Exception("Chunked LZ4 file is truncated", HalleyExceptions::Compression);
+			}
+			lz4DecompressChunk(*header, i, data.subspan(size_t(chunkStart), size_t(chunkEnd - chunkStart)), dst.subspan(i * header->chunkSize));
+		}
+	};
+
+	if (queue) {
+		Concurrent::parallelFor(*queue, nChunks, 1, decompressChunks);
+	} else {
+		decompressChunks(0, nChunks);
+	}
+
+	outSize = size_t(header->size);
+	return output;
+}
@@ -30,3 +30,49 @@ using namespace Halley;
 static thread_local String threadName;
 #endif
 
+bool Concurrent::Detail::ParallelForState::tryEnter()
+{
+	++active;
+	if (closed) {
+		--active;
+		return false;
+	}
+	return true;
+}
+
+void Concurrent::Detail::ParallelForState::leave()
+{
+	--active;
+}
+
+void Concurrent::Detail::ParallelForState::close()
+{
+	// Helpers that haven't started yet will see this and bail out, so only wait for the ones already running chunks
+	closed = true;
+	while (active.load() > 0) {
+		std::this_thread::yield();
+	}
+}
+
+void Concurrent::Detail::ParallelForState::setException(std::exception_ptr e, size_t n)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!exception) {
+		exception = std::move(e);
+	}
+	next = n;
+}
+
+void Concurrent::Detail::ParallelForState::rethrowException()
+{
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+size_t Concurrent::Detail::getDefaultGrainSize(ExecutionQueue& e, size_t n)
+{
+	// A few chunks per thread, so uneven workloads still balance out
+	const size_t nThreads = e.threadCount() + 1;
+	return std::max(size_t(1), n / (nThreads * 4));
+}
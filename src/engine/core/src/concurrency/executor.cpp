@@ -1,3 +1,4 @@
+#include <limits>
 #include <halley/concurrency/concurrent.h>
 #include <halley/concurrency/executor.h>
 #include <halley/support/exception.h>
@@ -10,51 +11,254 @@ using namespace Halley;
 
 Executors* Executors::instance = nullptr;
 
+namespace {
+	thread_local ExecutionQueue* currentWorkerQueue = nullptr;
+	thread_local size_t currentWorkerIdx = 0;
+	thread_local uint32_t stealSeed = 0;
+
+	size_t pickVictim(size_t n)
+	{
+		// xorshift, just needs to spread thieves across victims
+		uint32_t x = stealSeed;
+		if (x == 0) {
+			x = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+		}
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		stealSeed = x;
+		return x % n;
+	}
+}
+
+TaskBase::TaskBase(TaskBase&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+TaskBase& TaskBase::operator=(TaskBase&& other) noexcept
+{
+	if (this != &other) {
+		reset();
+		if (other.ops) {
+			ops = other.ops;
+			ops->move(&storage, &other.storage);
+			other.ops = nullptr;
+		}
+	}
+	return *this;
+}
+
+TaskBase::~TaskBase()
+{
+	reset();
+}
+
+void TaskBase::operator()()
+{
+	if (ops) {
+		ops->invoke(&storage);
+	}
+}
+
+TaskBase::operator bool() const
+{
+	return ops != nullptr;
+}
+
+void TaskBase::reset()
+{
+	if (ops) {
+		ops->destroy(&storage);
+		ops = nullptr;
+	}
+}
+
+// Chase-Lev deque. The owner pushes and pops at the bottom, thieves take from the top.
+// Each slot is flagged while in use, so the owner never overwrites a task that a thief is still moving out.
+class ExecutionQueue::WorkerQueue
+{
+public:
+	bool push(TaskBase& task)
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		auto& slot = slots[b & mask];
+		if (b - t >= capacity || slot.used.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		slot.task = std::move(task);
+		slot.used.store(true, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(TaskBase& result)
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_release);
+			return false;
+		}
+		if (t == b) {
+			// Last one, race the thieves for it
+			const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_release);
+			if (!won) {
+				return false;
+			}
+		}
+
+		take(slots[b & mask], result);
+		return true;
+	}
+
+	bool steal(TaskBase& result)
+	{
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return false;
+		}
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+
+		take(slots[t & mask], result);
+		return true;
+	}
+
+	bool isEmpty() const
+	{
+		return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+	}
+
+private:
+	constexpr static int64_t capacity = 1024;
+	constexpr static int64_t mask = capacity - 1;
+
+	struct Slot {
+		TaskBase task;
+		std::atomic<bool> used = false;
+	};
+
+	alignas(64) std::atomic<int64_t> top = 0;
+	alignas(64) std::atomic<int64_t> bottom = 0;
+	alignas(64) std::array<Slot, capacity> slots;
+
+	static void take(Slot& slot, TaskBase& result)
+	{
+		result = std::move(slot.task);
+		slot.used.store(false, std::memory_order_release);
+	}
+};
+
 ExecutionQueue::ExecutionQueue()
-	: aborted(false)
+	: workerCount(0)
+	, attachedCount(0)
+	, pendingCount(0)
+	, sleepingCount(0)
+	, aborted(false)
 {
 	hasTasks.store(false);
 }
 
+ExecutionQueue::~ExecutionQueue() = default;
+
+bool ExecutionQueue::tryGetNext(TaskBase& result)
+{
+	// Own deque first, as the newest tasks are likely still in cache
+	if (currentWorkerQueue == this && workers[currentWorkerIdx]->pop(result)) {
+		--pendingCount;
+		return true;
+	}
+
+	if (pendingCount.load() == 0) {
+		return false;
+	}
+
+	if (hasTasks.load()) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!queue.empty()) {
+			result = std::move(queue.front());
+			queue.pop_front();
+			hasTasks.store(!queue.empty());
+			--pendingCount;
+			return true;
+		}
+	}
+
+	const size_t n = workerCount.load(std::memory_order_acquire);
+	if (n > 0) {
+		const size_t start = pickVictim(n);
+		for (size_t i = 0; i < n; ++i) {
+			const size_t idx = (start + i) % n;
+			if (workers[idx]->steal(result)) {
+				--pendingCount;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 TaskBase ExecutionQueue::getNext()
 {
-	std::unique_lock<std::mutex> lock(mutex);
-	while (queue.empty()) {
+	TaskBase result;
+	while (!tryGetNext(result)) {
+		std::unique_lock<std::mutex> lock(mutex);
 		if (!aborted) {
-			condition.wait(lock);
+			++sleepingCount;
+			while (pendingCount.load() == 0 && !aborted) {
+				condition.wait(lock);
+			}
+			--sleepingCount;
 		}
 		if (aborted) {
-			queue.clear();
+			discardPending();
 			return TaskBase([] () {});
 		}
 	}
+	return result;
+}
+
+void ExecutionQueue::getTasks(Vector<TaskBase>& result, size_t n)
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		const size_t nShared = std::min(n, queue.size());
+		for (size_t i = 0; i < nShared; ++i) {
+			result.push_back(std::move(queue[i]));
+		}
+		queue.erase(queue.begin(), queue.begin() + nShared);
+		hasTasks.store(!queue.empty());
+		pendingCount -= int(nShared);
+	}
 
-	TaskBase value = queue.front();
-	queue.pop_front();
-	return value;
+	TaskBase task;
+	while (result.size() < n && tryGetNext(task)) {
+		result.push_back(std::move(task));
+	}
 }
 
 Vector<TaskBase> ExecutionQueue::getUpTo(size_t n)
 {
-	std::unique_lock<std::mutex> lock(mutex);
-	if (queue.size() <= n) {
-		hasTasks.store(false);
-		Vector<TaskBase> tasks(queue.begin(), queue.end());
-		queue.clear();
-		return tasks;
-	} else {
-		Vector<TaskBase> tasks(queue.begin(), queue.begin() + n);
-		queue.erase(queue.begin(), queue.begin() + n);
-		return tasks;
-	}
+	Vector<TaskBase> tasks;
+	getTasks(tasks, n);
+	return tasks;
 }
 
 Vector<TaskBase> ExecutionQueue::getAll()
 {
-	std::unique_lock<std::mutex> lock(mutex);
-	hasTasks.store(false);
-	Vector<TaskBase> tasks(queue.begin(), queue.end());
-	queue.clear();
+	Vector<TaskBase> tasks;
+	getTasks(tasks, std::numeric_limits<size_t>::max());
 	return tasks;
 }
 
@@ -62,18 +266,74 @@ void ExecutionQueue::addToQueue(TaskBase task)
 {
 	if (immediate) {
 		task();
-	} else {
+		return;
+	}
+
+	if (currentWorkerQueue == this && workers[currentWorkerIdx]->push(task)) {
+		onTaskAdded();
+		return;
+	}
+
+	{
 		std::unique_lock<std::mutex> lock(mutex);
-		queue.emplace_back(task);
+		queue.emplace_back(std::move(task));
 		hasTasks.store(true);
+	}
+	onTaskAdded();
+}
 
+void ExecutionQueue::onTaskAdded()
+{
+	// Sleepers check pendingCount under the mutex, so only wake them if someone is actually waiting
+	++pendingCount;
+	if (sleepingCount.load() > 0) {
+		std::unique_lock<std::mutex> lock(mutex);
 		condition.notify_one();
 	}
 }
 
+void ExecutionQueue::attachWorkerThread()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!workStealing || currentWorkerQueue) {
+		return;
+	}
+
+	size_t idx;
+	if (!freeWorkers.empty()) {
+		idx = freeWorkers.back();
+		freeWorkers.pop_back();
+	} else {
+		idx = workerCount.load();
+		if (idx >= maxWorkers) {
+			// Just use the shared queue
+			return;
+		}
+		workers[idx] = std::make_unique<WorkerQueue>();
+		workerCount.store(idx + 1, std::memory_order_release);
+	}
+
+	currentWorkerQueue = this;
+	currentWorkerIdx = idx;
+}
+
+void ExecutionQueue::detachWorkerThread()
+{
+	if (currentWorkerQueue != this) {
+		return;
+	}
+
+	// Anything left in the deque can still be stolen, and it goes to the next worker that attaches
+	std::unique_lock<std::mutex> lock(mutex);
+	freeWorkers.push_back(currentWorkerIdx);
+	currentWorkerQueue = nullptr;
+}
+
 Executors::Executors()
 {
 	immediate.setImmediate(true);
+	cpu.setWorkStealing(true);
+	cpuAux.setWorkStealing(true);
 }
 
 Executors& Executors::get()
@@ -89,6 +349,11 @@ void Executors::setInstance(Executors& e)
 	instance = &e;
 }
 
+void Executors::resetInstance()
+{
+	instance = nullptr;
+}
+
 size_t ExecutionQueue::threadCount() const
 {
 	return attachedCount.load();
@@ -112,15 +377,40 @@ void ExecutionQueue::abort()
 			return;
 		}
 		aborted = true;
+		discardPending();
 	}
 	condition.notify_all();
 }
 
+void ExecutionQueue::discardPending()
+{
+	// Called with the mutex held. Worker deques are emptied by stealing, which is safe while their owners still run.
+	int discarded = int(queue.size());
+	queue.clear();
+	hasTasks.store(false);
+
+	const size_t n = workerCount.load(std::memory_order_acquire);
+	for (size_t i = 0; i < n; ++i) {
+		while (!workers[i]->isEmpty()) {
+			TaskBase task;
+			if (workers[i]->steal(task)) {
+				++discarded;
+			}
+		}
+	}
+	pendingCount -= discarded;
+}
+
 void ExecutionQueue::setImmediate(bool immediate)
 {
 	this->immediate = immediate;
 }
 
+void ExecutionQueue::setWorkStealing(bool enabled)
+{
+	workStealing = enabled;
+}
+
 ExecutionQueue& ExecutionQueue::getDefault()
 {
 	return Executors::get().getCPU();
@@ -164,6 +454,7 @@ void Executor::runPending()
 
 void Executor::runForever()
 {
+	queue.attachWorkerThread();
 	while (running)	{
 		auto next = queue.getNext();
 		try {
@@ -174,6 +465,7 @@ void Executor::runForever()
 			Logger::logError("Unknown exception in executor.");
 		}
 	}
+	queue.detachWorkerThread();
 }
 
 void Executor::stop()
@@ -14,6 +14,7 @@
 #include "halley/file_formats/yaml_convert.h"
 #include "halley/resources/resources.h"
 #include "halley/utils/algorithm.h"
+#include "halley/utils/hash.h"
 
 using namespace Halley;
 
@@ -108,6 +109,54 @@ EntityData EntityFactory::doSerializeEntity(EntityRef entity, const Serializatio
 	return result;
 }
 
+uint64_t EntityFactory::getSerializationHash(EntityRef entity, const SerializationOptions& options, bool canStoreParent)
+{
+	const auto context = std::make_shared<EntityFactoryContext>(world, resources, EntitySerialization::makeMask(options.type), false);
+	Hash::Hasher hasher;
+	feedEntityToHash(entity, options, canStoreParent, entity.getPrefabAssetId().value_or(""), context->getEntitySerializationContext(), hasher);
+	return hasher.digest();
+}
+
+void EntityFactory::feedEntityToHash(EntityRef entity, const SerializationOptions& options, bool canStoreParent, const String& lastPrefab, const EntitySerializationContext& context, Hash::Hasher& hasher)
+{
+	// Must cover everything doSerializeEntity writes
+	hasher.feed(entity.getName().size());
+	hasher.feed(entity.getName());
+	hasher.feed(entity.isSelectable());
+	hasher.feed(entity.isSerializable());
+	hasher.feed(entity.isEnabled());
+	hasher.feed(entity.getInstanceUUID());
+	hasher.feed(entity.getPrefabUUID());
+	const auto prefabId = entity.getPrefabAssetId().value_or("");
+	if (prefabId != lastPrefab) {
+		hasher.feed(prefabId);
+	}
+
+	for (auto [componentId, component]: entity) {
+		hasher.feed(componentId);
+		world.getReflection().getComponentReflector(componentId).feedToHash(context, *component, hasher);
+	}
+
+	size_t nChildren = 0;
+	for (const auto& child: entity.getChildren()) {
+		if (child.isSerializable()) {
+			if (options.serializeAsStub && options.serializeAsStub(child)) {
+				hasher.feed(child.getInstanceUUID());
+			} else {
+				feedEntityToHash(child, options, false, prefabId, context, hasher);
+			}
+			++nChildren;
+		}
+	}
+	hasher.feed(nChildren);
+
+	if (canStoreParent) {
+		if (const auto parent = entity.tryGetParent()) {
+			hasher.feed(parent->getInstanceUUID());
+		}
+	}
+}
+
 EntityDataDelta EntityFactory::serializeEntityAsDelta(EntityRef entity, const SerializationOptions& options, const EntityDataDelta::Options& deltaOptions, bool canStoreParent)
 {
 	auto entityData = serializeEntity(entity, options, canStoreParent);
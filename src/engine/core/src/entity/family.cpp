@@ -61,6 +61,23 @@ void Family::notifyReload(void* entities, size_t count)
 	}
 }
 
+std::optional<size_t> Family::tryGetElementIndex(EntityId entityId) const
+{
+	// Entities added since the last update are indexed, but aren't elements yet
+	if (const auto iter = entityIndex.find(entityId); iter != entityIndex.end() && iter->second < elemCount) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+void Family::setSortByComponentAddress(bool enabled)
+{
+	if (enabled && !sortByComponentAddress) {
+		needsFullSort = true;
+	}
+	sortByComponentAddress = enabled;
+}
+
 void Family::removeEntity(Entity& entity)
 {
 	toRemove.push_back(entity.getEntityId());
@@ -62,11 +62,55 @@ bool System::tryInit()
 void System::onAddedToWorld(World& w, int id) {
 	world = &w;
 	systemId = id;
+	componentsRead.reset();
+	componentsWritten.reset();
 	for (auto f : families) {
 		f->bindFamily(*f, w);
+		componentsRead |= f->readMask.getRealValue(w.getMaskStorage());
+		componentsWritten |= f->writeMask.getRealValue(w.getMaskStorage());
 	}
 }
 
+void System::declareConcurrentAccess(Vector<int> messageTypesSent, Vector<String> servicesUsed)
+{
+	concurrent = true;
+	this->messageTypesSent = std::move(messageTypesSent);
+	this->servicesUsed = std::move(servicesUsed);
+}
+
+bool System::canRunConcurrentlyWith(const System& other) const
+{
+	if (!concurrent || !other.concurrent) {
+		return false;
+	}
+
+	// Components: any write must not overlap with the other system's reads or writes (reads include writes)
+	if ((componentsWritten & other.componentsRead).any() || (other.componentsWritten & componentsRead).any()) {
+		return false;
+	}
+
+	// Messages: sending purges and appends to the inbox for that type, so treat it as a write
+	for (const int type: messageTypesSent) {
+		if (std_ex::contains(other.messageTypesSent, type) || std_ex::contains(other.messageTypesReceived, type)) {
+			return false;
+		}
+	}
+	for (const int type: other.messageTypesSent) {
+		if (std_ex::contains(messageTypesReceived, type)) {
+			return false;
+		}
+	}
+
+	// Services: assume they're mutated by anyone holding them
+	for (const auto& service: servicesUsed) {
+		if (std_ex::contains(other.servicesUsed, service)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void System::processMessages()
 {
 }
@@ -82,24 +126,18 @@ void System::doProcessMessages(FamilyBindingBase& family, gsl::span<const int> t
 
 void System::doProcessMessages(FamilyBindingBase& family, int messageType, Vector<std::pair<MessageEntry, EntityId>>& messages)
 {
-	auto targetIds = VectorTemp<EntityId>(world->getUpdateMemoryPool());
-	targetIds.reserve(messages.size());
-	for (auto& msg: messages) {
-		targetIds.push_back(msg.second);
-	}
-
 	auto msgPtrs = VectorTemp<Message*>(world->getUpdateMemoryPool());
 	auto elemIdx = VectorTemp<size_t>(world->getUpdateMemoryPool());
 
-	const size_t sz = family.count();
-	for (size_t i = 0; i < sz; i++) {
-		const FamilyBase* elem = static_cast<FamilyBase*>(family.getElement(i));
-		if (std_ex::contains(targetIds, elem->entityId)) {
-			for (auto& msg: messages) {
-				if (msg.second == elem->entityId) {
-					msgPtrs.emplace_back(msg.first.msg.get());
-					elemIdx.emplace_back(i);
-				}
+	// The inbox is grouped by target, so each target only needs to be looked up in the family once
+	const size_t n = messages.size();
+	for (size_t i = 0; i < n; ) {
+		const EntityId target = messages[i].second;
+		const auto idx = family.family->tryGetElementIndex(target);
+		for (; i < n && messages[i].second == target; ++i) {
+			if (idx) {
+				msgPtrs.emplace_back(messages[i].first.msg.get());
+				elemIdx.emplace_back(*idx);
 			}
 		}
 	}
@@ -116,11 +154,8 @@ void System::doSendMessage(EntityId entityId, std::unique_ptr<Message> msg, int
 		return;
 	}
 
-	if (world->isEntityNetworkRemote(e)) {
-		world->sendNetworkMessage(entityId, id, std::move(msg));
-	} else {
-		outbox.emplace_back(std::make_pair(MessageEntry(std::move(msg), id, systemId), entityId));
-	}
+	// Remote entities are handled on dispatch, as this might be running concurrently with other systems
+	outbox.emplace_back(std::make_pair(MessageEntry(std::move(msg), id, systemId), entityId));
 }
 
 void System::dispatchMessages()
@@ -128,9 +163,13 @@ void System::dispatchMessages()
 	if (!outbox.empty()) {
 		for (auto& o: outbox) {
 			const int type = o.first.type;
-			world->sendEntityMessage(o.second, std::move(o.first));
-			if (!std_ex::contains(messageTypesSentThisUpdate, type)) {
-				messageTypesSentThisUpdate.push_back(type);
+			if (world->isEntityNetworkRemote(o.second)) {
+				world->sendNetworkMessage(o.second, type, std::move(o.first.msg));
+			} else {
+				world->sendEntityMessage(o.second, std::move(o.first));
+				if (!std_ex::contains(messageTypesSentThisUpdate, type)) {
+					messageTypesSentThisUpdate.push_back(type);
+				}
 			}
 		}
 		outbox.clear();
@@ -211,19 +250,30 @@ void System::sendSystemMessageConfig(const String& targetSystem, const String& m
 }
 
 void System::doUpdate(Time time) {
+	runUpdate(time);
+	purgeSentMessages();
+	dispatchMessages();
+}
+
+void System::purgeSentMessages()
+{
+	// Messages sent on the previous update have now been seen by every other system, and by this one on runUpdate()
+	if (!messageTypesSentThisUpdate.empty()) {
+		world->purgeMessages(systemId, messageTypesSentThisUpdate);
+		messageTypesSentThisUpdate.clear();
+	}
+}
+
+void System::runUpdate(Time time)
+{
 	HALLEY_DEBUG_TRACE_COMMENT(name.c_str());
 	ProfilerEvent event(ProfilerEventType::WorldSystemUpdate, name);
 
 	if (!messageTypesReceived.empty()) {
 		processMessages();
 	}
-	if (!messageTypesSentThisUpdate.empty()) {
-		world->purgeMessages(systemId, messageTypesSentThisUpdate);
-		messageTypesSentThisUpdate.clear();
-	}
-	
+
 	updateBase(time);
-	dispatchMessages();
 	HALLEY_DEBUG_TRACE_COMMENT(name.c_str());
 }
 
@@ -19,9 +19,15 @@
 #include "halley/support/logger.h"
 #include "halley/support/profiler.h"
 #include "halley/utils/algorithm.h"
+#include "halley/concurrency/concurrent.h"
 
 using namespace Halley;
 
+namespace {
+	// Set while a system is being updated concurrently, so it gets its own temporary memory pool
+	thread_local std::pair<const World*, TempMemoryPool*> concurrentUpdateMemoryPool = { nullptr, nullptr };
+}
+
 World::World(const HalleyAPI& api, Resources& resources, std::shared_ptr<WorldReflection> reflection)
 	: api(api)
 	, resources(resources)
@@ -132,6 +138,7 @@ System& World::addSystem(std::unique_ptr<System> system, TimeLine timelineType)
 	auto& timeline = getSystems(timelineType);
 	timeline.emplace_back(std::move(system));
 	ref.onAddedToWorld(*this, int(timeline.size()));
+	invalidateSystemBatches();
 	return ref;
 }
 
@@ -141,6 +148,7 @@ void World::removeSystem(System& system)
 		for (size_t i = 0; i < sys.size(); i++) {
 			if (sys[i].get() == &system) {
 				sys.erase(sys.begin() + i);
+				invalidateSystemBatches();
 				return;
 			}
 		}
@@ -611,8 +619,29 @@ void World::setHeadless(bool headless)
 	this->headless = headless;
 }
 
+void World::setParallelUpdate(bool enabled)
+{
+	parallelUpdate = enabled;
+}
+
+bool World::isParallelUpdate() const
+{
+	return parallelUpdate;
+}
+
+void World::setSortFamiliesByComponentAddress(bool enabled)
+{
+	sortFamiliesByComponentAddress = enabled;
+	for (auto& family: families) {
+		family->setSortByComponentAddress(enabled);
+	}
+}
+
 TempMemoryPool& World::getUpdateMemoryPool() const
 {
+	if (concurrentUpdateMemoryPool.first == this) {
+		return *concurrentUpdateMemoryPool.second;
+	}
 	return *updateMemoryPool;
 }
 
@@ -679,6 +708,9 @@ void World::spawnPending()
 
 void World::updateEntities()
 {
+	// Families (and their entity index) are only mutated here, so this must never run while systems update concurrently
+	Expects(!concurrentBatchRunning);
+
 	if (!entityDirty) {
 		return;
 	}
@@ -694,6 +726,7 @@ void World::updateEntities()
 		Vector<std::pair<FamilyMaskType, Entity*>> toAdd;
 		Vector<std::pair<FamilyMaskType, Entity*>> toRemove;
 		Vector<std::pair<FamilyMaskType, Entity*>> toReload;
+		Vector<Entity*> toRefresh;
 	};
 	std::map<FamilyMaskType, FamilyTodo> pending;
 
@@ -715,6 +748,8 @@ void World::updateEntities()
 			} else {
 				// It's alive, so check old and new system inclusions
 				FamilyMaskType oldMask = entity.getMask();
+				// A component removed and re-added in the same frame lives at a new address, even if the mask ends up the same
+				const bool replacedComponents = entity.liveComponents < entity.components.size();
 				entity.refresh(maskStorage.get(), *componentDeleterTable);
 				FamilyMaskType newMask = entity.getMask();
 
@@ -723,6 +758,9 @@ void World::updateEntities()
 					pending[oldMask].toRemove.emplace_back(newMask, &entity);
 					pending[newMask].toAdd.emplace_back(oldMask, &entity);
 				}
+				if (replacedComponents) {
+					pending[newMask].toRefresh.push_back(&entity);
+				}
 			}
 		}
 	}
@@ -767,6 +805,10 @@ void World::updateEntities()
 					}
 				}
 
+				for (auto* e: todo.second.toRefresh) {
+					fam->refreshEntity(*e);
+				}
+
 				for (auto& e : todo.second.toReload) {
 					fam->reloadEntity(*e.second);
 				}
@@ -817,6 +859,11 @@ void World::initSystems(gsl::span<const TimeLine> timelines)
 
 void World::updateSystems(TimeLine timeline, Time elapsed)
 {
+	if (parallelUpdate) {
+		updateSystemsParallel(timeline, elapsed);
+		return;
+	}
+
 	for (auto& system : getSystems(timeline)) {
 		updateMemoryPool->reset();
 		system->doUpdate(elapsed);
@@ -825,6 +872,97 @@ void World::updateSystems(TimeLine timeline, Time elapsed)
 	}
 }
 
+void World::updateSystemsParallel(TimeLine timeline, Time elapsed)
+{
+	for (const auto& batch: getSystemBatches(timeline)) {
+		updateMemoryPool->reset();
+		sortEntityMessageInboxes(); // Inboxes sort themselves on read, which can't happen concurrently
+
+		if (batch.size() == 1) {
+			batch[0]->doUpdate(elapsed);
+		} else {
+			while (concurrentUpdateMemoryPools.size() < batch.size()) {
+				concurrentUpdateMemoryPools.push_back(std::make_unique<TempMemoryPool>(64 * 1024));
+			}
+
+			Vector<std::exception_ptr> errors(batch.size());
+			auto runSystem = [&] (size_t i)
+			{
+				auto& pool = *concurrentUpdateMemoryPools[i];
+				concurrentUpdateMemoryPool = { this, &pool };
+				try {
+					batch[i]->runUpdate(elapsed);
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+				concurrentUpdateMemoryPool = { nullptr, nullptr };
+				pool.reset();
+			};
+
+			// The first system of the batch runs on this thread, while the others go to the CPU pool
+			concurrentBatchRunning = true;
+			Vector<Future<void>> futures;
+			futures.reserve(batch.size() - 1);
+			for (size_t i = 1; i < batch.size(); ++i) {
+				futures.push_back(Concurrent::execute(Executors::getCPU(), [&runSystem, i] () { runSystem(i); }));
+			}
+			runSystem(0);
+			Concurrent::whenAll(futures.begin(), futures.end()).wait();
+			concurrentBatchRunning = false;
+
+			for (auto& error: errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+
+			// Sync point: deliver messages in the same order a sequential update would
+			for (auto* system: batch) {
+				system->purgeSentMessages();
+				system->dispatchMessages();
+			}
+		}
+
+		spawnPending();
+		updateMemoryPool->reset();
+	}
+}
+
+const Vector<Vector<System*>>& World::getSystemBatches(TimeLine timeline)
+{
+	auto& batches = systemBatches[static_cast<int>(timeline)];
+	const auto& timelineSystems = getSystems(timeline);
+
+	if (batches.empty() && !timelineSystems.empty()) {
+		// Each system goes into the batch right after the last system it conflicts with
+		// This keeps the relative order of any two conflicting systems the same as in a sequential update
+		Vector<size_t> batchIdx(timelineSystems.size());
+		for (size_t i = 0; i < timelineSystems.size(); ++i) {
+			size_t idx = 0;
+			for (size_t j = 0; j < i; ++j) {
+				if (!timelineSystems[i]->canRunConcurrentlyWith(*timelineSystems[j])) {
+					idx = std::max(idx, batchIdx[j] + 1);
+				}
+			}
+			batchIdx[i] = idx;
+
+			if (batches.size() <= idx) {
+				batches.resize(idx + 1);
+			}
+			batches[idx].push_back(timelineSystems[i].get());
+		}
+	}
+
+	return batches;
+}
+
+void World::invalidateSystemBatches()
+{
+	for (auto& batches: systemBatches) {
+		batches.clear();
+	}
+}
+
 void World::renderSystems(RenderContext& rc) const
 {
 	for (auto& system : getSystems(TimeLine::Render)) {
@@ -842,6 +980,8 @@ Family& World::addFamily(std::unique_ptr<Family> family) noexcept
 
 void World::onAddFamily(Family& family) noexcept
 {
+	family.setSortByComponentAddress(sortFamiliesByComponentAddress);
+
 	// Add any existing entities to this new family
 	if (maskStorage) {
 		size_t nEntities = entities.size();
@@ -999,7 +1139,10 @@ void World::purgeMessages(int systemId, gsl::span<const int> messageTypes)
 {
 	for (const auto type: messageTypes) {
 		if (const auto iter = entityMessageInbox.find(type); iter != entityMessageInbox.end()) {
-			std_ex::erase_if(iter->second, [&] (const std::pair<MessageEntry, EntityId>& e) { return e.first.age == systemId; });
+			auto& inbox = iter->second;
+			const bool wasSorted = inbox.sortedCount == inbox.messages.size();
+			std_ex::erase_if(inbox.messages, [&] (const std::pair<MessageEntry, EntityId>& e) { return e.first.age == systemId; });
+			inbox.sortedCount = wasSorted ? inbox.messages.size() : 0;
 		}
 	}
 }
@@ -1007,14 +1150,36 @@ void World::purgeMessages(int systemId, gsl::span<const int> messageTypes)
 void World::sendEntityMessage(EntityId target, MessageEntry msg)
 {
 	auto id = msg.type;
-	entityMessageInbox[id].emplace_back(std::move(msg), target);
+	entityMessageInbox[id].messages.emplace_back(std::move(msg), target);
 }
 
 Vector<std::pair<MessageEntry, EntityId>>* World::getEntityMessageInbox(int messageType)
 {
 	if (const auto iter = entityMessageInbox.find(messageType); iter != entityMessageInbox.end()) {
-		return &iter->second;
+		auto& inbox = iter->second;
+		sortEntityMessageInbox(inbox);
+		return &inbox.messages;
 	}
 	return nullptr;
 }
 
+void World::sortEntityMessageInbox(EntityMessageInbox& inbox)
+{
+	auto& messages = inbox.messages;
+	if (inbox.sortedCount < messages.size()) {
+		// Messages are appended on dispatch, so only the tail needs sorting before merging it in
+		// Both are stable, so each target still receives its messages in the order they were sent
+		const auto byTarget = [] (const std::pair<MessageEntry, EntityId>& a, const std::pair<MessageEntry, EntityId>& b) { return a.second < b.second; };
+		const auto mid = messages.begin() + inbox.sortedCount;
+		std::stable_sort(mid, messages.end(), byTarget);
+		std::inplace_merge(messages.begin(), mid, messages.end(), byTarget);
+		inbox.sortedCount = messages.size();
+	}
+}
+
+void World::sortEntityMessageInboxes()
+{
+	for (auto& [type, inbox]: entityMessageInbox) {
+		sortEntityMessageInbox(inbox);
+	}
+}
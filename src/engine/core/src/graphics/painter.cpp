@@ -19,6 +19,7 @@
 #include "halley/support/profiler.h"
 #include "halley/utils/algorithm.h"
 #include "halley/resources/resources.h"
+#include "halley/concurrency/concurrent.h"
 
 using namespace Halley;
 
@@ -73,6 +74,19 @@ void Painter::endRender()
 	viewPort = Rect4i(0, 0, 0, 0);
 }
 
+void Painter::renderFrame(const Camera& camera, RenderTarget& renderTarget, const std::function<void(RenderContext&)>& f, RenderSnapshot* snapshot)
+{
+	startRender();
+	if (snapshot) {
+		startRecording(snapshot);
+	}
+
+	RenderContext context(*this, camera, renderTarget);
+	f(context);
+
+	endRender();
+}
+
 void Painter::flush()
 {
 	flushPending();
@@ -176,6 +190,27 @@ void Painter::drawQuads(const std::shared_ptr<const Material>& material, size_t
 	generateQuadIndices(result.firstIndex, numVertices / 4, result.dstIndex);
 }
 
+namespace {
+	// Expands each sprite's single vertex into the four vertices of its quad
+	template <typename F>
+	void expandSpriteVertices(char* dst, size_t vertexSize, size_t vertexStride, size_t vertPosOffset, size_t start, size_t end, F getSrc)
+	{
+		constexpr size_t verticesPerSprite = 4;
+		constexpr static Vector2f vertPosList[] = { Vector2f(0, 0), Vector2f(1, 0), Vector2f(1, 1), Vector2f(0, 1)};
+
+		for (size_t i = start; i < end; i++) {
+			const char* const src = getSrc(i);
+			for (size_t j = 0; j < verticesPerSprite; j++) {
+				const size_t dstOffset = (i * verticesPerSprite + j) * vertexStride;
+				memcpy(dst + dstOffset, src, vertexSize);
+
+				const auto vertPos = Vector4f(vertPosList[j], vertPosList[j]);
+				memcpy(dst + dstOffset + vertPosOffset, &vertPos, sizeof(vertPos));
+			}
+		}
+	}
+}
+
 void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_t totalNumSprites, const void* vertexData)
 {
 	Expects(vertexData != nullptr);
@@ -193,18 +228,7 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 		const auto result = addDrawData(material, numVertices, numSprites * 6, true);
 
 		const char* const src = static_cast<const char*>(vertexData) + offset;
-
-		for (size_t i = 0; i < numSprites; i++) {
-			for (size_t j = 0; j < verticesPerSprite; j++) {
-				const size_t srcOffset = i * result.vertexStride;
-				const size_t dstOffset = (i * verticesPerSprite + j) * result.vertexStride;
-				memcpy(result.dstVertex + dstOffset, src + srcOffset, result.vertexSize);
-
-				constexpr static Vector2f vertPosList[] = { Vector2f(0, 0), Vector2f(1, 0), Vector2f(1, 1), Vector2f(0, 1)};
-				const auto vertPos = Vector4f(vertPosList[j], vertPosList[j]);
-				memcpy(result.dstVertex + dstOffset + vertPosOffset, &vertPos, sizeof(vertPos));
-			}
-		}
+		expandSpriteVertices(result.dstVertex, result.vertexSize, result.vertexStride, vertPosOffset, 0, numSprites, [&] (size_t i) { return src + i * result.vertexStride; });
 
 		generateQuadIndices(result.firstIndex, numSprites, result.dstIndex);
 
@@ -213,6 +237,33 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 	}
 }
 
+void Painter::drawSprites(const std::shared_ptr<const Material>& material, gsl::span<const void* const> spriteVertexData, bool parallel)
+{
+	constexpr size_t verticesPerSprite = 4;
+	constexpr size_t maxSpritesPerCall = (static_cast<size_t>(std::numeric_limits<IndexType>::max()) + 1) / verticesPerSprite;
+	constexpr size_t minSpritesPerTask = 1024;
+	const size_t totalNumSprites = spriteVertexData.size();
+	const size_t vertPosOffset = material->getDefinition().getVertexPosOffset();
+
+	for (size_t first = 0; first < totalNumSprites; first += maxSpritesPerCall) {
+		const size_t numSprites = std::min(totalNumSprites - first, maxSpritesPerCall);
+
+		// Space for the whole batch is reserved up front, so each worker can fill in its own range of it
+		const auto result = addDrawData(material, verticesPerSprite * numSprites, numSprites * 6, true);
+		auto generate = [&] (size_t start, size_t end)
+		{
+			expandSpriteVertices(result.dstVertex, result.vertexSize, result.vertexStride, vertPosOffset, start, end, [&] (size_t i) { return static_cast<const char*>(spriteVertexData[first + i]); });
+			generateQuadIndices(static_cast<IndexType>(result.firstIndex + start * verticesPerSprite), end - start, result.dstIndex + start * 6);
+		};
+
+		if (parallel && numSprites >= 2 * minSpritesPerTask) {
+			Concurrent::parallelFor(numSprites, minSpritesPerTask, generate);
+		} else {
+			generate(0, numSprites);
+		}
+	}
+}
+
 void Painter::drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData)
 {
 	Expects(vertexData != nullptr);
@@ -529,13 +580,15 @@ void Painter::stopRecording()
 
 		recordTimestamp(TimestampType::FrameEnd, 0);
 		endPerformanceMeasurement();
-
-		if (recordingSnapshot) {
-			recordingSnapshot->end();
-			recordingSnapshot = nullptr;
-		}
 		recordingPerformance = false;
 	}
+
+	// Video backends without timestamp queries still record snapshots
+	if (recordingSnapshot) {
+		flush();
+		recordingSnapshot->end();
+		recordingSnapshot = nullptr;
+	}
 }
 
 bool Painter::startPerformanceMeasurement()
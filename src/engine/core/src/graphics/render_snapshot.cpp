@@ -117,6 +117,7 @@ RenderSnapshot::CommandInfo RenderSnapshot::getCommandInfo(size_t commandIdx) co
 			}
 		}
 		result.numTriangles = curDraw.indices.size() / 3;
+		result.numVertices = curDraw.numVertices;
 
 		if (const auto* prevDraw = getLastDraw()) {
 			const auto prevMat = prevDraw->material;
@@ -371,6 +371,11 @@ void Particles::setSecondarySpawner(IParticleSpawner* spawner)
 	secondarySpawner = spawner;
 }
 
+void Particles::setRNG(Random& rng)
+{
+	this->rng = &rng;
+}
+
 void Particles::spawnAt(Vector3f pos)
 {
 	spawn(1, 0.0f);
@@ -13,6 +13,7 @@
 #include "halley/entity/entity_factory.h"
 #include "halley/file_formats/config_file.h"
 #include "halley/support/logger.h"
+#include "halley/utils/hash.h"
 
 using namespace Halley;
 
@@ -145,6 +146,29 @@ void Sprite::drawMixedMaterials(const Sprite* sprites, size_t n, Painter& painte
 	draw(gsl::span<const Sprite>(sprites + start, n - start), painter);
 }
 
+void Sprite::drawBatched(gsl::span<const Sprite* const> sprites, Painter& painter, bool parallel)
+{
+	if (sprites.empty()) {
+		return;
+	}
+
+	const auto& material = sprites[0]->material;
+	Expects(material->getDefinition().getVertexStride() == sizeof(SpriteVertexAttrib) + 16);
+
+	Vector<const void*> vertexData;
+	vertexData.reserve(sprites.size());
+	for (const auto* sprite: sprites) {
+		vertexData.push_back(sprite->getVertexAttrib());
+	}
+
+	painter.drawSprites(material, vertexData, parallel);
+}
+
+bool Sprite::canDrawBatched() const
+{
+	return material && !sliced && !hasClip;
+}
+
 Rect4f Sprite::getLocalAABB() const
 {
 	const Vector2f sz = getScaledSize() * Vector2f(flip ? -1.0f : 1.0f, 1.0f);
@@ -759,6 +783,30 @@ ConfigNode ConfigNodeSerializer<Sprite>::serialize(const Sprite& sprite, const E
 	return node;
 }
 
+void ConfigNodeSerializer<Sprite>::feedToHash(const Sprite& sprite, const EntitySerializationContext& context, Hash::Hasher& hasher)
+{
+	// Covers what serialize() writes
+	const auto& colour = sprite.getColour();
+	hasher.feed(colour.r);
+	hasher.feed(colour.g);
+	hasher.feed(colour.b);
+	hasher.feed(colour.a);
+	hasher.feed(sprite.isVisible());
+	hasher.feed(sprite.hasMaterial());
+	if (sprite.hasMaterial()) {
+		const auto& material = sprite.getMaterial();
+		const auto& materialId = material.getDefinition().getAssetId();
+		hasher.feed(materialId.size());
+		hasher.feed(materialId);
+		const auto nTextures = material.getDefinition().getTextures().size();
+		for (size_t i = 0; i < nTextures; ++i) {
+			const auto& assetId = material.getTexUnitAssetId(static_cast<int>(i));
+			hasher.feed(assetId.size());
+			hasher.feed(assetId);
+		}
+	}
+}
+
 Sprite ConfigNodeSerializer<Sprite>::deserialize(const EntitySerializationContext& context, const ConfigNode& node)
 {
 	Sprite sprite;
@@ -2,6 +2,7 @@
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/painter.h"
 #include <gsl/gsl>
+#include <numeric>
 
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
@@ -14,9 +15,8 @@ SpritePainterEntry::SpritePainterEntry(gsl::span<const Sprite> sprites, int mask
 	: ptr(sprites.empty() ? nullptr : &sprites[0])
 	, count(uint32_t(sprites.size()))
 	, type(SpritePainterEntryType::SpriteRef)
-	, layer(layer)
 	, mask(mask)
-	, tieBreaker(tieBreaker)
+	, sortKey(makeSortKey(layer, tieBreaker))
 	, insertOrder(insertOrder)
 	, clip(clip)
 {}
@@ -25,9 +25,8 @@ SpritePainterEntry::SpritePainterEntry(gsl::span<const TextRenderer> texts, int
 	: ptr(texts.empty() ? nullptr : &texts[0])
 	, count(uint32_t(texts.size()))
 	, type(SpritePainterEntryType::TextRef)
-	, layer(layer)
 	, mask(mask)
-	, tieBreaker(tieBreaker)
+	, sortKey(makeSortKey(layer, tieBreaker))
 	, insertOrder(insertOrder)
 	, clip(clip)
 {
@@ -37,24 +36,40 @@ SpritePainterEntry::SpritePainterEntry(SpritePainterEntryType type, size_t sprit
 	: count(uint32_t(count))
 	, index(static_cast<int>(spriteIdx))
 	, type(type)
-	, layer(layer)
 	, mask(mask)
-	, tieBreaker(tieBreaker)
+	, sortKey(makeSortKey(layer, tieBreaker))
 	, insertOrder(insertOrder)
 	, clip(clip)
 {}
 
 bool SpritePainterEntry::operator<(const SpritePainterEntry& o) const
 {
-	if (layer != o.layer) {
-		return layer < o.layer;
-	} else if (tieBreaker != o.tieBreaker) {
-		return tieBreaker < o.tieBreaker;
+	if (sortKey != o.sortKey) {
+		return sortKey < o.sortKey;
 	} else {
 		return insertOrder < o.insertOrder;
 	}
 }
 
+uint64_t SpritePainterEntry::getSortKey() const
+{
+	return sortKey;
+}
+
+uint64_t SpritePainterEntry::makeSortKey(int layer, float tieBreaker)
+{
+	// Flipping the sign bit makes signed ints sort as unsigned
+	const uint32_t layerBits = static_cast<uint32_t>(layer) ^ 0x80000000u;
+
+	// Same for floats, except that negative ones also need their magnitude reversed. -0 and 0 compare equal, so they get the same key.
+	const float tieBreakerValue = tieBreaker == 0 ? 0.0f : tieBreaker;
+	uint32_t tieBreakerBits;
+	memcpy(&tieBreakerBits, &tieBreakerValue, sizeof(tieBreakerBits));
+	tieBreakerBits = (tieBreakerBits & 0x80000000u) != 0 ? ~tieBreakerBits : (tieBreakerBits | 0x80000000u);
+
+	return (static_cast<uint64_t>(layerBits) << 32) | tieBreakerBits;
+}
+
 SpritePainterEntryType SpritePainterEntry::getType() const
 {
 	return type;
@@ -236,6 +251,126 @@ bool SpritePainterMaterialParamUpdater::needsToPreProcessessMaterial(const Sprit
 	return sprite.hasMaterial() && sprite.getMaterial().getDefinition().hasAutoVariables();
 }
 
+void SpritePainterCullingGrid::build(gsl::span<const std::optional<Rect4f>> bounds)
+{
+	this->bounds = bounds;
+	unculled.clear();
+	large.clear();
+	cellEntries.clear();
+	visitStamp.assign(bounds.size(), 0);
+	curStamp = 0;
+
+	area = Rect4f();
+	bool first = true;
+	size_t nCulled = 0;
+	for (uint32_t i = 0; i < uint32_t(bounds.size()); ++i) {
+		if (bounds[i]) {
+			area = first ? *bounds[i] : area.merge(*bounds[i]);
+			first = false;
+			++nCulled;
+		} else {
+			unculled.push_back(i);
+		}
+	}
+
+	// Aim for a handful of entries per cell
+	const int side = clamp(static_cast<int>(std::sqrt(float(nCulled) / 8.0f)), 1, 128);
+	gridSize = Vector2i(side, side);
+	const auto areaSize = area.getSize();
+	cellScale = Vector2f(areaSize.x > 0 ? side / areaSize.x : 0.0f, areaSize.y > 0 ? side / areaSize.y : 0.0f);
+
+	// Counting sort of entries into cells. Entries covering lots of cells are just tested individually instead.
+	constexpr int maxCellsPerEntry = 16;
+	cellStart.assign(size_t(side * side + 1), 0);
+	for (uint32_t i = 0; i < uint32_t(bounds.size()); ++i) {
+		if (bounds[i]) {
+			const auto cells = getCells(*bounds[i]);
+			if (cells.getWidth() * cells.getHeight() > maxCellsPerEntry) {
+				large.push_back(i);
+			} else {
+				for (int y = cells.getTop(); y < cells.getBottom(); ++y) {
+					for (int x = cells.getLeft(); x < cells.getRight(); ++x) {
+						++cellStart[x + y * side + 1];
+					}
+				}
+			}
+		}
+	}
+	for (size_t i = 1; i < cellStart.size(); ++i) {
+		cellStart[i] += cellStart[i - 1];
+	}
+
+	cellEntries.resize(cellStart.back());
+	auto cellPos = cellStart;
+	for (uint32_t i = 0; i < uint32_t(bounds.size()); ++i) {
+		if (bounds[i]) {
+			const auto cells = getCells(*bounds[i]);
+			if (cells.getWidth() * cells.getHeight() <= maxCellsPerEntry) {
+				for (int y = cells.getTop(); y < cells.getBottom(); ++y) {
+					for (int x = cells.getLeft(); x < cells.getRight(); ++x) {
+						cellEntries[cellPos[x + y * side]++] = i;
+					}
+				}
+			}
+		}
+	}
+}
+
+void SpritePainterCullingGrid::query(Rect4f view, Vector<uint32_t>& result)
+{
+	result.clear();
+
+	if (view.contains(area)) {
+		result.resize(bounds.size());
+		std::iota(result.begin(), result.end(), 0);
+		return;
+	}
+
+	result.insert(result.end(), unculled.begin(), unculled.end());
+	for (const auto i: large) {
+		if (bounds[i]->overlaps(view)) {
+			result.push_back(i);
+		}
+	}
+
+	if (view.overlaps(area)) {
+		// Entries can be in more than one cell, so make sure each is only added once
+		if (++curStamp == 0) {
+			std::fill(visitStamp.begin(), visitStamp.end(), 0);
+			curStamp = 1;
+		}
+
+		const auto cells = getCells(view);
+		for (int y = cells.getTop(); y < cells.getBottom(); ++y) {
+			for (int x = cells.getLeft(); x < cells.getRight(); ++x) {
+				const auto cell = x + y * gridSize.x;
+				for (uint32_t j = cellStart[cell]; j < cellStart[cell + 1]; ++j) {
+					const auto i = cellEntries[j];
+					if (visitStamp[i] != curStamp) {
+						visitStamp[i] = curStamp;
+						if (bounds[i]->overlaps(view)) {
+							result.push_back(i);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::sort(result.begin(), result.end());
+}
+
+Rect4i SpritePainterCullingGrid::getCells(Rect4f rect) const
+{
+	const auto p0 = (rect.getTopLeft() - area.getTopLeft()) * cellScale;
+	const auto p1 = (rect.getBottomRight() - area.getTopLeft()) * cellScale;
+	const auto x0 = clamp(static_cast<int>(std::floor(p0.x)), 0, gridSize.x - 1);
+	const auto y0 = clamp(static_cast<int>(std::floor(p0.y)), 0, gridSize.y - 1);
+	const auto x1 = clamp(static_cast<int>(std::floor(p1.x)), 0, gridSize.x - 1);
+	const auto y1 = clamp(static_cast<int>(std::floor(p1.y)), 0, gridSize.y - 1);
+	return Rect4i(Vector2i(x0, y0), Vector2i(x1 + 1, y1 + 1));
+}
+
 SpritePainter::SpritePainter()
 	: memoryPool(256 * 1024)
 {
@@ -268,6 +403,8 @@ void SpritePainter::clear()
 	cachedSprites.clear();
 	cachedText.clear();
 	memoryPool.reset();
+	cullingDirty = true;
+	stats = {};
 }
 
 void SpritePainter::add(const Sprite& sprite, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
@@ -364,15 +501,116 @@ void SpritePainter::add(Rect4f bounds)
 	extraBounds.push_back(bounds);
 }
 
-void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
+void SpritePainter::sort()
 {
-	if (dirty) {
+	if (!dirty) {
+		return;
+	}
+	dirty = false;
+	cullingDirty = true;
+
+	const auto n = sprites.size();
+	constexpr size_t minRadixSortSize = 256;
+	if (n < minRadixSortSize) {
 		std::sort(sprites.begin(), sprites.end());
-		dirty = false;
+		return;
+	}
+
+	// LSD radix sort of the keys, one byte at a time. It's stable, so entries with the same key stay in insertion order.
+	sortKeys.resize(n);
+	sortKeysTemp.resize(n);
+	std::array<std::array<uint32_t, 256>, 8> counts = {};
+	for (uint32_t i = 0; i < n; ++i) {
+		const auto key = sprites[i].getSortKey();
+		sortKeys[i] = { key, i };
+		for (size_t pass = 0; pass < 8; ++pass) {
+			++counts[pass][(key >> (pass * 8)) & 0xFF];
+		}
+	}
+
+	for (size_t pass = 0; pass < 8; ++pass) {
+		auto& count = counts[pass];
+		const auto shift = pass * 8;
+
+		// Most bytes are the same across all keys (e.g. few layers in use), so those passes can be skipped
+		if (count[(sortKeys[0].first >> shift) & 0xFF] == n) {
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (auto& c: count) {
+			const auto cur = c;
+			c = offset;
+			offset += cur;
+		}
+		for (const auto& k: sortKeys) {
+			sortKeysTemp[count[(k.first >> shift) & 0xFF]++] = k;
+		}
+		std::swap(sortKeys, sortKeysTemp);
+	}
+
+	sortedEntries.clear();
+	sortedEntries.reserve(n);
+	for (const auto& k: sortKeys) {
+		sortedEntries.push_back(std::move(sprites[k.second]));
+	}
+	std::swap(sprites, sortedEntries);
+}
+
+gsl::span<const SpritePainterEntry> SpritePainter::getEntries() const
+{
+	return sprites;
+}
+
+void SpritePainter::setCulling(bool enabled)
+{
+	culling = enabled;
+}
+
+bool SpritePainter::isCulling() const
+{
+	return culling;
+}
+
+void SpritePainter::setParallelVertexGeneration(bool enabled)
+{
+	parallelVertexGeneration = enabled;
+}
+
+const SpritePainter::Stats& SpritePainter::getStats() const
+{
+	return stats;
+}
+
+void SpritePainter::updateCulling(Rect4f view)
+{
+	if (cullingDirty) {
+		// Only sprites get culled, text AABBs don't include outlines and shadows, and callbacks can draw anywhere
+		entryBounds.resize(sprites.size());
+		for (size_t i = 0; i < sprites.size(); ++i) {
+			const auto type = sprites[i].getType();
+			if (type == SpritePainterEntryType::SpriteRef || type == SpritePainterEntryType::SpriteCached) {
+				entryBounds[i] = sprites[i].getBounds(view, cachedSprites, cachedText);
+			} else {
+				entryBounds[i] = std::nullopt;
+			}
+		}
+		cullingGrid.build(entryBounds);
+		cullingDirty = false;
 	}
 
+	cullingGrid.query(view, visibleEntries);
+}
+
+void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
+{
+	sort();
+
 	// View
 	const Rect4f view = painter.getCurrentCamera().getClippingRectangle();
+	if (culling) {
+		updateCulling(view);
+	}
 
 	// Draw!
 	for (auto spriteIdx: getSpriteDrawOrder(mask, view, true)) {
@@ -387,24 +625,54 @@ void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
 			draw(callbacks.at(s.getIndex()), painter, s.getClip());
 		}
 	}
+	flushSpriteBatch(painter);
 	painter.flush();
 }
 
-Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const
+template <typename F>
+void SpritePainter::forEachVisibleEntry(int mask, F f) const
 {
-	if (reorder) {
-		return getSpriteDrawOrderReordered(mask, view);
-	}
-
-	Vector<uint32_t> result;
+	size_t submitted = 0;
+	size_t visible = 0;
 	const auto nTotal = static_cast<uint32_t>(sprites.size());
 	for (uint32_t i = 0; i < nTotal; ++i) {
 		auto& s = sprites[i];
-
 		if ((s.getMask() & mask) != 0) {
-			result.emplace_back(i);
+			submitted += s.getType() == SpritePainterEntryType::Callback ? 0 : s.getCount();
+			if (!culling) {
+				f(i, s);
+			}
 		}
 	}
+
+	if (culling) {
+		for (const auto i: visibleEntries) {
+			auto& s = sprites[i];
+			if ((s.getMask() & mask) != 0) {
+				visible += s.getType() == SpritePainterEntryType::Callback ? 0 : s.getCount();
+				f(i, s);
+			}
+		}
+	} else {
+		visible = submitted;
+	}
+
+	stats.submitted += submitted;
+	stats.culled += submitted - visible;
+}
+
+Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const
+{
+	if (reorder) {
+		return getSpriteDrawOrderReordered(mask, view);
+	}
+
+	Vector<uint32_t> result;
+	auto addEntry = [&] (uint32_t i, const SpritePainterEntry& s)
+	{
+		result.emplace_back(i);
+	};
+	forEachVisibleEntry(mask, addEntry);
 	return result;
 }
 
@@ -421,20 +689,24 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f vie
 		{}
 	};
 
+	// Entries go in a single allocation, which has to fit in one page of the pool
+	const size_t entriesSize = sprites.size() * sizeof(Entry) + 64 * sizeof(Rect4f) + 64;
+	if (entriesSize > memoryPool.getCapacity()) {
+		memoryPool.resize(nextPowerOf2(entriesSize));
+	}
+
 	auto entries = VectorTemp<Entry>(memoryPool);
+	entries.reserve(sprites.size());
 	auto skipped = VectorTemp<Rect4f>(memoryPool);
 	skipped.reserve(64);
 	constexpr int maxSkipsInARow = 16;
 
 	// Generate filtered sprite draw order, and sprite bounds
-	const auto nTotal = static_cast<uint32_t>(sprites.size());
-	for (uint32_t i = 0; i < nTotal; ++i) {
-		auto& s = sprites[i];
-
-		if ((s.getMask() & mask) != 0) {
-			entries.emplace_back(i, s.getBounds(view, cachedSprites, cachedText));
-		}
-	}
+	auto addEntry = [&] (uint32_t i, const SpritePainterEntry& s)
+	{
+		entries.emplace_back(i, culling && entryBounds[i] ? *entryBounds[i] : s.getBounds(view, cachedSprites, cachedText));
+	};
+	forEachVisibleEntry(mask, addEntry);
 	const auto n = static_cast<uint32_t>(entries.size());
 
 	Vector<uint32_t> result;
@@ -553,6 +825,17 @@ void SpritePainter::draw(gsl::span<const Sprite> sprites, Painter& painter, Rect
 			// The logic is a bit confusing here - if we're waiting, just go ahead, as the code will eventually wait
 			// If we're not waiting, skip this sprite if it's not loaded
 			if (waitForSpriteLoad || sprite.isLoaded()) {
+				++stats.drawn;
+
+				if (parallelVertexGeneration && !clip && sprite.canDrawBatched() && !paramUpdater.needsToPreProcessessMaterial(sprite)) {
+					if (!spriteBatch.empty() && !(spriteBatch.front()->getMaterialPtr() == sprite.getMaterialPtr() || spriteBatch.front()->getMaterial() == sprite.getMaterial())) {
+						flushSpriteBatch(painter);
+					}
+					spriteBatch.push_back(&sprite);
+					continue;
+				}
+
+				flushSpriteBatch(painter);
 				if (paramUpdater.needsToPreProcessessMaterial(sprite)) {
 					auto s2 = sprite;
 					paramUpdater.preProcessMaterial(s2);
@@ -567,13 +850,16 @@ void SpritePainter::draw(gsl::span<const Sprite> sprites, Painter& painter, Rect
 
 void SpritePainter::draw(gsl::span<const TextRenderer> texts, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const
 {
+	flushSpriteBatch(painter);
 	for (const auto& text: texts) {
 		text.draw(painter, clip);
 	}
+	stats.drawn += texts.size();
 }
 
 void SpritePainter::draw(const SpritePainterEntry::Callback& callback, Painter& painter, const std::optional<Rect4f>& clip) const
 {
+	flushSpriteBatch(painter);
 	if (clip) {
 		painter.setRelativeClip(clip.value());
 	}
@@ -582,3 +868,11 @@ void SpritePainter::draw(const SpritePainterEntry::Callback& callback, Painter&
 		painter.setClip();
 	}
 }
+
+void SpritePainter::flushSpriteBatch(Painter& painter) const
+{
+	if (!spriteBatch.empty()) {
+		Sprite::drawBatched(spriteBatch, painter, true);
+		spriteBatch.clear();
+	}
+}
@@ -91,15 +91,19 @@ std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
 	auto font = std::make_unique<Font>();
 	auto ds = Deserializer(data->getSpan());
 	font->deserialize(ds);
-
-	auto texture = loader.getResources().get<Texture>(font->imageName);
-	auto matDef = loader.getResources().get<MaterialDefinition>(font->distanceField ? "Halley/Text" : MaterialDefinition::defaultMaterial);
-	font->material = std::make_unique<Material>(matDef);
-	font->material->set(0, texture);
+	font->loadMaterial(loader.getResources());
 
 	return font;
 }
 
+void Font::loadMaterial(Resources& resources)
+{
+	auto texture = resources.get<Texture>(imageName);
+	auto matDef = resources.get<MaterialDefinition>(distanceField ? "Halley/Text" : MaterialDefinition::defaultMaterial);
+	material = std::make_unique<Material>(matDef);
+	material->set(0, texture);
+}
+
 void Font::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<Font&>(resource));
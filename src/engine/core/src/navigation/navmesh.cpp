@@ -394,10 +394,47 @@ std::optional<NavigationPath> Navmesh::pathfind(const NavigationQuery& query) co
 	return makePath(query, nodePath.value());
 }
 
-Vector<Navmesh::NodeAndConn> Navmesh::makeResult(const Vector<State>& state, int startId, int endId) const
+Navmesh::SearchContext::SearchContext()
+	: openSet(NodeComparator(state))
+{
+}
+
+void Navmesh::SearchContext::begin(size_t nNodes)
+{
+	if (state.size() < nNodes) {
+		state.resize(nNodes);
+	}
+	openSet.clear();
+
+	++generation;
+	if (generation == 0) {
+		// Wrapped around, so old stamps could collide with new ones
+		std::fill(state.begin(), state.end(), State{});
+		generation = 1;
+	}
+}
+
+Navmesh::State& Navmesh::SearchContext::getState(NodeId id)
+{
+	auto& s = state[id];
+	if (s.generation != generation) {
+		s = State{};
+		s.generation = generation;
+	}
+	return s;
+}
+
+Navmesh::SearchContext& Navmesh::getSearchContext()
+{
+	// Queries can run on several threads at once (e.g. from NavmeshSet), so each gets its own
+	static thread_local SearchContext context;
+	return context;
+}
+
+Vector<Navmesh::NodeAndConn> Navmesh::makeResult(const SearchContext& context, int startId, int endId) const
 {
 	Vector<NodeAndConn> result;
-	for (NodeAndConn curNode(endId); true; curNode = state[curNode.node].cameFrom) {
+	for (NodeAndConn curNode(endId); true; curNode = context.getVisitedState(curNode.node).cameFrom) {
 		result.push_back(curNode);
 		if (curNode.node == startId) {
 			break;
@@ -415,13 +452,10 @@ std::optional<Vector<Navmesh::NodeAndConn>> Navmesh::pathfind(int fromId, int to
 		return {};
 	}
 
-	// State map. Using vector for perf, trading space for CPU.
-	// TODO: measure this vs unordered_map or some other hashtable, it's not impossible that it'd perform better (compact memory)
-	Vector<State> state(nodes.size(), State{});
-
-	// Open set
-	auto openSet = PriorityQueue<NodeId, NodeComparator>(NodeComparator(state));
-	openSet.reserve(std::min(static_cast<size_t>(100), nodes.size()));
+	// State map and open set, reused across queries to avoid allocating and clearing them every time
+	auto& context = getSearchContext();
+	context.begin(nodes.size());
+	auto& openSet = context.openSet;
 
 	// Define heuristic function
 	const Vector2f endPos = nodes[toId].pos;
@@ -433,12 +467,12 @@ std::optional<Vector<Navmesh::NodeAndConn>> Navmesh::pathfind(int fromId, int to
 
 	// Initialize the query
 	{
-		auto& firstNodeState = state[fromId];
+		auto& firstNodeState = context.getState(static_cast<NodeId>(fromId));
 		firstNodeState.cameFrom = NodeAndConn();
 		firstNodeState.gScore = 0;
 		firstNodeState.fScore = h(nodes[fromId].pos);
 		firstNodeState.inOpenSet = true;
-		openSet.push(fromId);
+		openSet.push(static_cast<NodeId>(fromId));
 	}
 
 	// Run A*
@@ -446,20 +480,21 @@ std::optional<Vector<Navmesh::NodeAndConn>> Navmesh::pathfind(int fromId, int to
 		const auto curId = openSet.top();
 		if (curId == toId) {
 			// Done!
-			return makeResult(state, fromId, toId);
+			return makeResult(context, fromId, toId);
 		}
 
-		state[curId].inOpenSet = false;
-		state[curId].inClosedSet = true;
+		auto& curState = context.getState(curId);
+		curState.inOpenSet = false;
+		curState.inClosedSet = true;
 		openSet.pop();
 		
-		const float gScore = state[curId].gScore;
+		const float gScore = curState.gScore;
 		const auto& curNode = nodes[curId];
 		for (size_t i = 0; i < curNode.nConnections; ++i) {
 			if (curNode.connections[i]) {
 				const auto nodeId = curNode.connections[i].value();
-				if (!state[nodeId].inClosedSet) {
-					auto& neighState = state[nodeId];
+				auto& neighState = context.getState(nodeId);
+				if (!neighState.inClosedSet) {
 					const float neighScore = gScore + curNode.costs[i];
 
 					if (neighScore < neighState.gScore) {
@@ -1,6 +1,7 @@
 #include "halley/navigation/navmesh_set.h"
 
 #include "halley/bytes/byte_serializer.h"
+#include "halley/concurrency/concurrent.h"
 #include "halley/data_structures/priority_queue.h"
 #include "halley/maths/ray.h"
 #include "halley/support/logger.h"
@@ -132,6 +133,20 @@ std::optional<NavigationPath> NavmeshSet::pathfind(const NavigationQuery& origQu
 	}
 }
 
+Future<Vector<NavigationQueryResult>> NavmeshSet::pathfindBatch(Vector<NavigationQuery> queries, float anisotropy, float nudge) const
+{
+	return Concurrent::execute(Executors::getCPU(), [this, queries = std::move(queries), anisotropy, nudge] () -> Vector<NavigationQueryResult>
+	{
+		Vector<NavigationQueryResult> results(queries.size());
+		Concurrent::parallelFor(queries.size(), 1, [&] (size_t start, size_t end) {
+			for (size_t i = start; i < end; ++i) {
+				results[i].path = pathfind(queries[i], &results[i].error, anisotropy, nudge);
+			}
+		});
+		return results;
+	});
+}
+
 std::optional<NavigationPath> NavmeshSet::pathfindInRegion(const NavigationQuery& query, uint16_t regionId) const
 {
 	return navmeshes[regionId].pathfind(query);
@@ -0,0 +1,81 @@
+#include "halley/net/entity/entity_network_interest_grid.h"
+using namespace Halley;
+
+bool EntityNetworkInterestGrid::Entry::operator<(const Entry& other) const
+{
+	return cell != other.cell ? cell < other.cell : index < other.index;
+}
+
+EntityNetworkInterestGrid::EntityNetworkInterestGrid(int cellSize)
+	: cellSize(cellSize)
+{
+	Expects(cellSize > 0);
+}
+
+void EntityNetworkInterestGrid::clear()
+{
+	positions.clear();
+	entries.clear();
+	unpositioned.clear();
+}
+
+void EntityNetworkInterestGrid::add(size_t index, std::optional<Vector2i> position)
+{
+	if (positions.size() <= index) {
+		positions.resize(index + 1);
+	}
+	positions[index] = position;
+
+	if (position) {
+		entries.push_back(Entry{ getCellKey(getCell(*position)), static_cast<uint32_t>(index) });
+	} else {
+		unpositioned.push_back(static_cast<uint32_t>(index));
+	}
+}
+
+void EntityNetworkInterestGrid::build()
+{
+	std::sort(entries.begin(), entries.end());
+}
+
+void EntityNetworkInterestGrid::query(Rect4i rect, Vector<size_t>& result) const
+{
+	const size_t startSize = result.size();
+	const auto c0 = getCell(rect.getTopLeft());
+	const auto c1 = getCell(rect.getBottomRight());
+
+	// Keys are column-major, so each column of cells is one contiguous run of entries
+	for (int x = c0.x; x <= c1.x; ++x) {
+		const auto lastKey = getCellKey(Vector2i(x, c1.y));
+		auto iter = std::lower_bound(entries.begin(), entries.end(), Entry{ getCellKey(Vector2i(x, c0.y)), 0 });
+		for (; iter != entries.end() && iter->cell <= lastKey; ++iter) {
+			if (rect.contains(*positions[iter->index])) {
+				result.push_back(iter->index);
+			}
+		}
+	}
+
+	for (const auto idx: unpositioned) {
+		result.push_back(idx);
+	}
+
+	std::sort(result.begin() + startSize, result.end());
+}
+
+std::optional<Vector2i> EntityNetworkInterestGrid::getPosition(size_t index) const
+{
+	return positions.at(index);
+}
+
+Vector2i EntityNetworkInterestGrid::getCell(Vector2i pos) const
+{
+	return pos.floorDiv(Vector2i(cellSize, cellSize));
+}
+
+uint64_t EntityNetworkInterestGrid::getCellKey(Vector2i cell)
+{
+	// Flip the sign bits so that ordering the keys as unsigned orders the cells as signed
+	const auto x = static_cast<uint32_t>(cell.x) ^ 0x80000000u;
+	const auto y = static_cast<uint32_t>(cell.y) ^ 0x80000000u;
+	return (static_cast<uint64_t>(x) << 32) | y;
+}
@@ -19,15 +19,18 @@ NetworkSession::PeerId EntityNetworkRemotePeer::getPeerId() const
 	return peerId;
 }
 
-void EntityNetworkRemotePeer::sendEntities(Time t, gsl::span<const EntityNetworkUpdateInfo> entityIds, const EntityClientSharedData& clientData)
+bool EntityNetworkRemotePeer::prepareEntities(Time t, gsl::span<const EntityNetworkUpdateInfo> entityIds, const EntityClientSharedData& clientData)
 {
 	Expects(isAlive());
 
+	toCreate.clear();
+	toUpdate.clear();
+
 	if (!isRemoteReady()) {
 		if (timeSinceSend > maxSendInterval) {
 			sendKeepAlive();
 		}
-		return;
+		return false;
 	}
 
 	timeSinceSend += t;
@@ -37,27 +40,73 @@ void EntityNetworkRemotePeer::sendEntities(Time t, gsl::span<const EntityNetwork
 		e.second.alive = false;
 	}
 
-	Vector<EntityRef> toCreate;
-	Vector<std::pair<EntityRef, OutboundEntity*>> toUpdate;
+	const auto interest = clientData.viewRect ? parent->getViewInterest(peerId) : std::nullopt;
+	if (interest) {
+		// Only look at entities near the view, which includes anything already sent that is still within the leave margin
+		const auto& grid = parent->getInterestGrid();
+		const auto enterRect = clientData.viewRect->grow(interest->enterMargin);
+		interestCandidates.clear();
+		grid.query(clientData.viewRect->grow(std::max(interest->enterMargin, interest->leaveMargin)), interestCandidates);
+
+		for (const auto idx: interestCandidates) {
+			const auto& entry = entityIds[idx];
+			if (entry.ownerId == peerId) {
+				continue;
+			}
 
-	for (auto entry: entityIds) {
-		if (entry.ownerId == peerId) {
-			// Don't send updates back to the owner
-			continue;
+			const auto entity = parent->getWorld().getEntity(entry.entityId);
+			const auto pos = grid.getPosition(idx);
+			const bool inView = pos ? (enterRect.contains(*pos) || outboundEntities.contains(entry.entityId)) : parent->isEntityInView(entity, clientData, peerId);
+			if (inView) {
+				prepareEntity(t, entity);
+			}
 		}
+	} else {
+		for (auto entry: entityIds) {
+			if (entry.ownerId == peerId) {
+				// Don't send updates back to the owner
+				continue;
+			}
 
-		const auto entity = parent->getWorld().getEntity(entry.entityId);
-		if (parent->isEntityInView(entity, clientData, peerId)) {
-			if (const auto iter = outboundEntities.find(entry.entityId); iter == outboundEntities.end()) {
-				parent->setupOutboundInterpolators(entity);
-				toCreate.push_back(entity);
-			} else {
-				iter->second.alive = true;
-				toUpdate.emplace_back(entity, &iter->second);
+			const auto entity = parent->getWorld().getEntity(entry.entityId);
+			if (parent->isEntityInView(entity, clientData, peerId)) {
+				prepareEntity(t, entity);
 			}
 		}
 	}
 
+	return true;
+}
+
+void EntityNetworkRemotePeer::prepareEntity(Time t, EntityRef entity)
+{
+	if (const auto iter = outboundEntities.find(entity.getEntityId()); iter == outboundEntities.end()) {
+		parent->setupOutboundInterpolators(entity);
+		toCreate.push_back(entity);
+	} else {
+		auto& remote = iter->second;
+		remote.alive = true;
+		remote.timeSinceSend += t;
+		if (remote.timeSinceSend >= parent->getMinSendInterval()) {
+			toUpdate.emplace_back(entity, &remote);
+		}
+	}
+}
+
+void EntityNetworkRemotePeer::getEntitiesToSerialize(Vector<EntityId>& result) const
+{
+	for (const auto& e: toCreate) {
+		result.push_back(e.getEntityId());
+	}
+	for (const auto& [e, oe]: toUpdate) {
+		result.push_back(e.getEntityId());
+	}
+}
+
+void EntityNetworkRemotePeer::sendEntities(const EntityNetworkSnapshot& snapshot)
+{
+	Expects(isAlive());
+
 	// Order is important here, we need to first destroy, then update, then create
 	// This is so we don't run into an issue where an entity is moved inside another and we attempt to create/update the new one while the old one is still present
 
@@ -70,14 +119,17 @@ void EntityNetworkRemotePeer::sendEntities(Time t, gsl::span<const EntityNetwork
 
 	// Update existing entities
 	for (auto& [e, oe] : toUpdate) {
-		sendUpdateEntity(t, *oe, e);
+		sendUpdateEntity(*oe, e, snapshot.at(e.getEntityId()));
 	}
 
 	// Create new entities
 	for (auto& e: toCreate) {
-		sendCreateEntity(e);
+		sendCreateEntity(e, snapshot.at(e.getEntityId()));
 	}
 
+	toCreate.clear();
+	toUpdate.clear();
+
 	std_ex::erase_if_value(outboundEntities, [](const OutboundEntity& e) { return !e.alive; });
 
 	if (timeSinceSend > maxSendInterval) {
@@ -166,14 +218,14 @@ uint16_t EntityNetworkRemotePeer::assignId()
 	throw Exception("Unable to allocate network id for entity.", HalleyExceptions::Network);
 }
 
-void EntityNetworkRemotePeer::sendCreateEntity(EntityRef entity)
+void EntityNetworkRemotePeer::sendCreateEntity(EntityRef entity, std::shared_ptr<const EntityData> data)
 {
 	OutboundEntity result;
 
 	result.networkId = assignId();
-	result.data = parent->getFactory().serializeEntity(entity, parent->getEntitySerializationOptions());
+	result.data = std::move(data);
 
-	auto deltaData = parent->getFactory().entityDataToPrefabDelta(result.data, entity.getPrefab(), parent->getEntityDeltaOptions());
+	auto deltaData = parent->getFactory().entityDataToPrefabDelta(*result.data, entity.getPrefab(), parent->getEntityDeltaOptions());
 	auto bytes = Serializer::toBytes(deltaData, parent->getByteSerializationOptions());
 	//Logger::logDev("Send Create: " + entity.getName() + " (" + entity.getInstanceUUID() + ") to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size()) + " B):\n" + deltaData.toYAML() + "\n");
 	Logger::logDev("Send Create: " + entity.getName() + " (" + entity.getInstanceUUID() + ") to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size()) + " B)");
@@ -183,19 +235,18 @@ void EntityNetworkRemotePeer::sendCreateEntity(EntityRef entity)
 	outboundEntities[entity.getEntityId()] = std::move(result);
 }
 
-void EntityNetworkRemotePeer::sendUpdateEntity(Time t, OutboundEntity& remote, EntityRef entity)
+void EntityNetworkRemotePeer::sendUpdateEntity(OutboundEntity& remote, EntityRef entity, std::shared_ptr<const EntityData> newData)
 {
-	remote.timeSinceSend += t;
-	if (remote.timeSinceSend < parent->getMinSendInterval()) {
+	if (remote.data == newData) {
+		// Hash matched last tick's, so the session handed back the same serialization
 		return;
 	}
 
-	// Encode delta using interpolators
-	auto newData = parent->getFactory().serializeEntity(entity, parent->getEntitySerializationOptions());
+	// Encode delta using interpolators, against the last snapshot sent to this peer
 	auto retriever = DataInterpolatorSetRetriever(entity, true);
 	auto options = parent->getEntityDeltaOptions();
 	options.interpolatorSet = &retriever;
-	auto deltaData = EntityDataDelta(remote.data, newData, options);
+	auto deltaData = EntityDataDelta(*remote.data, *newData, options);
 	
 	if (deltaData.hasChange()) {
 		remote.data = std::move(newData);
@@ -7,7 +7,9 @@
 #include "halley/entity/entity_factory.h"
 #include "halley/entity/system.h"
 #include "halley/entity/world.h"
+#include "halley/entity/components/transform_2d_component.h"
 #include "halley/support/logger.h"
+#include "halley/time/stopwatch.h"
 #include "halley/utils/algorithm.h"
 
 class NetworkComponent;
@@ -80,16 +82,119 @@ void EntityNetworkSession::sendEntityUpdates(Time t, Rect4i viewRect, gsl::span<
 		}
 	}
 
-	// Update entities
-    Vector<Future<void>> tasks;
+	buildInterestGrid(entityIds);
 
-    for (auto& peer : peers) {
-        tasks += Concurrent::execute([&]() {
-            peer.sendEntities(t, entityIds, session->getClientSharedData<EntityClientSharedData>(peer.getPeerId()));
-        });
-    }
+	// Work out what each peer needs
+	Vector<char> peerReady(peers.size(), 0);
+	Concurrent::parallelFor(peers.size(), 1, [&] (size_t start, size_t end) {
+		for (size_t i = start; i < end; ++i) {
+			auto& peer = peers[i];
+			peerReady[i] = peer.prepareEntities(t, entityIds, session->getClientSharedData<EntityClientSharedData>(peer.getPeerId())) ? 1 : 0;
+		}
+	});
+
+	// Serialize each entity once, no matter how many peers it's going to
+	Vector<EntityId> toSerialize;
+	for (size_t i = 0; i < peers.size(); ++i) {
+		if (peerReady[i]) {
+			peers[i].getEntitiesToSerialize(toSerialize);
+		}
+	}
+	serializeSnapshot(std::move(toSerialize));
+
+	// Send to each peer, diffing against what it last received
+	Concurrent::parallelFor(peers.size(), 1, [&] (size_t start, size_t end) {
+		for (size_t i = start; i < end; ++i) {
+			if (peerReady[i]) {
+				peers[i].sendEntities(snapshot);
+			}
+		}
+	});
+	snapshot.clear();
+}
+
+void EntityNetworkSession::buildInterestGrid(gsl::span<const EntityNetworkUpdateInfo> entityIds)
+{
+	interestGrid.clear();
+
+	bool anyInterest = false;
+	for (const auto& peer: peers) {
+		anyInterest = anyInterest || getViewInterest(peer.getPeerId());
+	}
+	if (!anyInterest) {
+		return;
+	}
 
-    Concurrent::whenAll(tasks.begin(), tasks.end()).wait();
+	// Done serially, as global positions are computed lazily
+	for (size_t i = 0; i < entityIds.size(); ++i) {
+		const auto entity = getWorld().getEntity(entityIds[i].entityId);
+		const auto* transform = entity.tryGetComponent<Transform2DComponent>();
+		interestGrid.add(i, transform ? std::optional<Vector2i>(Vector2i(transform->getGlobalPosition())) : std::nullopt);
+	}
+	interestGrid.build();
+}
+
+void EntityNetworkSession::serializeSnapshot(Vector<EntityId> entityIds)
+{
+	++serializationTick;
+	const size_t requested = entityIds.size();
+	std::sort(entityIds.begin(), entityIds.end());
+	entityIds.erase(std::unique(entityIds.begin(), entityIds.end()), entityIds.end());
+
+	// Insert serially, so the parallel pass below only touches entries that already exist
+	Vector<CachedEntity*> cached(entityIds.size());
+	for (size_t i = 0; i < entityIds.size(); ++i) {
+		cached[i] = &serializationCache[entityIds[i]];
+	}
+
+	// Hashing the replicated fields is much cheaper than serializing them, so only serialize entities that changed
+	std::atomic<size_t> nUnchanged = 0;
+	const auto nanoseconds = Concurrent::parallelReduce(entityIds.size(), 0, int64_t(0), [&] (size_t start, size_t end)
+	{
+		Stopwatch stopwatch;
+		size_t unchanged = 0;
+		for (size_t i = start; i < end; ++i) {
+			const auto entity = getWorld().getEntity(entityIds[i]);
+			auto& entry = *cached[i];
+			const auto hash = factory->getSerializationHash(entity, entitySerializationOptions, true);
+			// Trusts the 64-bit hash: a collision would hide a change until the entity changes again, but it's vanishingly unlikely
+			if (entry.data && entry.hash == hash) {
+				++unchanged;
+			} else {
+				entry.hash = hash;
+				entry.data = std::make_shared<const EntityData>(factory->serializeEntity(entity, entitySerializationOptions));
+			}
+			entry.lastUsedTick = serializationTick;
+		}
+		nUnchanged += unchanged;
+		return stopwatch.elapsedNanoseconds();
+	}, [] (int64_t a, int64_t b) { return a + b; });
+
+	snapshot.clear();
+	snapshot.reserve(entityIds.size());
+	for (size_t i = 0; i < entityIds.size(); ++i) {
+		snapshot[entityIds[i]] = cached[i]->data;
+	}
+
+	serializationStats.update(requested, entityIds.size(), nUnchanged, static_cast<Time>(nanoseconds) / 1'000'000'000.0);
+
+	pruneSerializationCache();
+}
+
+void EntityNetworkSession::pruneSerializationCache()
+{
+	// Drop entities that haven't been sent in a while (destroyed, or out of everyone's view)
+	constexpr uint32_t maxIdleTicks = 100;
+	if (serializationTick % maxIdleTicks != 0) {
+		return;
+	}
+	for (auto iter = serializationCache.begin(); iter != serializationCache.end();) {
+		if (serializationTick - iter->second.lastUsedTick > maxIdleTicks) {
+			iter = serializationCache.erase(iter);
+		} else {
+			++iter;
+		}
+	}
 }
 
 void EntityNetworkSession::sendToAll(EntityNetworkMessage msg)
@@ -440,6 +545,21 @@ Time EntityNetworkSession::getMinSendInterval() const
 	return 0.05;
 }
 
+void EntityNetworkSerializationStats::update(size_t requested, size_t unique, size_t unchanged, Time serializationTime)
+{
+	this->requested = requested;
+	this->serialized = unique - unchanged;
+	this->unchanged = unchanged;
+	this->serializationTime = serializationTime;
+	// Assumes every serialization that was skipped would have cost as much as the average one that wasn't
+	savedTime = serialized > 0 ? serializationTime * static_cast<Time>(getSaved()) / static_cast<Time>(serialized) : 0;
+}
+
+const EntityNetworkSerializationStats& EntityNetworkSession::getSerializationStats() const
+{
+	return serializationStats;
+}
+
 void EntityNetworkSession::onRemoteEntityCreated(EntityRef entity, NetworkSession::PeerId peerId)
 {
 	if (listener) {
@@ -523,6 +643,17 @@ bool EntityNetworkSession::isEntityInView(EntityRef entity, const EntityClientSh
 	return listener->isEntityInView(entity, clientData, peerId);
 }
 
+std::optional<EntityNetworkViewInterest> EntityNetworkSession::getViewInterest(NetworkSession::PeerId peerId) const
+{
+	Expects(listener);
+	return listener->getViewInterest(peerId);
+}
+
+const EntityNetworkInterestGrid& EntityNetworkSession::getInterestGrid() const
+{
+	return interestGrid;
+}
+
 Vector<Rect4i> EntityNetworkSession::getRemoteViewPorts() const
 {
 	Vector<Rect4i> result;
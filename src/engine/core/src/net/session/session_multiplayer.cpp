@@ -220,6 +220,15 @@ bool SessionMultiplayer::isEntityInView(EntityRef entity, const EntityClientShar
 	return clientData.viewRect->grow(256).contains(Vector2i(transform->getGlobalPosition()));
 }
 
+std::optional<EntityNetworkViewInterest> SessionMultiplayer::getViewInterest(NetworkSession::PeerId peerId) const
+{
+	// The host sees everything, see isEntityInView
+	if (peerId == 0) {
+		return {};
+	}
+	return EntityNetworkViewInterest{ 256, 384 };
+}
+
 ConfigNode SessionMultiplayer::getLobbyInfo()
 {
 	return {};
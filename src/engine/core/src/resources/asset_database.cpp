@@ -122,6 +122,16 @@ bool AssetDatabase::hasDatabase(AssetType type) const
 	return dbs.find(static_cast<int>(type)) != dbs.end();
 }
 
+Vector<AssetType> AssetDatabase::getTypes() const
+{
+	Vector<AssetType> result;
+	result.reserve(dbs.size());
+	for (const auto& db: dbs) {
+		result.push_back(static_cast<AssetType>(db.first));
+	}
+	return result;
+}
+
 Vector<String> AssetDatabase::getAssets() const
 {
 	HashSet<String> contains;
@@ -8,14 +8,38 @@
 
 using namespace Halley;
 
-void AssetPackHeader::init(size_t assetDbSize)
+namespace {
+	constexpr const char* packIdentifierV1 = "HALLEYPK";
+	constexpr const char* packIdentifierV2 = "HALLEYP2";
+}
+
+void AssetPackHeader::init(int version, size_t indexSize, size_t assetDbSize)
 {
-	memcpy(identifier.data(), "HALLEYPK", 8);
-	assetDbStartPos = sizeof(AssetPackHeader);
+	Expects(version == 1 || version == 2);
+	Expects(version == 2 || indexSize == 0);
+
+	memcpy(identifier.data(), version == 2 ? packIdentifierV2 : packIdentifierV1, 8);
+	assetDbStartPos = sizeof(AssetPackHeader) + indexSize;
 	dataStartPos = assetDbStartPos + assetDbSize;
 	memset(iv.data(), 0, iv.size());
 }
 
+int AssetPackHeader::getVersion() const
+{
+	if (memcmp(identifier.data(), packIdentifierV1, 8) == 0) {
+		return 1;
+	}
+	if (memcmp(identifier.data(), packIdentifierV2, 8) == 0) {
+		return 2;
+	}
+	return 0;
+}
+
+size_t AssetPackHeader::getIndexSize() const
+{
+	return size_t(assetDbStartPos - sizeof(AssetPackHeader));
+}
+
 AssetPack::AssetPack()
 	: assetDb(std::make_unique<AssetDatabase>())
 	, hasReader(false)
@@ -42,16 +66,27 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, std::optional<
 	if (nRead != int(sizeof(header))) {
 		throw Exception("Unable to read header", HalleyExceptions::Resources);
 	}
-	if (memcmp(header.identifier.data(), "HALLEYPK", 8) != 0) {
+	const int version = header.getVersion();
+	if (version == 0) {
 		throw Exception("Asset pack is invalid (invalid identifier)", HalleyExceptions::Resources);
 	}
+	if (header.assetDbStartPos < sizeof(AssetPackHeader) || header.dataStartPos < header.assetDbStartPos || (version == 1 && header.getIndexSize() != 0)) {
+		throw Exception("Asset pack is invalid (invalid sections)", HalleyExceptions::Resources);
+	}
 	iv = header.iv;
+	const bool hasIV = std::any_of(iv.begin(), iv.end(), [] (uint8_t v) { return v != 0; });
+	streamEncrypted = version >= 2 && hasIV;
 	dataOffset = size_t(header.dataStartPos);
 
+	if (version >= 2) {
+		readIndex(header);
+	}
+
 	// Read asset database
 	{
 		const size_t assetDbSize = size_t(header.dataStartPos - header.assetDbStartPos);
 		auto assetDbBytes = Bytes(assetDbSize);
+		reader->seek(int64_t(header.assetDbStartPos), SEEK_SET);
 		nRead = reader->read(gsl::as_writable_bytes(gsl::span<Byte>(assetDbBytes)));
 		if (nRead != int(assetDbBytes.size())) {
 			throw Exception("Unable to read header", HalleyExceptions::Resources);
@@ -60,16 +95,53 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, std::optional<
 		Deserializer::fromBytes<AssetDatabase>(*assetDb, Compression::decompress(assetDbBytes));
 	}
 
-	std::array<char, 16> ivEmpty;
-	memset(ivEmpty.data(), 0, ivEmpty.size());
-	const bool hasCrypt = memcmp(iv.data(), ivEmpty.data(), iv.size()) != 0 && encryptionKey.has_value();
+	if (version == 1) {
+		// Older packs have no index, so build it once here
+		index = AssetPackIndex::fromDatabase(*assetDb);
+	}
+
+	const bool hasCrypt = hasIV && encryptionKey.has_value();
 
-	if (preLoad || hasCrypt) {
-		readToMemory();
+	if (hasCrypt && streamEncrypted) {
+		// Decrypt each asset as it's read, instead of holding the whole pack in memory
+		readKey.emplace();
+		std::copy(encryptionKey->begin(), encryptionKey->end(), readKey->begin());
+		if (preLoad) {
+			readToMemory();
+		}
+	} else {
+		if (preLoad || hasCrypt) {
+			readToMemory();
+		}
+
+		if (hasCrypt) {
+			decrypt(*encryptionKey);
+		}
 	}
 
-	if (hasCrypt) {
-		decrypt(*encryptionKey);
+	if (reader) {
+		lockFreeReader = reader->supportsReadAt();
+		const auto mapped = reader->getMappedData();
+		if (mapped.size() >= dataOffset) {
+			mappedData = mapped.subspan(dataOffset);
+		}
+	}
+}
+
+void AssetPack::readIndex(const AssetPackHeader& header)
+{
+	const size_t indexSize = header.getIndexSize();
+	const auto mapped = reader->getMappedData();
+	if (mapped.size() >= header.assetDbStartPos) {
+		// Use it in place, until the mapping goes away
+		index = AssetPackIndex::fromView(mapped.subspan(sizeof(AssetPackHeader), indexSize));
+	} else {
+		auto indexBytes = Bytes(indexSize);
+		reader->seek(int64_t(sizeof(AssetPackHeader)), SEEK_SET);
+		if (reader->read(gsl::as_writable_bytes(gsl::span<Byte>(indexBytes))) != int(indexSize)) {
+			throw Exception("Unable to read index", HalleyExceptions::Resources);
+		}
+		index = AssetPackIndex::fromBytes(std::move(indexBytes));
 	}
 }
 
@@ -85,13 +157,22 @@ AssetPack& AssetPack::operator=(AssetPack&& other) noexcept
 	std::unique_lock<std::mutex> lock(other.readerMutex);
 
 	assetDb = std::move(other.assetDb);
+	index = std::move(other.index);
 	dataOffset = other.dataOffset;
 	reader = std::move(other.reader);
 	data = std::move(other.data);
+	iv = other.iv;
+	streamEncrypted = other.streamEncrypted;
+	readKey = std::move(other.readKey);
 	hasReader = !!reader;
+	lockFreeReader = other.lockFreeReader;
+	mappedData = other.mappedData;
 
 	other.hasReader = false;
 	other.reader.reset();
+	other.lockFreeReader = false;
+	other.mappedData = {};
+	other.readKey.reset();
 
 	return *this;
 }
@@ -118,13 +199,21 @@ const Bytes& AssetPack::getData() const
 
 Bytes AssetPack::writeOut() const
 {
+	// Data that's still CBC encrypted can only go in a version 1 pack
+	const bool legacyEncrypted = !streamEncrypted && std::any_of(iv.begin(), iv.end(), [] (uint8_t v) { return v != 0; });
+	const auto indexData = legacyEncrypted ? AssetPackIndex() : AssetPackIndex::fromDatabase(*assetDb);
+	const auto indexBytes = indexData.getBytes();
+
 	auto assetDbBytes = Compression::compress(Serializer::toBytes(*assetDb));
 	AssetPackHeader header;
-	header.init(assetDbBytes.size());
+	header.init(legacyEncrypted ? 1 : 2, indexBytes.size(), assetDbBytes.size());
 	header.iv = iv;
 
 	auto result = Bytes(size_t(header.dataStartPos + data.size()));
 	memcpy(result.data(), &header, sizeof(AssetPackHeader));
+	if (!indexBytes.empty()) {
+		memcpy(result.data() + sizeof(AssetPackHeader), indexBytes.data(), indexBytes.size());
+	}
 	memcpy(result.data() + header.assetDbStartPos, assetDbBytes.data(), assetDbBytes.size());
 	memcpy(result.data() + header.dataStartPos, data.data(), data.size());
 	return result;
@@ -132,21 +221,36 @@ Bytes AssetPack::writeOut() const
 
 std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType type, bool stream)
 {
-	auto path = asset;
-	const auto* assetInfo = assetDb->getDatabase(type).tryGet(asset);
-	if (!assetInfo) {
-		return {};
+	size_t pos;
+	size_t size;
+	if (const auto* entry = index.tryGet(asset, type)) {
+		pos = size_t(entry->pos);
+		size = size_t(entry->size);
+	} else {
+		// Packs assembled in memory have no index until they're written out
+		const auto* assetInfo = index.empty() ? assetDb->getDatabase(type).tryGet(asset) : nullptr;
+		if (!assetInfo) {
+			return {};
+		}
+		auto ps = assetInfo->path.split(':');
+		pos = size_t(ps.at(0).toInteger());
+		size = size_t(ps.at(1).toInteger());
 	}
-	auto ps = assetInfo->path.split(':');
-	size_t pos = size_t(ps.at(0).toInteger());
-	size_t size = size_t(ps.at(1).toInteger());
+	auto path = asset;
 
 	if (stream) {
 		return std::make_unique<ResourceDataStream>(path, [=] () -> std::unique_ptr<ResourceDataReader> {
 			return std::make_unique<PackDataReader>(*this, pos, size);
 		});
 	} else {
-		if (hasReader) {
+		if (!mappedData.empty() && !readKey) {
+			// Zero-copy, the view keeps the reader (and so the mapping) alive
+			if (pos + size > mappedData.size()) {
+				throw Exception("Asset \"" + asset + "\" is out of pack bounds.", HalleyExceptions::Resources);
+			}
+			auto view = std::shared_ptr<const char>(reader, reinterpret_cast<const char*>(mappedData.data() + pos));
+			return std::make_unique<ResourceDataStatic>(std::move(view), size, path);
+		} else if (hasReader || readKey) {
 			auto result = new char[size];
 			try {
 				readData(pos, gsl::as_writable_bytes(gsl::span<char>(result, size)));
@@ -171,8 +275,17 @@ void AssetPack::readToMemory()
 	std::unique_lock<std::mutex> lock(readerMutex);
 	reader->seek(dataOffset, SEEK_SET);
 	data = reader->readAll();
+	index.makeOwned();
 	hasReader = false;
+	lockFreeReader = false;
+	mappedData = {};
 	reader.reset();
+
+	if (readKey) {
+		Encrypt::applyAESCTR(iv, *readKey, 0, gsl::as_writable_bytes(gsl::span<Byte>(data)));
+		streamEncrypted = false;
+		readKey.reset();
+	}
 }
 
 void AssetPack::encrypt(Encrypt::AESKey key)
@@ -180,21 +293,54 @@ void AssetPack::encrypt(Encrypt::AESKey key)
 	// Generate IV
 	Random::getGlobal().getBytes(gsl::as_writable_bytes(gsl::span<uint8_t>(iv)));
 
-	data = Encrypt::encryptAES(iv, key, data);
+	Encrypt::applyAESCTR(iv, key, 0, gsl::as_writable_bytes(gsl::span<Byte>(data)));
+	streamEncrypted = true;
 }
 
 void AssetPack::decrypt(Encrypt::AESKey key)
 {
-	data = Encrypt::decryptAES(iv, key, data);
+	if (streamEncrypted) {
+		Encrypt::applyAESCTR(iv, key, 0, gsl::as_writable_bytes(gsl::span<Byte>(data)));
+		streamEncrypted = false;
+	} else {
+		data = Encrypt::decryptAES(iv, key, data);
+	}
+	readKey.reset();
+	memset(iv.data(), 0, iv.size());
 }
 
 void AssetPack::readData(size_t pos, gsl::span<gsl::byte> dst)
 {
+	readRawData(pos, dst);
+	if (readKey) {
+		Encrypt::applyAESCTR(iv, *readKey, pos, dst);
+	}
+}
+
+void AssetPack::readRawData(size_t pos, gsl::span<gsl::byte> dst)
+{
+	if (!mappedData.empty()) {
+		if (pos + size_t(dst.size()) > mappedData.size()) {
+			throw Exception("Asset data is out of pack bounds.", HalleyExceptions::Resources);
+		}
+		memcpy(dst.data(), mappedData.data() + pos, dst.size());
+		return;
+	}
+
+	if (lockFreeReader) {
+		if (reader->readAt(pos + dataOffset, dst) != int(dst.size())) {
+			throw Exception("Unable to read asset data from pack.", HalleyExceptions::Resources);
+		}
+		return;
+	}
+
 	if (hasReader) {
 		std::unique_lock<std::mutex> lock(readerMutex);
 		if (reader) {
 			reader->seek(pos + dataOffset, SEEK_SET);
-			reader->read(dst);
+			if (reader->read(dst) != int(dst.size())) {
+				throw Exception("Unable to read asset data from pack.", HalleyExceptions::Resources);
+			}
 			return;
 		}
 	}
@@ -206,10 +352,13 @@ void AssetPack::readData(size_t pos, gsl::span<gsl::byte> dst)
 	memcpy(dst.data(), data.data() + pos, dst.size());
 }
 
-std::unique_ptr<ResourceDataReader> AssetPack::extractReader()
+std::shared_ptr<ResourceDataReader> AssetPack::extractReader()
 {
 	std::unique_lock<std::mutex> lock(readerMutex);
 	hasReader = false;
+	lockFreeReader = false;
+	mappedData = {};
+	index.makeOwned();
 	return std::move(reader);
 }
 
@@ -223,7 +372,7 @@ std::shared_ptr<bool> AssetPack::getAliveToken() const
 
 size_t AssetPack::getMemoryUsage() const
 {
-	return sizeof(*this) + data.size() + assetDb->getMemoryUsage();
+	return sizeof(*this) + data.size() + assetDb->getMemoryUsage() + index.getMemoryUsage();
 }
 
 PackDataReader::PackDataReader(AssetPack& pack, size_t startPos, size_t fileSize)
@@ -0,0 +1,155 @@
+#include "halley/resources/asset_pack_index.h"
+#include "halley/resources/asset_database.h"
+#include "halley/resources/resource.h"
+#include "halley/support/exception.h"
+#include "halley/utils/hash.h"
+
+using namespace Halley;
+
+AssetPackIndex AssetPackIndex::fromDatabase(const AssetDatabase& db)
+{
+	Vector<Entry> entries;
+	String names;
+	for (const auto& type: db.getTypes()) {
+		for (const auto& [name, asset]: db.getDatabase(type).getAssets()) {
+			const auto ps = asset.path.split(':');
+			if (ps.size() != 2) {
+				throw Exception("Invalid pack asset location \"" + asset.path + "\" for " + name, HalleyExceptions::Resources);
+			}
+
+			Entry& entry = entries.emplace_back();
+			entry.nameHash = hashName(name);
+			entry.pos = uint64_t(ps[0].toInteger64());
+			entry.size = uint64_t(ps[1].toInteger64());
+			entry.nameOffset = uint32_t(names.size());
+			entry.nameLength = uint32_t(name.size());
+			entry.type = int32_t(type);
+			entry.padding = {};
+			names += name;
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(), [] (const Entry& a, const Entry& b)
+	{
+		return std::tie(a.nameHash, a.type) < std::tie(b.nameHash, b.type);
+	});
+
+	Header header;
+	header.numEntries = uint32_t(entries.size());
+	header.namesSize = uint32_t(names.size());
+
+	const size_t entriesSize = entries.size() * sizeof(Entry);
+	Bytes data(sizeof(Header) + entriesSize + names.size());
+	memcpy(data.data(), &header, sizeof(Header));
+	if (!entries.empty()) {
+		memcpy(data.data() + sizeof(Header), entries.data(), entriesSize);
+	}
+	if (!names.isEmpty()) {
+		memcpy(data.data() + sizeof(Header) + entriesSize, names.c_str(), names.size());
+	}
+
+	return fromBytes(std::move(data));
+}
+
+AssetPackIndex AssetPackIndex::fromView(gsl::span<const gsl::byte> data)
+{
+	AssetPackIndex result;
+	result.setView(data);
+	return result;
+}
+
+AssetPackIndex AssetPackIndex::fromBytes(Bytes data)
+{
+	AssetPackIndex result;
+	result.ownedData = std::move(data);
+	result.setView(gsl::as_bytes(gsl::span<const Byte>(result.ownedData)));
+	return result;
+}
+
+void AssetPackIndex::setView(gsl::span<const gsl::byte> data)
+{
+	if (data.size() < sizeof(Header)) {
+		throw Exception("Asset pack index is invalid (too small)", HalleyExceptions::Resources);
+	}
+	if (reinterpret_cast<uintptr_t>(data.data()) % alignof(Entry) != 0) {
+		throw Exception("Asset pack index is invalid (misaligned)", HalleyExceptions::Resources);
+	}
+
+	Header header;
+	memcpy(&header, data.data(), sizeof(Header));
+	const size_t entriesSize = size_t(header.numEntries) * sizeof(Entry);
+	if (sizeof(Header) + entriesSize + header.namesSize != size_t(data.size())) {
+		throw Exception("Asset pack index is invalid (wrong size)", HalleyExceptions::Resources);
+	}
+
+	entries = gsl::span<const Entry>(reinterpret_cast<const Entry*>(data.data() + sizeof(Header)), header.numEntries);
+	names = std::string_view(reinterpret_cast<const char*>(data.data() + sizeof(Header) + entriesSize), header.namesSize);
+
+	for (const auto& e: entries) {
+		if (size_t(e.nameOffset) + e.nameLength > names.size()) {
+			throw Exception("Asset pack index is invalid (name out of bounds)", HalleyExceptions::Resources);
+		}
+	}
+}
+
+void AssetPackIndex::makeOwned()
+{
+	const auto bytes = getBytes();
+	if (!ownedData.empty() || bytes.empty()) {
+		return;
+	}
+	ownedData = Bytes(reinterpret_cast<const Byte*>(bytes.data()), reinterpret_cast<const Byte*>(bytes.data()) + bytes.size());
+	setView(gsl::as_bytes(gsl::span<const Byte>(ownedData)));
+}
+
+const AssetPackIndex::Entry* AssetPackIndex::tryGet(std::string_view name, AssetType type) const
+{
+	const auto hash = hashName(name);
+	const auto t = int32_t(type);
+
+	auto iter = std::lower_bound(entries.begin(), entries.end(), std::make_pair(hash, t), [] (const Entry& e, const std::pair<uint64_t, int32_t>& key)
+	{
+		return std::tie(e.nameHash, e.type) < std::tie(key.first, key.second);
+	});
+
+	// Check names too, in case of hash collisions
+	for (; iter != entries.end() && iter->nameHash == hash && iter->type == t; ++iter) {
+		if (getName(*iter) == name) {
+			return &*iter;
+		}
+	}
+	return nullptr;
+}
+
+std::string_view AssetPackIndex::getName(const Entry& entry) const
+{
+	return names.substr(entry.nameOffset, entry.nameLength);
+}
+
+size_t AssetPackIndex::size() const
+{
+	return entries.size();
+}
+
+bool AssetPackIndex::empty() const
+{
+	return entries.empty();
+}
+
+gsl::span<const gsl::byte> AssetPackIndex::getBytes() const
+{
+	if (entries.empty() && names.empty()) {
+		return {};
+	}
+	return gsl::span<const gsl::byte>(reinterpret_cast<const gsl::byte*>(entries.data()) - sizeof(Header), sizeof(Header) + entries.size_bytes() + names.size());
+}
+
+size_t AssetPackIndex::getMemoryUsage() const
+{
+	return ownedData.size();
+}
+
+uint64_t AssetPackIndex::hashName(std::string_view name)
+{
+	return Hash::hash(gsl::as_bytes(gsl::span<const char>(name.data(), name.size())));
+}
@@ -7,8 +7,29 @@
 #include "halley/api/halley_api.h"
 #include "halley/support/profiler.h"
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace Halley;
 
+int ResourceDataReader::readAt(size_t pos, gsl::span<gsl::byte> dst)
+{
+	throw Exception("This reader doesn't support reading at arbitrary positions.", HalleyExceptions::Resources);
+}
+
 Bytes ResourceDataReader::readAll()
 {
 	Bytes result(size() - tell());
@@ -86,6 +107,321 @@ void ResourceDataReaderFileSystem::close()
 }
 
 
+std::unique_ptr<ResourceDataReaderMappedFile> ResourceDataReaderMappedFile::tryOpen(const Path& path)
+{
+	auto result = std::unique_ptr<ResourceDataReaderMappedFile>(new ResourceDataReaderMappedFile());
+	if (!result->open(path)) {
+		return {};
+	}
+	return result;
+}
+
+ResourceDataReaderMappedFile::~ResourceDataReaderMappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool ResourceDataReaderMappedFile::open(const Path& path)
+{
+	// Don't lock the file against other readers, or against being renamed over
+	// Windows still refuses to truncate or replace a file while a view of it is mapped, so the packer can only replace this pack once it's closed
+	auto handle = CreateFileW(path.getNativeString().getUTF16().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	fileHandle = handle;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size)) {
+		close();
+		return false;
+	}
+	fileSize = static_cast<size_t>(size.QuadPart);
+
+	if (fileSize > 0) {
+		mappingHandle = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle) {
+			mapped = static_cast<const gsl::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+	return true;
+}
+
+void ResourceDataReaderMappedFile::close()
+{
+	if (mapped) {
+		UnmapViewOfFile(mapped);
+		mapped = nullptr;
+	}
+	if (mappingHandle) {
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	if (fileHandle) {
+		CloseHandle(fileHandle);
+		fileHandle = nullptr;
+	}
+}
+
+bool ResourceDataReaderMappedFile::isAvailable() const
+{
+	return fileHandle != nullptr;
+}
+
+int ResourceDataReaderMappedFile::readAt(size_t pos, gsl::span<gsl::byte> dst)
+{
+	const size_t toRead = pos < fileSize ? std::min(fileSize - pos, static_cast<size_t>(dst.size())) : 0;
+	if (toRead == 0) {
+		return 0;
+	}
+	if (mapped) {
+		memcpy(dst.data(), mapped + pos, toRead);
+		return static_cast<int>(toRead);
+	}
+	if (!fileHandle) {
+		return 0;
+	}
+
+	// An explicit offset makes the read independent of the handle's file pointer, so it's safe from several threads
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = static_cast<DWORD>(pos & 0xFFFFFFFFull);
+	overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(pos) >> 32);
+	DWORD nRead = 0;
+	if (!ReadFile(fileHandle, dst.data(), static_cast<DWORD>(toRead), &nRead, &overlapped)) {
+		return 0;
+	}
+	return static_cast<int>(nRead);
+}
+
+#elif defined(HAS_MMAP)
+
+bool ResourceDataReaderMappedFile::open(const Path& path)
+{
+	fd = ::open(path.getNativeString().c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close();
+		return false;
+	}
+	fileSize = static_cast<size_t>(st.st_size);
+
+	if (fileSize > 0) {
+		void* result = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (result != MAP_FAILED) {
+			mapped = static_cast<const gsl::byte*>(result);
+		}
+	}
+	return true;
+}
+
+void ResourceDataReaderMappedFile::close()
+{
+	if (mapped) {
+		munmap(const_cast<gsl::byte*>(mapped), fileSize);
+		mapped = nullptr;
+	}
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	}
+}
+
+bool ResourceDataReaderMappedFile::isAvailable() const
+{
+	return fd >= 0;
+}
+
+int ResourceDataReaderMappedFile::readAt(size_t pos, gsl::span<gsl::byte> dst)
+{
+	const size_t toRead = pos < fileSize ? std::min(fileSize - pos, static_cast<size_t>(dst.size())) : 0;
+	if (toRead == 0) {
+		return 0;
+	}
+	if (mapped) {
+		memcpy(dst.data(), mapped + pos, toRead);
+		return static_cast<int>(toRead);
+	}
+	if (fd < 0) {
+		return 0;
+	}
+
+	size_t done = 0;
+	while (done < toRead) {
+		const auto n = pread(fd, dst.data() + done, toRead - done, static_cast<off_t>(pos + done));
+		if (n <= 0) {
+			break;
+		}
+		done += static_cast<size_t>(n);
+	}
+	return static_cast<int>(done);
+}
+
+#else
+
+bool ResourceDataReaderMappedFile::open(const Path& path)
+{
+	return false;
+}
+
+void ResourceDataReaderMappedFile::close()
+{
+}
+
+bool ResourceDataReaderMappedFile::isAvailable() const
+{
+	return false;
+}
+
+int ResourceDataReaderMappedFile::readAt(size_t pos, gsl::span<gsl::byte> dst)
+{
+	return 0;
+}
+
+#endif
+
+size_t ResourceDataReaderMappedFile::size() const
+{
+	return fileSize;
+}
+
+int ResourceDataReaderMappedFile::read(gsl::span<gsl::byte> dst)
+{
+	const int n = readAt(curPos, dst);
+	curPos += static_cast<size_t>(n);
+	return n;
+}
+
+void ResourceDataReaderMappedFile::seek(int64_t pos, int whence)
+{
+	switch (whence) {
+	case SEEK_SET:
+		curPos = static_cast<size_t>(pos);
+		break;
+	case SEEK_CUR:
+		curPos = static_cast<size_t>(curPos + pos);
+		break;
+	case SEEK_END:
+		curPos = static_cast<size_t>(fileSize + pos);
+		break;
+	}
+}
+
+size_t ResourceDataReaderMappedFile::tell() const
+{
+	return curPos;
+}
+
+bool ResourceDataReaderMappedFile::supportsReadAt() const
+{
+	return isAvailable();
+}
+
+gsl::span<const gsl::byte> ResourceDataReaderMappedFile::getMappedData() const
+{
+	return mapped ? gsl::span<const gsl::byte>(mapped, fileSize) : gsl::span<const gsl::byte>();
+}
+
+ResourceDataReaderLZ4Chunked::ResourceDataReaderLZ4Chunked(std::unique_ptr<ResourceDataReader> _src)
+	: src(std::move(_src))
+{
+	std::array<gsl::byte, sizeof(Compression::LZ4ChunkedHeader)> headerBytes;
+	src->seek(0, SEEK_SET);
+	if (src->read(headerBytes) != int(headerBytes.size())) {
+		throw Exception("Unable to read chunked LZ4 header", HalleyExceptions::Resources);
+	}
+	const auto h = Compression::readLZ4ChunkedHeader(headerBytes);
+	if (!h) {
+		throw Exception("Stream is not chunked LZ4", HalleyExceptions::Resources);
+	}
+	header = *h;
+
+	chunkEnds.resize(header.getNumChunks());
+	if (src->read(gsl::as_writable_bytes(chunkEnds.span())) != int(header.getTableSize())) {
+		throw Exception("Unable to read chunked LZ4 table", HalleyExceptions::Resources);
+	}
+	dataStart = sizeof(Compression::LZ4ChunkedHeader) + header.getTableSize();
+}
+
+size_t ResourceDataReaderLZ4Chunked::size() const
+{
+	return size_t(header.size);
+}
+
+int ResourceDataReaderLZ4Chunked::read(gsl::span<gsl::byte> dst)
+{
+	size_t nRead = 0;
+	while (nRead < size_t(dst.size()) && curPos < size()) {
+		const size_t idx = curPos / header.chunkSize;
+		if (chunkIdx != idx) {
+			loadChunk(idx);
+		}
+
+		const size_t offset = curPos - idx * header.chunkSize;
+		const size_t n = std::min(size_t(dst.size()) - nRead, chunk.size() - offset);
+		memcpy(dst.data() + nRead, chunk.data() + offset, n);
+		nRead += n;
+		curPos += n;
+	}
+	return int(nRead);
+}
+
+void ResourceDataReaderLZ4Chunked::seek(int64_t pos, int whence)
+{
+	switch (whence) {
+	case SEEK_SET:
+		curPos = static_cast<size_t>(pos);
+		break;
+	case SEEK_CUR:
+		curPos = static_cast<size_t>(curPos + pos);
+		break;
+	case SEEK_END:
+		curPos = static_cast<size_t>(size() + pos);
+		break;
+	}
+}
+
+size_t ResourceDataReaderLZ4Chunked::tell() const
+{
+	return curPos;
+}
+
+void ResourceDataReaderLZ4Chunked::close()
+{
+	src->close();
+	chunk.clear();
+	chunkIdx = std::nullopt;
+}
+
+bool ResourceDataReaderLZ4Chunked::isAvailable() const
+{
+	return src->isAvailable();
+}
+
+void ResourceDataReaderLZ4Chunked::loadChunk(size_t idx)
+{
+	const uint64_t start = idx > 0 ? chunkEnds[idx - 1] : 0;
+	const uint64_t end = chunkEnds[idx];
+	if (start > end) {
+		throw Exception("Chunked LZ4 table is invalid", HalleyExceptions::Resources);
+	}
+
+	compressed.resize(size_t(end - start));
+	src->seek(int64_t(dataStart + start), SEEK_SET);
+	if (src->read(compressed.byte_span()) != int(compressed.size())) {
+		throw Exception("Unable to read chunked LZ4 chunk", HalleyExceptions::Resources);
+	}
+
+	chunk.resize(header.getChunkSize(idx));
+	Compression::lz4DecompressChunk(header, idx, compressed.byte_span(), chunk.byte_span());
+	chunkIdx = idx;
+}
+
 ResourceData::ResourceData(String p)
 	: path(p)
 {
@@ -104,6 +440,14 @@ ResourceDataStatic::ResourceDataStatic(const void* _data, size_t _size, String p
 	set(_data, _size, owning);
 }
 
+ResourceDataStatic::ResourceDataStatic(std::shared_ptr<const char> _data, size_t _size, String path)
+	: ResourceData(path)
+	, data(std::move(_data))
+	, size(_size)
+	, loaded(true)
+{
+}
+
 static void deleter(const char* data)
 {
 	delete[] data;
@@ -152,9 +496,9 @@ void ResourceDataStatic::inflate()
 	data = Compression::decompressToSharedPtr(getSpan(), size);
 }
 
-void ResourceDataStatic::lz4Decompress()
+void ResourceDataStatic::lz4Decompress(ExecutionQueue* queue)
 {
-	data = Compression::lz4DecompressFileToSharedPtr(getSpan(), {}, size);
+	data = Compression::lz4DecompressAnyToSharedPtr(getSpan(), size, queue);
 }
 
 std::unique_ptr<ResourceDataStatic> ResourceDataStatic::loadFromFileSystem(Path path)
@@ -241,6 +585,14 @@ std::unique_ptr<ResourceDataStream> ResourceLoader::getStream(bool throwOnFail)
 {
 	auto result = locator.getStream(name, type, throwOnFail);
 	if (result) {
+		if (metadata && metadata->getString("asset_compression", "") == "lz4") {
+			// Decompress as it's streamed
+			std::shared_ptr<ResourceDataStream> compressed = std::move(result);
+			result = std::make_unique<ResourceDataStream>(compressed->getPath(), [compressed] () -> std::unique_ptr<ResourceDataReader>
+			{
+				return std::make_unique<ResourceDataReaderLZ4Chunked>(compressed->getReader());
+			});
+		}
 		loaded = true;
 	}
 	return result;
@@ -252,14 +604,26 @@ Future<std::unique_ptr<ResourceDataStatic>> ResourceLoader::getAsync(bool throwO
 	auto n = name;
 	auto t = type;
 	auto meta = getMeta();
-	return Concurrent::execute(Executors::getDiskIO(), [meta, loc, n, t, throwOnFail] () -> std::unique_ptr<ResourceDataStatic>
+	const auto compression = meta.getString("asset_compression", "");
+
+	auto read = Concurrent::execute(Executors::getDiskIO(), [loc, n, t, throwOnFail] () -> std::unique_ptr<ResourceDataStatic>
 	{
 		ProfilerEvent event(ProfilerEventType::DiskIO);
-		auto result = loc.get().getStatic(n, t, throwOnFail);
-		if (meta.getString("asset_compression", "") == "lz4") {
-			result->lz4Decompress();
-		} else if (meta.getString("asset_compression", "") == "deflate") {
-			result->inflate();
+		return loc.get().getStatic(n, t, throwOnFail);
+	});
+	if (compression != "lz4" && compression != "deflate") {
+		return read;
+	}
+
+	// Decompress on the CPU pool, so the disk thread can move on to the next read
+	return read.then(Executors::getCPU(), [compression] (std::unique_ptr<ResourceDataStatic> result) -> std::unique_ptr<ResourceDataStatic>
+	{
+		if (result) {
+			if (compression == "lz4") {
+				result->lz4Decompress(&Executors::getCPU());
+			} else {
+				result->inflate();
+			}
 		}
 		return result;
 	});
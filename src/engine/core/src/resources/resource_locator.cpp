@@ -133,7 +133,7 @@ void ResourceLocator::addFileSystem(const Path& path, IFileSystemCache* cache)
 
 void ResourceLocator::addPack(const Path& path, std::optional<Encrypt::AESKey> encryptionKey, bool preLoad, bool allowFailure, std::optional<int> priority)
 {
-	auto dataReader = system.getDataReader(path.string());
+	auto dataReader = PackResourceLocator::openReader(system, path, encryptionKey.has_value(), preLoad);
 	if (dataReader) {
 		auto resourceLocator = std::make_unique<PackResourceLocator>(std::move(dataReader), path, encryptionKey, preLoad, priority);
 		add(std::move(resourceLocator), path);
@@ -18,6 +18,16 @@ PackResourceLocator::~PackResourceLocator()
 {
 }
 
+std::unique_ptr<ResourceDataReader> PackResourceLocator::openReader(SystemAPI& system, const Path& path, bool encrypted, bool preLoad)
+{
+	if (!encrypted && !preLoad) {
+		if (auto reader = ResourceDataReaderMappedFile::tryOpen(path)) {
+			return reader;
+		}
+	}
+	return system.getDataReader(path.string());
+}
+
 std::unique_ptr<ResourceData> PackResourceLocator::getData(const String& asset, AssetType type, bool stream)
 {
 	if (!assetPack) {
@@ -57,7 +67,7 @@ void PackResourceLocator::loadAfterPurge()
 	if (wasEncrypted) {
 		throw Exception("Attempting to hot reload a pack, but key has been lost.", HalleyExceptions::Resources);
 	}
-	assetPack = std::make_unique<AssetPack>(system->getDataReader(path.string()), std::nullopt, preLoad);
+	assetPack = std::make_unique<AssetPack>(openReader(*system, path, false, preLoad), std::nullopt, preLoad);
 }
 
 int PackResourceLocator::getPriority() const
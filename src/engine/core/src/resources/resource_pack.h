@@ -13,6 +13,9 @@ namespace Halley {
 		explicit PackResourceLocator(std::unique_ptr<ResourceDataReader> reader, Path path, std::optional<Encrypt::AESKey> encryptionKey = std::nullopt, bool preLoad = false, std::optional<int> priority = {});
 		~PackResourceLocator();
 
+		// Packs that are neither encrypted nor preloaded are memory mapped when possible, so assets can be read from several threads without locking
+		static std::unique_ptr<ResourceDataReader> openReader(SystemAPI& system, const Path& path, bool encrypted, bool preLoad);
+
 	protected:
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream) override;
 		const AssetDatabase& getAssetDatabase() override;
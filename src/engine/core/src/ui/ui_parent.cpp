@@ -1,4 +1,5 @@
 #include "halley/ui/ui_parent.h"
+#include "halley/ui/ui_root.h"
 #include "halley/ui/ui_widget.h"
 #include "halley/support/logger.h"
 using namespace Halley;
@@ -71,6 +72,9 @@ bool UIParent::addNewChildren(UIInputType inputType)
 	}
 	childrenWaiting.clear();
 
+	if (auto* root = getRoot()) {
+		root->onHierarchyChanged();
+	}
 	markAsNeedingLayout();
 	onChildrenAdded();
 	return true;
@@ -106,6 +110,8 @@ bool UIParent::isWaitingToSpawnChildren() const
 
 void UIParent::markAsNeedingLayout() {}
 
+void UIParent::markLayoutDirty() {}
+
 Vector<std::shared_ptr<UIWidget>>& UIParent::getChildren()
 {
 	/*
@@ -72,18 +72,28 @@ void UIRoot::runLayout()
 
 void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType)
 {
-	widgetsCache.clear();
-	for (auto& c: getChildren()) {
-		assert(c->getRoot() == this);
-		widgetsCache.push_back(c);
+	// If the hierarchy hasn't changed, the widgets to update are the same as last time
+	bool collecting = widgetsCacheDirty;
+	widgetsCacheDirty = false;
+	if (collecting) {
+		widgetsCache.clear();
+		widgetsCacheChildrenStart.clear();
+		for (auto& c: getChildren()) {
+			assert(c->getRoot() == this);
+			widgetsCache.push_back(c.get());
+		}
 	}
 
+	updatingWidgets = true;
 	for (size_t i = 0; i < widgetsCache.size(); ++i) {
-		auto& w = widgetsCache[i];
-		if (w->getParent() && w->getParent()->isGuardedUpdate()) {
+		auto* w = widgetsCache[i];
+		bool updateChildren = false;
+		if (w->getRoot() != this) {
+			// Removed earlier in this update
+		} else if (w->getParent() && w->getParent()->isGuardedUpdate()) {
 			bool crashed = false;
 			try {
-				w->doUpdate(type, t, activeInputType, joystickType, widgetsCache);
+				updateChildren = w->doUpdate(type, t, activeInputType, joystickType);
 			} catch (const std::exception& e) {
 				Logger::logException(e);
 				crashed = true;
@@ -92,21 +102,36 @@ void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeIn
 			}
 
 			if (crashed) {
+				updateChildren = false;
 				w->clear();
 			}
 		} else {
-			assert(w->getRoot() == this);
-			w->doUpdate(type, t, activeInputType, joystickType, widgetsCache);
+			updateChildren = w->doUpdate(type, t, activeInputType, joystickType);
+		}
+
+		if (!collecting && widgetsCacheDirty) {
+			// Everything listed so far was collected before this change, so only the rest needs collecting again
+			widgetsCache.resize(widgetsCacheChildrenStart[i]);
+			widgetsCacheChildrenStart.resize(i);
+			collecting = true;
+		}
+		if (collecting) {
+			widgetsCacheChildrenStart.push_back(widgetsCache.size());
+			if (updateChildren) {
+				w->collectWidgetsForUpdating(widgetsCache);
+			}
 		}
 	}
 
 	for (int i = static_cast<int>(widgetsCache.size()); --i >= 0; ) {
-		auto& w = widgetsCache[i];
-		assert(w->getRoot() == this);
-		w->doPostUpdate();
+		auto* w = widgetsCache[i];
+		if (w->getRoot() == this) {
+			w->doPostUpdate();
+		}
 	}
 
-	widgetsCache.clear();
+	updatingWidgets = false;
+	removedWidgets.clear();
 }
 
 void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, spInputDevice manual)
@@ -707,6 +732,24 @@ void UIRoot::onWidgetRemoved(const UIWidget& widget)
 	if (focus && focus.get() == &widget) {
 		currentFocus.reset();
 	}
+
+	onHierarchyChanged();
+	if (updatingWidgets) {
+		if (auto w = widget.weak_from_this().lock()) {
+			removedWidgets.push_back(std::move(w));
+		}
+	}
+}
+
+void UIRoot::onHierarchyChanged()
+{
+	widgetsCacheDirty = true;
+	renderDataDirty = true;
+}
+
+void UIRoot::onRenderListChanged()
+{
+	renderDataDirty = true;
 }
 
 Vector<std::shared_ptr<UIWidget>> UIRoot::collectWidgets()
@@ -746,19 +789,29 @@ void UIRoot::draw(SpritePainter& painter, int mask, int layer)
 
 void UIRoot::prepareRender()
 {
-	auto& data = BaseFrameData::getCurrentBase().uiRootData[this];
-	data.renderRoots.clear();
-	data.renderRoots.push_back({});
-	data.renderWidgets.clear();
+	if (renderDataDirty || !renderData) {
+		renderDataDirty = false;
+		if (!renderData || renderData.use_count() > 1) {
+			// The previous list might still be in use by a frame being rendered
+			renderData = std::make_shared<UIRootFrameData>();
+		}
 
-	for (auto& c: getChildren()) {
-		c->collectWidgetsForRendering(0, data.renderWidgets, data.renderRoots);
+		auto& data = *renderData;
+		data.renderRoots.clear();
+		data.renderRoots.push_back({});
+		data.renderWidgets.clear();
+
+		for (auto& c: getChildren()) {
+			c->collectWidgetsForRendering(0, data.renderWidgets, data.renderRoots);
+		}
 	}
+
+	BaseFrameData::getCurrentBase().uiRootData[this] = renderData;
 }
 
 void UIRoot::render(RenderContext& origRC)
 {
-	const auto& data = BaseFrameData::getCurrentBase().uiRootData.at(this);
+	const auto& data = *BaseFrameData::getCurrentBase().uiRootData.at(this);
 
 	for (auto& [w, rcIdx] : data.renderWidgets) {
 		w->onPreRender();
@@ -1,4 +1,5 @@
 #include "halley/ui/ui_sizer.h"
+#include "halley/ui/ui_root.h"
 #include "halley/ui/ui_widget.h"
 
 using namespace Halley;
@@ -189,6 +190,7 @@ void UISizer::add(std::shared_ptr<IUIElement> element, float proportion, Vector4
 {
 	entries.emplace(entries.begin() + std::min(entries.size(), insertPos), UISizerEntry(element, proportion, border, fillFlags));
 	reparentEntry(entries.back());
+	markParentAsNeedingLayout();
 }
 
 void UISizer::addSpacer(float size)
@@ -205,6 +207,7 @@ void UISizer::addStretchSpacer(float proportion)
 void UISizer::remove(IUIElement& element)
 {
 	entries.erase(std::remove_if(entries.begin(), entries.end(), [&] (const UISizerEntry& e) { return e.getPointer().get() == &element; }), entries.end());
+	markParentAsNeedingLayout();
 }
 
 void UISizer::reparent(UIParent& parent)
@@ -265,12 +268,15 @@ const UISizerEntry& UISizer::operator[](size_t n) const
 
 UISizerEntry& UISizer::operator[](size_t n)
 {
+	// The caller might change the entry's border or proportion
+	markParentAsNeedingLayout();
 	return entries[n];
 }
 
 UISizerEntry* UISizer::tryGetEntry(IUIElement* element)
 {
 	if (const auto idx = getEntryIdx(element)) {
+		markParentAsNeedingLayout();
 		return &entries[*idx];
 	}
 	return nullptr;
@@ -315,6 +321,7 @@ void UISizer::updateEnabled() const
 void UISizer::swapItems(int idxA, int idxB)
 {
 	std::swap(entries[idxA], entries[idxB]);
+	markParentAsNeedingLayout();
 }
 
 void UISizer::clear()
@@ -331,6 +338,7 @@ void UISizer::clear()
 		}
 	}
 	entries.clear();
+	markParentAsNeedingLayout();
 }
 
 bool UISizer::isActive() const
@@ -348,6 +356,7 @@ void UISizer::setColumnProportions(const Vector<float>& values)
 	if (gridProportions) {
 		gridProportions->columnProportions = values;
 		gridProportions->columnProportions.resize(gridProportions->nColumns, 0);
+		markParentAsNeedingLayout();
 	}
 }
 
@@ -358,6 +367,7 @@ void UISizer::setEvenColumns()
 		for (auto& c: gridProportions->columnProportions) {
 			c = 1.0f;
 		}
+		markParentAsNeedingLayout();
 	}
 }
 
@@ -366,6 +376,7 @@ void UISizer::setRowProportions(const Vector<float>& values)
 {
 	if (gridProportions) {
 		gridProportions->rowProportions = values;
+		markParentAsNeedingLayout();
 	}
 }
 
@@ -697,5 +708,17 @@ void UISizer::sortChildrenBySizerOrder()
 		for (size_t i = 0; i < children.size(); ++i) {
 			children[i] = std::dynamic_pointer_cast<UIWidget>(entries[i].getPointer());
 		}
+		if (auto* root = curParent->getRoot()) {
+			root->onHierarchyChanged();
+		}
+	}
+	markParentAsNeedingLayout();
+}
+
+void UISizer::markParentAsNeedingLayout()
+{
+	// Layout is only redone where it was invalidated, so the owner needs to know the entries changed
+	if (curParent) {
+		curParent->markAsNeedingLayout();
 	}
 }
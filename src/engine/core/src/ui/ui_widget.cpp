@@ -59,7 +59,7 @@ void UIWidget::doDraw(UIPainter& painter) const
 	drawAfterChildren(painter);
 }
 
-void UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<std::shared_ptr<UIWidget>>& dst)
+bool UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType)
 {
 	if (updateType == UIWidgetUpdateType::Full || updateType == UIWidgetUpdateType::First) {
 		setInputType(inputType);
@@ -87,10 +87,10 @@ void UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType input
 
 		addNewChildren(inputType);
 
-		if (isActive()) {
-			collectWidgetsForUpdating(dst);
-		}
+		// Children are only updated if this is still active
+		return isActive();
 	}
+	return false;
 }
 
 void UIWidget::doPostUpdate()
@@ -112,11 +112,11 @@ void UIWidget::removeSizerDeadChildren()
 	}
 }
 
-void UIWidget::collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst)
+void UIWidget::collectWidgetsForUpdating(Vector<UIWidget*>& dst)
 {
 	for (auto& c: getChildren()) {
 		assert(c->getRoot() == getRoot());
-		dst.push_back(c);
+		dst.push_back(c.get());
 	}
 }
 
@@ -156,10 +156,20 @@ Vector2f UIWidget::getLayoutMinimumSize(bool force) const
 void UIWidget::setRect(Rect4f rect, IUIElementListener* listener)
 {
 	setWidgetRect(rect);
+
+	// If nothing below was invalidated and the area for the children didn't move, their layout is still valid
+	const auto p0 = getLayoutOriginPosition();
+	const auto size = getLayoutSize(rect.getSize());
+	const auto area = Rect4f(p0, p0 + size);
+	if (!layoutDirty && !listener && rect == lastLayoutRect && area == lastLayoutArea) {
+		return;
+	}
+	layoutDirty = false;
+	lastLayoutRect = rect;
+	lastLayoutArea = area;
+
 	if (sizer) {
 		const auto border = getInnerBorder();
-		const auto p0 = getLayoutOriginPosition();
-		const auto size = getLayoutSize(rect.getSize());
 		if (listener) {
 			onPreNotifySetRect(*listener);
 		}
@@ -246,6 +256,7 @@ void UIWidget::setSizer(std::optional<UISizer> sizer)
 	if (this->sizer) {
 		this->sizer->reparent(*this);
 	}
+	markAsNeedingLayout();
 }
 
 void UIWidget::add(std::shared_ptr<IUIElement> element, float proportion, Vector4f border, int fillFlags, size_t insertPos)
@@ -409,7 +420,10 @@ void UIWidget::setPosition(Vector2f pos)
 {
 	Expects(pos.isValid());
 	
-	position = pos;
+	if (position != pos) {
+		position = pos;
+		markLayoutDirty();
+	}
 	positionUpdated = true;
 }
 
@@ -419,7 +433,6 @@ void UIWidget::setBorder(Vector4f border)
 		if (auto& parentSizer = parentWidget->tryGetSizer()) {
 			if (auto* entry = parentSizer->tryGetEntry(this)) {
 				entry->setBorder(border);
-				parentWidget->markAsNeedingLayout();
 			}
 		}
 	}
@@ -505,6 +518,9 @@ void UIWidget::updateActive(bool wasActiveBefore)
 
 		markAsNeedingLayout();
 		notifyActivationChange(isActive());
+		if (root) {
+			root->onHierarchyChanged();
+		}
 	}
 }
 
@@ -620,6 +636,7 @@ void UIWidget::forceLayout()
 {
 	Expects (lastInputType != UIInputType::Undefined);
 	forceAddChildren(lastInputType, true);
+	markAsNeedingLayout();
 	layout();
 }
 
@@ -1050,6 +1067,7 @@ bool UIWidget::needsLayout() const
 void UIWidget::markAsNeedingLayout()
 {
 	layoutNeeded = 1;
+	layoutDirty = true;
 	if (parent) {
 		parent->markAsNeedingLayout();
 	}
@@ -1058,6 +1076,15 @@ void UIWidget::markAsNeedingLayout()
 	}
 }
 
+void UIWidget::markLayoutDirty()
+{
+	// Keeps the cached minimum sizes, only makes sure layout reaches this widget again
+	layoutDirty = true;
+	if (parent) {
+		parent->markLayoutDirty();
+	}
+}
+
 bool UIWidget::canReceiveFocus() const
 {
 	return false;
@@ -3,6 +3,7 @@
 #include "halley/api/halley_api.h"
 #include "halley/graphics/render_context.h"
 #include "halley/graphics/render_target/render_target_texture.h"
+#include "halley/ui/ui_root.h"
 
 using namespace Halley;
 
@@ -212,7 +213,10 @@ std::optional<Vector2f> UIRenderSurface::transformToChildSpace(Vector2f pos) con
 
 void UIRenderSurface::setBypass(bool bypass)
 {
-	this->bypass = bypass;
+	if (this->bypass != bypass) {
+		this->bypass = bypass;
+		onRenderingChanged();
+	}
 }
 
 void UIRenderSurface::setAutoBypass(bool autoBypass)
@@ -248,7 +252,20 @@ void UIRenderSurface::update(Time t, bool moved)
 	}
 
 	if (autoBypass) {
-		bypass = Colour4c(colour) == Colour4c(255, 255, 255, 255) && std::abs(scale.x - 1.0f) < 0.00001f && std::abs(scale.y - 1.0f) < 0.00001f;
+		setBypass(Colour4c(colour) == Colour4c(255, 255, 255, 255) && std::abs(scale.x - 1.0f) < 0.00001f && std::abs(scale.y - 1.0f) < 0.00001f);
+	}
+}
+
+void UIRenderSurface::onEnabledChanged()
+{
+	onRenderingChanged();
+}
+
+void UIRenderSurface::onRenderingChanged()
+{
+	// Children render into the surface or straight to the screen, which the root's render list reflects
+	if (auto* root = getRoot()) {
+		root->onRenderListChanged();
 	}
 }
 
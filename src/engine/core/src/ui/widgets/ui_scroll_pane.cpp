@@ -58,7 +58,10 @@ Vector2f UIScrollPane::getRelativeScrollEndPosition() const
 
 void UIScrollPane::setClipSize(Vector2f clipSize)
 {
-	this->clipSize = clipSize;
+	if (this->clipSize != clipSize) {
+		this->clipSize = clipSize;
+		markAsNeedingLayout();
+	}
 }
 
 void UIScrollPane::scrollTo(Vector2f position)
@@ -70,18 +70,18 @@ void UIScrollBarPane::setClipSize(Vector2f clipSize)
 	pane->setClipSize(clipSize);
 }
 
-void UIScrollBarPane::collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst)
+void UIScrollBarPane::collectWidgetsForUpdating(Vector<UIWidget*>& dst)
 {
 	if (hBar) {
 		assert(hBar->getRoot() == getRoot());
-		dst.push_back(hBar);
+		dst.push_back(hBar.get());
 	}
 	if (vBar) {
 		assert(vBar->getRoot() == getRoot());
-		dst.push_back(vBar);
+		dst.push_back(vBar.get());
 	}
 	if (pane) {
 		assert(pane->getRoot() == getRoot());
-		dst.push_back(pane);
+		dst.push_back(pane.get());
 	}
 }
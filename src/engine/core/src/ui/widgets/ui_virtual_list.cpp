@@ -0,0 +1,573 @@
+#include "halley/ui/widgets/ui_virtual_list.h"
+#include "halley/ui/widgets/ui_scroll_pane.h"
+#include "halley/ui/ui_style.h"
+#include "halley/input/input_keyboard.h"
+
+using namespace Halley;
+
+UIVirtualListRow::UIVirtualListRow(UIVirtualList& parent, UIStyle style, std::shared_ptr<UIWidget> contents)
+	: UIClickable("", {}, UISizer(UISizerType::Horizontal), style.getBorder("innerBorder", Vector4f()))
+	, parent(parent)
+	, style(style)
+	, contents(std::move(contents))
+{
+	sprite = style.getSprite("normal");
+	add(this->contents, 1);
+}
+
+void UIVirtualListRow::pressMouse(Vector2f mousePos, int button, KeyMods keyMods)
+{
+	UIClickable::pressMouse(mousePos, button, keyMods);
+	parent.onRowClicked(*this, button, keyMods);
+}
+
+void UIVirtualListRow::onDoubleClicked(Vector2f mousePos, KeyMods keyMods)
+{
+	parent.onRowDoubleClicked(*this, keyMods);
+}
+
+const std::shared_ptr<UIWidget>& UIVirtualListRow::getContents() const
+{
+	return contents;
+}
+
+std::optional<size_t> UIVirtualListRow::getItemIndex() const
+{
+	return itemIndex;
+}
+
+bool UIVirtualListRow::isSelected() const
+{
+	return selected;
+}
+
+void UIVirtualListRow::setClickableInnerBorder(Vector4f border)
+{
+	if (innerBorder != border) {
+		innerBorder = border;
+		updateSpritePosition();
+	}
+}
+
+void UIVirtualListRow::draw(UIPainter& painter) const
+{
+	if (sprite.hasMaterial()) {
+		painter.draw(sprite);
+	}
+}
+
+void UIVirtualListRow::update(Time t, bool moved)
+{
+	if (updateButton() || moved) {
+		updateSpritePosition();
+	}
+	UIClickable::update(t, moved);
+}
+
+void UIVirtualListRow::doSetState(State state)
+{
+	if (selected && style.hasSprite("selected")) {
+		sprite = style.getSprite("selected");
+	} else if (state == State::Up) {
+		sprite = style.getSprite("normal");
+	} else if (state == State::Hover) {
+		sprite = style.getSprite("hover");
+	} else {
+		sprite = style.hasSprite("selected") ? style.getSprite("selected") : style.getSprite("hover");
+	}
+	updateSpritePosition();
+}
+
+void UIVirtualListRow::setSelected(bool s)
+{
+	if (selected != s) {
+		selected = s;
+		doSetState(getCurState());
+		sendEventDown(UIEvent(UIEventType::SetSelected, getId(), selected));
+	}
+}
+
+void UIVirtualListRow::updateSpritePosition()
+{
+	if (sprite.hasMaterial()) {
+		sprite.scaleTo(getSize() - innerBorder.xy() - innerBorder.zw()).setPos(getPosition() + innerBorder.xy());
+	}
+}
+
+
+UIVirtualList::UIVirtualList(String id, UIStyle style, RowFactory rowFactory, RowBinder rowBinder)
+	: UIWidget(std::move(id), {}, {}, style.getBorder("innerBorder", Vector4f()))
+	, rowFactory(std::move(rowFactory))
+	, rowBinder(std::move(rowBinder))
+	, gap(style.getFloat("gap", 0))
+{
+	styles.emplace_back(std::move(style));
+	sprite = styles[0].getSprite("background");
+	estimatedHeight = styles[0].getSubStyle("item").getVector2f("minSize", Vector2f()).y;
+	setInteractWithMouse(true);
+}
+
+void UIVirtualList::setItems(Vector<String> newIds)
+{
+	const auto selectedId = getSelectedOptionId();
+
+	// Keep measured heights of items that are still there
+	Vector<float> newHeights(newIds.size(), -1.0f);
+	measuredTotal = 0;
+	numMeasured = 0;
+	for (size_t i = 0; i < newIds.size(); ++i) {
+		const auto iter = idToIndex.find(newIds[i]);
+		if (iter != idToIndex.end() && heights[iter->second] >= 0) {
+			newHeights[i] = heights[iter->second];
+			measuredTotal += newHeights[i];
+			++numMeasured;
+		}
+	}
+
+	ids = std::move(newIds);
+	heights = std::move(newHeights);
+	idToIndex.clear();
+	idToIndex.reserve(ids.size());
+	for (size_t i = 0; i < ids.size(); ++i) {
+		idToIndex[ids[i]] = i;
+	}
+
+	const auto selected = tryGetItemIndex(selectedId);
+	curOption = selected ? static_cast<int>(*selected) : -1;
+
+	offsetsDirty = true;
+	unbindRows();
+	markAsNeedingLayout();
+}
+
+void UIVirtualList::refreshItem(size_t idx)
+{
+	if (auto* row = tryGetRow(idx)) {
+		bindRow(*row, idx);
+		markAsNeedingLayout();
+	}
+}
+
+void UIVirtualList::refreshItems()
+{
+	unbindRows();
+	markAsNeedingLayout();
+}
+
+void UIVirtualList::clear()
+{
+	setItems({});
+}
+
+size_t UIVirtualList::getCount() const
+{
+	return ids.size();
+}
+
+const String& UIVirtualList::getItemId(size_t idx) const
+{
+	return ids.at(idx);
+}
+
+std::optional<size_t> UIVirtualList::tryGetItemIndex(const String& id) const
+{
+	const auto iter = idToIndex.find(id);
+	if (iter != idToIndex.end()) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+void UIVirtualList::setEstimatedItemHeight(float height)
+{
+	estimatedHeight = height;
+	offsetsDirty = true;
+	markAsNeedingLayout();
+}
+
+void UIVirtualList::setViewMargin(float margin)
+{
+	viewMargin = margin;
+	markAsNeedingLayout();
+}
+
+bool UIVirtualList::setSelectedOption(int option)
+{
+	if (ids.empty()) {
+		return false;
+	}
+
+	const int newOption = clamp(option, 0, static_cast<int>(ids.size()) - 1);
+	if (newOption == curOption) {
+		return false;
+	}
+
+	if (auto* row = tryGetRow(curOption)) {
+		row->setSelected(false);
+	}
+	curOption = newOption;
+	if (auto* row = tryGetRow(curOption)) {
+		row->setSelected(true);
+	}
+
+	const auto& id = ids[curOption];
+	playStyleSound("selectionChangedSound");
+	sendEvent(UIEvent(UIEventType::ListSelectionChanged, getId(), id, curOption));
+	if (scrollToSelection) {
+		showItem(curOption, false);
+	}
+	if (getDataBindFormat() == UIDataBind::Format::String) {
+		notifyDataBind(id);
+	} else {
+		notifyDataBind(curOption);
+	}
+
+	return true;
+}
+
+bool UIVirtualList::setSelectedOptionId(const String& id)
+{
+	if (const auto idx = tryGetItemIndex(id)) {
+		return setSelectedOption(static_cast<int>(*idx));
+	}
+	return false;
+}
+
+int UIVirtualList::getSelectedOption() const
+{
+	return curOption;
+}
+
+String UIVirtualList::getSelectedOptionId() const
+{
+	if (curOption < 0 || curOption >= static_cast<int>(ids.size())) {
+		return "";
+	}
+	return ids[curOption];
+}
+
+void UIVirtualList::setScrollToSelection(bool value)
+{
+	scrollToSelection = value;
+}
+
+void UIVirtualList::showItem(size_t idx, bool centre)
+{
+	sendEvent(UIEvent(centre ? UIEventType::MakeAreaVisibleCentered : UIEventType::MakeAreaVisible, getId(), getOptionRect(static_cast<int>(idx))));
+}
+
+Rect4f UIVirtualList::getOptionRect(int option) const
+{
+	if (ids.empty()) {
+		return Rect4f();
+	}
+
+	updateOffsets();
+	const auto idx = static_cast<size_t>(clamp(option, 0, static_cast<int>(ids.size()) - 1));
+	const auto border = getInnerBorder();
+	const auto pos = Vector2f(border.x, border.y + offsets[idx]);
+	return Rect4f(pos, pos + Vector2f(getSize().x - border.x - border.z, getItemHeight(idx))).grow(styles[0].getBorder("scrollBorder", Vector4f()));
+}
+
+std::pair<size_t, size_t> UIVirtualList::getItemsInView() const
+{
+	return { firstInView, lastInView };
+}
+
+size_t UIVirtualList::getNumRows() const
+{
+	return rows.size();
+}
+
+bool UIVirtualList::canReceiveFocus() const
+{
+	return true;
+}
+
+bool UIVirtualList::ignoreClip() const
+{
+	return true;
+}
+
+void UIVirtualList::readFromDataBind()
+{
+	auto data = getDataBind();
+	if (data->getFormat() == UIDataBind::Format::String) {
+		setSelectedOptionId(data->getStringData());
+	} else {
+		setSelectedOption(data->getIntData());
+	}
+}
+
+Vector2f UIVirtualList::getLayoutMinimumSize(bool force) const
+{
+	if (!isActive() && !force) {
+		return {};
+	}
+
+	updateOffsets();
+	const auto border = getInnerBorder();
+	const float contentHeight = ids.empty() ? 0.0f : offsets.back() - gap;
+	return Vector2f::max(getMinimumSize(), Vector2f(maxRowWidth + border.x + border.z, contentHeight + border.y + border.w));
+}
+
+void UIVirtualList::update(Time t, bool moved)
+{
+	// Runs again after layout, so rows follow the list as soon as the scroll pane moves it
+	updateRows();
+
+	if (moved && sprite.hasMaterial()) {
+		sprite.scaleTo(getSize()).setPos(getPosition());
+	}
+}
+
+void UIVirtualList::draw(UIPainter& painter) const
+{
+	if (sprite.hasMaterial()) {
+		painter.draw(sprite);
+	}
+}
+
+bool UIVirtualList::onKeyPress(KeyboardKeyPress key)
+{
+	if (key.is(KeyCode::Up)) {
+		setSelectedOption(std::max(curOption - 1, 0));
+		return true;
+	}
+
+	if (key.is(KeyCode::Down)) {
+		setSelectedOption(curOption + 1);
+		return true;
+	}
+
+	if (key.is(KeyCode::Enter)) {
+		onAccept();
+		return true;
+	}
+
+	return false;
+}
+
+std::shared_ptr<UIWidget> UIVirtualList::makeRowContents()
+{
+	if (!rowFactory) {
+		throw Exception("UIVirtualList \"" + getId() + "\" has no row factory.", HalleyExceptions::UI);
+	}
+	return rowFactory();
+}
+
+void UIVirtualList::bindRow(UIVirtualListRow& row, size_t idx)
+{
+	if (rowBinder) {
+		rowBinder(*row.getContents(), idx);
+	}
+}
+
+void UIVirtualList::onRowClicked(UIVirtualListRow& row, int button, KeyMods keyMods)
+{
+	if (!row.itemIndex) {
+		return;
+	}
+
+	const auto idx = static_cast<int>(*row.itemIndex);
+	if (button == 0) {
+		setSelectedOption(idx);
+		sendEvent(UIEvent(UIEventType::ListItemLeftClicked, getId(), ids[idx], idx));
+	} else if (button == 1) {
+		sendEvent(UIEvent(UIEventType::ListItemMiddleClicked, getId(), ids[idx], idx));
+	} else if (button == 2) {
+		sendEvent(UIEvent(UIEventType::ListItemRightClicked, getId(), ids[idx], idx));
+	}
+	focus();
+}
+
+void UIVirtualList::onRowDoubleClicked(UIVirtualListRow& row, KeyMods keyMods)
+{
+	if (row.itemIndex && keyMods == KeyMods::None) {
+		setSelectedOption(static_cast<int>(*row.itemIndex));
+		onAccept();
+	}
+}
+
+UIVirtualListRow* UIVirtualList::tryGetRow(size_t idx) const
+{
+	if (idx >= firstInView && idx < lastInView) {
+		return rowsInView[idx - firstInView];
+	}
+	return nullptr;
+}
+
+float UIVirtualList::getItemHeight(size_t idx) const
+{
+	return heights[idx] >= 0 ? heights[idx] : getEstimatedItemHeight();
+}
+
+float UIVirtualList::getEstimatedItemHeight() const
+{
+	// The average of what has been measured is a better guess than the style's minimum size
+	return numMeasured > 0 ? measuredTotal / static_cast<float>(numMeasured) : estimatedHeight;
+}
+
+void UIVirtualList::updateOffsets() const
+{
+	if (!offsetsDirty) {
+		return;
+	}
+
+	offsets.resize(ids.size() + 1);
+	offsets[0] = 0;
+	for (size_t i = 0; i < ids.size(); ++i) {
+		offsets[i + 1] = offsets[i] + getItemHeight(i) + gap;
+	}
+	offsetsDirty = false;
+}
+
+size_t UIVirtualList::getItemAt(float y) const
+{
+	updateOffsets();
+	const auto iter = std::upper_bound(offsets.begin(), offsets.end(), y);
+	const auto idx = static_cast<size_t>(std::max(iter - offsets.begin() - 1, ptrdiff_t(0)));
+	return std::min(idx, ids.size() - 1);
+}
+
+std::optional<Rect4f> UIVirtualList::getViewRect() const
+{
+	const auto* root = getRoot();
+	if (!root) {
+		return std::nullopt;
+	}
+
+	auto view = root->getRect();
+	for (auto* parent = getParent(); parent; ) {
+		const auto* widget = dynamic_cast<const UIWidget*>(parent);
+		if (!widget) {
+			break;
+		}
+		if (dynamic_cast<const UIScrollPane*>(widget)) {
+			view = view.intersection(widget->getRect());
+		}
+		parent = widget->getParent();
+	}
+
+	// Only the height matters, the width may well be zero until rows have been measured
+	if (view.getHeight() <= 0) {
+		return std::nullopt;
+	}
+
+	const auto border = getInnerBorder();
+	return view - getPosition() - Vector2f(border.x, border.y);
+}
+
+void UIVirtualList::updateRows()
+{
+	size_t first = 0;
+	size_t last = 0;
+	const auto view = getViewRect();
+	if (view && !ids.empty()) {
+		first = getItemAt(view->getTop() - viewMargin);
+		last = getItemAt(view->getBottom() + viewMargin) + 1;
+	}
+
+	// Keep rows whose item is still in view, everything else is free to reuse
+	rowsInView.clear();
+	rowsInView.resize(last - first, nullptr);
+	freeRows.clear();
+	for (auto& row: rows) {
+		if (row->itemIndex && *row->itemIndex >= first && *row->itemIndex < last && !rowsInView[*row->itemIndex - first]) {
+			rowsInView[*row->itemIndex - first] = row.get();
+		} else {
+			freeRows.push_back(row.get());
+		}
+	}
+	firstInView = first;
+	lastInView = last;
+
+	for (size_t i = first; i < last; ++i) {
+		auto& row = rowsInView[i - first];
+		if (!row) {
+			if (freeRows.empty()) {
+				row = &makeRow();
+			} else {
+				row = freeRows.back();
+				freeRows.pop_back();
+			}
+			row->itemIndex = i;
+			row->setId(ids[i]);
+			row->setActive(true);
+			row->setSelected(static_cast<int>(i) == curOption);
+			bindRow(*row, i);
+		}
+	}
+
+	for (auto* row: freeRows) {
+		row->itemIndex = std::nullopt;
+		row->setActive(false);
+	}
+
+	if (layoutRows()) {
+		// Heights changed, so the estimate and everything below moved
+		layoutRows();
+		markAsNeedingLayout();
+	}
+}
+
+bool UIVirtualList::layoutRows()
+{
+	updateOffsets();
+
+	const auto border = getInnerBorder();
+	const float width = std::max(getSize().x - border.x - border.z, 0.0f);
+	const auto origin = getPosition() + Vector2f(border.x, border.y);
+	const float rowMinHeight = styles[0].getSubStyle("item").getVector2f("minSize", Vector2f()).y;
+
+	bool changed = false;
+	for (size_t i = firstInView; i < lastInView; ++i) {
+		auto& row = *rowsInView[i - firstInView];
+		const auto rowBorder = row.getInnerBorder();
+		maxRowWidth = std::max(maxRowWidth, row.getContents()->getLayoutMinimumSize(false).x + rowBorder.x + rowBorder.z);
+
+		row.setMinSize(Vector2f(width, rowMinHeight));
+		row.setPosition(origin + Vector2f(0, offsets[i]));
+		row.layout();
+
+		const float height = row.getSize().y;
+		if (std::abs(height - heights[i]) > 0.01f) {
+			if (heights[i] >= 0) {
+				measuredTotal -= heights[i];
+			} else {
+				++numMeasured;
+			}
+			measuredTotal += height;
+			heights[i] = height;
+			changed = true;
+		}
+	}
+
+	if (changed) {
+		offsetsDirty = true;
+	}
+	return changed;
+}
+
+UIVirtualListRow& UIVirtualList::makeRow()
+{
+	auto row = std::make_shared<UIVirtualListRow>(*this, styles[0].getSubStyle("item"), makeRowContents());
+	addChild(row);
+	return *rows.emplace_back(std::move(row));
+}
+
+void UIVirtualList::unbindRows()
+{
+	for (auto& row: rows) {
+		row->itemIndex = std::nullopt;
+	}
+	rowsInView.clear();
+	firstInView = 0;
+	lastInView = 0;
+}
+
+void UIVirtualList::onAccept()
+{
+	playStyleSound("acceptSound");
+	sendEvent(UIEvent(UIEventType::ListAccept, getId(), getSelectedOptionId(), curOption));
+}
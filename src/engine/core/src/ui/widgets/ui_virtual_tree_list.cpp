@@ -0,0 +1,222 @@
+#include "halley/ui/widgets/ui_virtual_tree_list.h"
+#include "halley/ui/widgets/ui_tree_list.h"
+#include "halley/ui/widgets/ui_image.h"
+#include "halley/ui/widgets/ui_label.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+namespace {
+	// Same layout as a UITreeList item
+	class UIVirtualTreeListRowContents : public UIWidget {
+	public:
+		explicit UIVirtualTreeListRowContents(const UIStyle& style)
+			: UIWidget("", {}, UISizer(UISizerType::Horizontal))
+		{
+			controls = std::make_shared<UITreeListControls>("", style.getSubStyle("controls"));
+			add(controls, 0, {}, UISizerFillFlags::Fill);
+
+			icon = std::make_shared<UIImage>(Sprite());
+			add(icon, 0, {}, UISizerAlignFlags::Centre);
+
+			const auto& labelStyle = style.getSubStyle("label");
+			label = std::make_shared<UILabel>("label", labelStyle, labelStyle.getTextRenderer("normal"), LocalisedString());
+			if (labelStyle.hasTextRenderer("selected")) {
+				label->setSelectable(labelStyle.getTextRenderer("normal"), labelStyle.getTextRenderer("selected"), true);
+			}
+			add(label, 1, style.getBorder("labelBorder"), UISizerFillFlags::Fill);
+		}
+
+		std::shared_ptr<UITreeListControls> controls;
+		std::shared_ptr<UIImage> icon;
+		std::shared_ptr<UILabel> label;
+	};
+}
+
+UIVirtualTreeList::UIVirtualTreeList(String id, UIStyle style)
+	: UIVirtualList(std::move(id), std::move(style))
+{
+	setupEvents();
+}
+
+void UIVirtualTreeList::addTreeItem(const String& id, const String& parentId, size_t childIndex, const LocalisedString& label, Sprite icon, bool expanded)
+{
+	if (nodes.find(id) != nodes.end()) {
+		throw Exception("Tree item \"" + id + "\" already exists in \"" + getId() + "\".", HalleyExceptions::UI);
+	}
+
+	auto& parent = getNodeOrRoot(parentId);
+	auto node = std::make_unique<Node>();
+	node->id = id;
+	node->label = label;
+	node->icon = std::move(icon);
+	node->parent = &parent;
+	node->expanded = expanded;
+	nodes[id] = node.get();
+
+	const auto pos = std::min(childIndex, parent.children.size());
+	parent.children.insert(parent.children.begin() + pos, std::move(node));
+	needsRefresh = true;
+}
+
+void UIVirtualTreeList::removeItem(const String& id)
+{
+	const auto iter = nodes.find(id);
+	if (iter == nodes.end()) {
+		return;
+	}
+
+	auto* node = iter->second;
+	forgetNode(*node);
+	auto& siblings = node->parent->children;
+	std_ex::erase_if(siblings, [&] (const std::unique_ptr<Node>& n) { return n.get() == node; });
+	needsRefresh = true;
+}
+
+void UIVirtualTreeList::setLabel(const String& id, const LocalisedString& label, Sprite icon)
+{
+	const auto iter = nodes.find(id);
+	if (iter != nodes.end()) {
+		iter->second->label = label;
+		iter->second->icon = std::move(icon);
+		// A pending refresh rebinds every row anyway, and the current indices may be stale
+		if (const auto idx = needsRefresh ? std::nullopt : tryGetItemIndex(id)) {
+			refreshItem(*idx);
+		}
+	}
+}
+
+void UIVirtualTreeList::clear()
+{
+	root.children.clear();
+	nodes.clear();
+	visibleNodes.clear();
+	needsRefresh = false;
+	UIVirtualList::clear();
+}
+
+void UIVirtualTreeList::setExpanded(const String& id, bool expanded)
+{
+	const auto iter = nodes.find(id);
+	if (iter != nodes.end() && iter->second->expanded != expanded) {
+		iter->second->expanded = expanded;
+		needsRefresh = true;
+	}
+}
+
+void UIVirtualTreeList::setAllExpanded(bool expanded)
+{
+	for (auto& [id, node]: nodes) {
+		node->expanded = expanded;
+	}
+	needsRefresh = true;
+}
+
+bool UIVirtualTreeList::isExpanded(const String& id) const
+{
+	const auto iter = nodes.find(id);
+	return iter != nodes.end() && iter->second->expanded;
+}
+
+void UIVirtualTreeList::makeParentsOfItemExpanded(const String& id)
+{
+	const auto iter = nodes.find(id);
+	if (iter != nodes.end()) {
+		for (auto* node = iter->second->parent; node && node != &root; node = node->parent) {
+			setExpanded(node->id, true);
+		}
+	}
+}
+
+void UIVirtualTreeList::refresh()
+{
+	visibleNodes.clear();
+	Vector<int> itemsLeftPerDepth;
+	collectVisible(root, itemsLeftPerDepth);
+
+	Vector<String> ids;
+	ids.reserve(visibleNodes.size());
+	for (const auto& visible: visibleNodes) {
+		ids.push_back(visible.node->id);
+	}
+	setItems(std::move(ids));
+
+	needsRefresh = false;
+}
+
+void UIVirtualTreeList::update(Time t, bool moved)
+{
+	// Refresh first, as removed nodes are still in visibleNodes until then and the base update binds rows from it
+	if (needsRefresh) {
+		refresh();
+	}
+	UIVirtualList::update(t, moved);
+}
+
+std::shared_ptr<UIWidget> UIVirtualTreeList::makeRowContents()
+{
+	return std::make_shared<UIVirtualTreeListRowContents>(styles.at(0));
+}
+
+void UIVirtualTreeList::bindRow(UIVirtualListRow& row, size_t idx)
+{
+	const auto& visible = visibleNodes.at(idx);
+	const auto& node = *visible.node;
+	auto& contents = static_cast<UIVirtualTreeListRowContents&>(*row.getContents());
+
+	// The controls send their id with expand/collapse events
+	contents.controls->setId(node.id);
+	const float indent = contents.controls->updateGuides(visible.itemsLeftPerDepth, !node.children.empty(), node.expanded);
+	contents.controls->setExpanded(node.expanded);
+	row.setClickableInnerBorder(Vector4f(indent, 0, 0, 0));
+
+	contents.icon->setSprite(node.icon);
+	contents.icon->setActive(node.icon.hasMaterial());
+	contents.label->setText(node.label);
+}
+
+UIVirtualTreeList::Node& UIVirtualTreeList::getNodeOrRoot(const String& id)
+{
+	if (id.isEmpty()) {
+		return root;
+	}
+	const auto iter = nodes.find(id);
+	return iter != nodes.end() ? *iter->second : root;
+}
+
+void UIVirtualTreeList::collectVisible(const Node& node, Vector<int>& itemsLeftPerDepth)
+{
+	// Same guide bookkeeping as UITreeListItem::doUpdateTree
+	itemsLeftPerDepth.push_back(static_cast<int>(node.children.size()));
+	for (const auto& child: node.children) {
+		visibleNodes.push_back(VisibleNode{ child.get(), itemsLeftPerDepth });
+		if (child->expanded) {
+			collectVisible(*child, itemsLeftPerDepth);
+		}
+		itemsLeftPerDepth.back()--;
+	}
+	itemsLeftPerDepth.pop_back();
+}
+
+void UIVirtualTreeList::forgetNode(const Node& node)
+{
+	nodes.erase(node.id);
+	for (const auto& child: node.children) {
+		forgetNode(*child);
+	}
+}
+
+void UIVirtualTreeList::setupEvents()
+{
+	setHandle(UIEventType::TreeCollapseHandle, [=] (const UIEvent& event)
+	{
+		setExpanded(event.getStringData(), false);
+		sendEvent(UIEvent(UIEventType::TreeItemExpanded, getId(), event.getStringData(), false));
+	});
+
+	setHandle(UIEventType::TreeExpandHandle, [=] (const UIEvent& event)
+	{
+		setExpanded(event.getStringData(), true);
+		sendEvent(UIEvent(UIEventType::TreeItemExpanded, getId(), event.getStringData(), true));
+	});
+}
@@ -60,3 +60,47 @@ Bytes Encrypt::decryptAES(AESIV iv, AESKey key, const Bytes& data)
 
 	return result;
 }
+
+void Encrypt::applyAESCTR(AESIV iv, AESKey key, size_t offset, gsl::span<gsl::byte> data)
+{
+	if (data.empty()) {
+		return;
+	}
+
+	// Counter for the block containing offset, i.e. iv + offset / blockSize as a 128-bit big endian integer
+	std::array<uint8_t, AES_BLOCKLEN> counter;
+	std::memcpy(counter.data(), iv.data(), AES_BLOCKLEN);
+	uint64_t carry = offset / AES_BLOCKLEN;
+	for (int i = AES_BLOCKLEN - 1; i >= 0 && carry != 0; --i) {
+		const uint64_t sum = counter[i] + (carry & 0xFF);
+		counter[i] = static_cast<uint8_t>(sum);
+		carry = (carry >> 8) + (sum >> 8);
+	}
+
+	AES_ctx ctx;
+	AES_init_ctx_iv(&ctx, key.data(), counter.data());
+
+	auto* bytes = reinterpret_cast<uint8_t*>(data.data());
+	size_t remaining = data.size();
+
+	// Partial first block: run a whole block through, and only keep the part we need
+	const size_t skip = offset % AES_BLOCKLEN;
+	if (skip != 0) {
+		std::array<uint8_t, AES_BLOCKLEN> block = {};
+		const size_t n = std::min(remaining, AES_BLOCKLEN - skip);
+		std::memcpy(block.data() + skip, bytes, n);
+		AES_CTR_xcrypt_buffer(&ctx, block.data(), AES_BLOCKLEN);
+		std::memcpy(bytes, block.data() + skip, n);
+		bytes += n;
+		remaining -= n;
+	}
+
+	// The context's counter carries over between calls, so this can be done in chunks that fit the length
+	constexpr size_t maxChunk = size_t(1) << 30;
+	while (remaining > 0) {
+		const size_t n = std::min(remaining, maxChunk);
+		AES_CTR_xcrypt_buffer(&ctx, bytes, static_cast<uint32_t>(n));
+		bytes += n;
+		remaining -= n;
+	}
+}
@@ -18,18 +18,45 @@ public:
 		}
 	}
 
+	void onEntitiesRemoved(Span<ParticleFamily> es)
+	{
+		for (auto& e: es) {
+			rngs.erase(e.entityId);
+		}
+	}
+
 	void update(Time t)
 	{
+		// Global transforms are lazily cached (and shared with parents), so read them before going wide
+		// Each emitter also gets its own generator, as sharing the global one would make spawns depend on thread timing
 		for (auto& e: particleFamily) {
 			auto& particles = e.particles.particles;
 			particles.setPosition(Vector3f(e.transform2D.getGlobalPosition(), e.transform2D.getGlobalHeight()));
 			particles.setSecondarySpawner(this);
-			particles.update(t);
+			particles.setRNG(getRNG(e.entityId));
+		}
+
+		const auto& screenService = getScreenService();
+		deferSpawns = true;
+		Concurrent::parallelFor(particleFamily.size(), 1, [&] (size_t start, size_t end) {
+			for (size_t i = start; i < end; ++i) {
+				auto& particles = particleFamily[i].particles.particles;
+				particles.update(t);
 
-			if (const auto aabb = particles.getAABB(); aabb && getScreenService().isVisible(*aabb)) {
-				particles.updateSprites(t);
+				if (const auto aabb = particles.getAABB(); aabb && screenService.isVisible(*aabb)) {
+					particles.updateSprites(t);
+				}
 			}
+		});
+		deferSpawns = false;
+
+		for (const auto& [pos, target]: pendingSpawns) {
+			spawn(pos, target);
+		}
+		pendingSpawns.clear();
 
+		for (auto& e: particleFamily) {
+			const auto& particles = e.particles.particles;
 			if (!particles.isAlive() && !particles.isEnabled() && !getWorld().isEditor()) {
 				getWorld().destroyEntity(e.entityId);
 			}
@@ -45,6 +72,13 @@ public:
 
 	void spawn(Vector3f pos, EntityId target) override
 	{
+		if (deferSpawns) {
+			// Target might be updating on another thread
+			std::unique_lock<std::mutex> lock(pendingSpawnsMutex);
+			pendingSpawns.emplace_back(pos, target);
+			return;
+		}
+
 		// TODO: this could be a perf bottleneck
 		if (auto* particles = particleFamily.tryFind(target)) {
 			particles->particles.particles.spawnAt(pos);
@@ -52,6 +86,21 @@ public:
 	}
 
 private:
+	bool deferSpawns = false;
+	std::mutex pendingSpawnsMutex;
+	Vector<std::pair<Vector3f, EntityId>> pendingSpawns;
+	HashMap<EntityId, std::unique_ptr<Random>> rngs;
+
+	Random& getRNG(EntityId id)
+	{
+		// Seeded once per emitter, and heap allocated so it doesn't move when the map grows
+		auto& rng = rngs[id];
+		if (!rng) {
+			rng = std::make_unique<Random>(Random::getGlobal().getRawInt());
+		}
+		return *rng;
+	}
+
 	void refreshParticles(ParticleFamily& e)
 	{
 		auto& particles = e.particles.particles;
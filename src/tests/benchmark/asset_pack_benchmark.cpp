@@ -0,0 +1,167 @@
+// Measures concurrent asset loads from an unencrypted pack on disk, read through the locked file reader and through the memory-mapped one.
+// Loads only touch one byte per page, so this measures loading rather than summing.
+// Then measures name lookups in the pack's binary index, against parsing the "pos:size" entries of the asset database as packs used to.
+//
+// Usage: halley-asset-pack-benchmark [--assets N] [--threads N] [--rounds N] [--lookups N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "halley/resources/asset_pack.h"
+#include "halley/resources/asset_database.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t assetSize = 32 * 1024;
+
+	struct Options {
+		size_t assets = 512;
+		size_t threads = 8;
+		size_t rounds = 4;
+		size_t lookups = 10000;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--assets", options.assets, 1)
+			.add("--threads", options.threads, 1)
+			.add("--rounds", options.rounds, 1)
+			.add("--lookups", options.lookups, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	String getAssetName(size_t i)
+	{
+		return "asset" + toString(i);
+	}
+
+	Path writePack(size_t nAssets)
+	{
+		AssetPack pack;
+		auto& data = pack.getData();
+		data.resize(nAssets * assetSize);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<Byte>((i * 31) & 0xFF);
+		}
+		for (size_t i = 0; i < nAssets; ++i) {
+			pack.getAssetDatabase().addAsset(getAssetName(i), AssetType::BinaryFile, AssetDatabase::Entry(toString(i * assetSize) + ":" + toString(assetSize), Metadata()));
+		}
+
+		const auto bytes = pack.writeOut();
+		const auto path = std::filesystem::temp_directory_path() / "halley_asset_pack_benchmark.dat";
+		std::ofstream out(path, std::ios::binary);
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return Path(path.string());
+	}
+
+	// Loads every asset from each thread at once, returning the sum of the bytes read and the time taken in seconds
+	std::pair<uint64_t, double> loadConcurrently(AssetPack& pack, const Options& options)
+	{
+		std::atomic<uint64_t> total = 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		Vector<std::thread> threads;
+		for (size_t t = 0; t < options.threads; ++t) {
+			threads.emplace_back([&, t] () {
+				uint64_t sum = 0;
+				for (size_t r = 0; r < options.rounds; ++r) {
+					for (size_t i = 0; i < options.assets; ++i) {
+						const auto data = pack.getData(getAssetName((i + t * 37) % options.assets), AssetType::BinaryFile, false);
+						const auto span = dynamic_cast<ResourceDataStatic&>(*data).getSpan();
+						for (size_t j = 0; j < span.size(); j += 4096) {
+							sum += static_cast<uint8_t>(span[j]);
+						}
+					}
+				}
+				total += sum;
+			});
+		}
+		for (auto& t: threads) {
+			t.join();
+		}
+
+		return { total.load(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+	}
+
+	// Returns the time in microseconds to look up every name through the index, and through the database
+	std::pair<double, double> measureLookups(size_t nNames)
+	{
+		AssetDatabase db;
+		Vector<String> names;
+		for (size_t i = 0; i < nNames; ++i) {
+			names.push_back("sprites/level_" + toString(i % 50) + "/object_" + toString(i));
+			db.addAsset(names.back(), AssetType::Sprite, AssetDatabase::Entry(toString(i * 1000) + ":1000", Metadata()));
+		}
+		const auto index = AssetPackIndex::fromDatabase(db);
+		const auto view = AssetPackIndex::fromView(index.getBytes());
+
+		uint64_t indexSum = 0;
+		const auto indexStart = std::chrono::steady_clock::now();
+		for (const auto& name: names) {
+			const auto* entry = view.tryGet(name, AssetType::Sprite);
+			indexSum += entry->pos + entry->size;
+		}
+		const auto indexEnd = std::chrono::steady_clock::now();
+
+		uint64_t dbSum = 0;
+		const auto dbStart = std::chrono::steady_clock::now();
+		for (const auto& name: names) {
+			const auto ps = db.getDatabase(AssetType::Sprite).get(name).path.split(':');
+			dbSum += uint64_t(ps.at(0).toInteger64()) + uint64_t(ps.at(1).toInteger64());
+		}
+		const auto dbEnd = std::chrono::steady_clock::now();
+
+		if (indexSum != dbSum) {
+			throw Exception("Index and database lookups disagree", HalleyExceptions::Tools);
+		}
+		return { std::chrono::duration<double, std::micro>(indexEnd - indexStart).count(), std::chrono::duration<double, std::micro>(dbEnd - dbStart).count() };
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+		const auto path = writePack(options.assets);
+
+		AssetPack locked(std::make_unique<ResourceDataReaderFileSystem>(path), std::nullopt, false);
+		const auto [lockedSum, lockedTime] = loadConcurrently(locked, options);
+
+		auto mappedReader = ResourceDataReaderMappedFile::tryOpen(path);
+		if (!mappedReader) {
+			throw Exception("Unable to map " + path.getString(), HalleyExceptions::Tools);
+		}
+		AssetPack mapped(std::move(mappedReader), std::nullopt, false);
+		const auto [mappedSum, mappedTime] = loadConcurrently(mapped, options);
+
+		if (lockedSum != mappedSum) {
+			throw Exception("Locked and mapped reads returned different data", HalleyExceptions::Tools);
+		}
+
+		const double megabytes = static_cast<double>(options.threads * options.rounds * options.assets * assetSize) / (1024.0 * 1024.0);
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << options.assets << " assets of " << assetSize / 1024 << " kB, " << options.rounds << " rounds on " << options.threads << " threads" << std::endl;
+		std::cout << "Concurrent load throughput (MB/s):" << std::endl;
+		std::cout << "  Locked file reader: " << (megabytes / lockedTime) << std::endl;
+		std::cout << "  Mapped file reader: " << (megabytes / mappedTime) << std::endl;
+
+		const auto [indexUs, dbUs] = measureLookups(options.lookups);
+		std::cout << "Time for " << options.lookups << " name lookups (us):" << std::endl;
+		std::cout << "  Pack index: " << indexUs << std::endl;
+		std::cout << "  Asset database: " << dbUs << std::endl;
+
+		std::filesystem::remove(path.string());
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Asset pack benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,77 @@
+// Measures LZ4 decompression of one asset-sized buffer: as a single block, as independent chunks on the calling thread,
+// and as chunks spread over the CPU executors.
+//
+// Usage: halley-compression-benchmark [--megabytes N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "halley/bytes/compression.h"
+#include "test_executors.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		size_t megabytes = 32;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--megabytes", options.megabytes, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	// Somewhat compressible, with an incompressible stretch in the middle
+	Bytes makeData(size_t size)
+	{
+		Bytes data(size);
+		Random rng(777u);
+		for (size_t i = 0; i < size; ++i) {
+			const bool noisy = i > size / 3 && i < size / 2;
+			data[i] = noisy ? static_cast<Byte>(rng.getInt(0, 255)) : static_cast<Byte>((i / 7) % 13);
+		}
+		return data;
+	}
+
+	// Returns the decompression time in milliseconds
+	double measureDecompress(const Bytes& data, const Bytes& compressed, ExecutionQueue* queue)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		size_t outSize = 0;
+		const auto result = Compression::lz4DecompressAnyToSharedPtr(compressed.byte_span(), outSize, queue);
+		const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (outSize != data.size() || memcmp(result.get(), data.data(), data.size()) != 0) {
+			throw Exception("Decompressed data doesn't match", HalleyExceptions::Tools);
+		}
+		return ms;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+		TestExecutors executors(std::thread::hardware_concurrency());
+
+		const auto data = makeData(options.megabytes * 1024 * 1024);
+		const auto single = Compression::lz4CompressFile(data.byte_span(), {});
+		const auto chunked = Compression::lz4CompressChunked(data.byte_span());
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "LZ4 decompression of " << options.megabytes << " MB (ms):" << std::endl;
+		std::cout << "  Single block (" << single.size() << " bytes): " << measureDecompress(data, single, nullptr) << std::endl;
+		std::cout << "  Chunked (" << chunked.size() << " bytes): " << measureDecompress(data, chunked, nullptr) << std::endl;
+		std::cout << "  Chunked, in parallel: " << measureDecompress(data, chunked, &Executors::getCPU()) << std::endl;
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Compression benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,69 @@
+// Measures DistanceFieldGenerator::generateSDF against the brute force search it replaced, downsampling 4:1 as fonts do.
+//
+// Usage: halley-distance-field-benchmark [--size N] [--radius N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "distance_field_reference.h"
+#include "test_executors.h"
+#include "halley/tools/distance_field/distance_field_generator.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		int size = 512;
+		int radius = 4;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--size", options.size, 4)
+			.add("--radius", options.radius, 0)
+			.parse(argc, argv);
+		options.size = options.size / 4 * 4; // The output is a quarter of the size
+		return options;
+	}
+
+	template <typename F>
+	double measure(F f)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+		TestExecutors executors(std::thread::hardware_concurrency());
+
+		const auto src = makeDistanceFieldShapes(Vector2i(options.size, options.size));
+		const auto dstSize = Vector2i(options.size / 4, options.size / 4);
+		const auto radius = float(options.radius);
+
+		std::unique_ptr<Image> expected;
+		std::unique_ptr<Image> result;
+		const auto referenceMs = measure([&] () { expected = generateReferenceSDF(*src, dstSize, radius); });
+		const auto resultMs = measure([&] () { result = DistanceFieldGenerator::generateSDF(*src, dstSize, radius); });
+		if (expected->getPixelBytes().size() != result->getPixelBytes().size()) {
+			throw Exception("Generated images have different sizes", HalleyExceptions::Tools);
+		}
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Distance field from " << options.size << "x" << options.size << " to " << dstSize.x << "x" << dstSize.y << ", radius " << options.radius << " (ms):" << std::endl;
+		std::cout << "  Brute force: " << referenceMs << std::endl;
+		std::cout << "  Distance transform: " << resultMs << std::endl;
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Distance field benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
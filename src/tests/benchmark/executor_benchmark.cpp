@@ -0,0 +1,76 @@
+// Measures task throughput of the CPU execution queue, with tasks that spawn more tasks from inside the pool.
+// Each outer task queues its inner tasks from a worker thread, so most of them are stolen by other workers.
+//
+// Usage: halley-executor-benchmark [--outer N] [--inner N] [--max-threads N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "test_executors.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		int outer = 1000;
+		int inner = 100;
+		size_t maxThreads = 32;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--outer", options.outer, 1)
+			.add("--inner", options.inner, 0)
+			.add("--max-threads", options.maxThreads, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	// Returns the time in seconds to run every task
+	double runSpawnTasks(size_t nThreads, int nOuter, int nInner)
+	{
+		TestExecutors executors(nThreads);
+
+		std::atomic<int> count = 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		Vector<Future<void>> futures;
+		for (int i = 0; i < nOuter; ++i) {
+			futures.push_back(Concurrent::execute(Executors::getCPU(), [&] () {
+				for (int j = 0; j < nInner; ++j) {
+					Executors::getCPU().addToQueue([&] () { ++count; });
+				}
+				++count;
+			}));
+		}
+		Concurrent::whenAll(futures.begin(), futures.end()).wait();
+		while (count.load() < nOuter * (nInner + 1)) {
+			std::this_thread::yield();
+		}
+
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+		const auto nTasks = double(options.outer) * double(options.inner + 1);
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Throughput of " << options.outer << " tasks spawning " << options.inner << " each (M tasks/s):" << std::endl;
+		for (size_t nThreads = 1; nThreads <= options.maxThreads; nThreads *= 2) {
+			const auto time = runSpawnTasks(nThreads, options.outer, options.inner);
+			std::cout << "  " << nThreads << " threads: " << (nTasks / time / 1000000.0) << std::endl;
+		}
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Executor benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
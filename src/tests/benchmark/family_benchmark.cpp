@@ -0,0 +1,138 @@
+// Measures iterating a family whose elements are in a different order from their components in memory,
+// with and without World::setSortFamiliesByComponentAddress. Components are added in a shuffled order, so without sorting
+// each element jumps to an unrelated spot in the component pools. Then measures frames that also destroy and spawn entities,
+// which is where sorting pays its cost.
+//
+// Usage: halley-family-benchmark [--entities N] [--frames N] [--churn N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "test_components.h"
+#include "test_world.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		int entities = 200000;
+		int frames = 100;
+		int churn = 500;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--entities", options.entities, 1)
+			.add("--frames", options.frames, 1)
+			.add("--churn", options.churn, 0)
+			.parse(argc, argv);
+		return options;
+	}
+
+	class MovementSystem : public System {
+	public:
+		MovementSystem()
+			: System({ &family }, {})
+		{}
+
+		float checksum = 0;
+
+	protected:
+		void updateBase(Time t) override
+		{
+			const auto dt = float(t);
+			for (auto& e: family) {
+				e.position.position += e.velocity.velocity * dt;
+				checksum += e.position.position.x;
+			}
+		}
+
+	private:
+		FamilyBinding<TestMovementFamily> family;
+	};
+
+	void spawnShuffled(World& world, int n, Random& rng, Vector<EntityId>& alive)
+	{
+		Vector<EntityRef> spawned;
+		spawned.reserve(n);
+		for (int i = 0; i < n; ++i) {
+			spawned.push_back(world.createEntity());
+		}
+
+		// Components are allocated in shuffled order, but the family adds entities in creation order
+		for (size_t i = spawned.size(); i > 1; --i) {
+			std::swap(spawned[i - 1], spawned[rng.getSizeT(0, i - 1)]);
+		}
+		for (auto& e: spawned) {
+			e.addComponent(TestPositionComponent());
+			e.addComponent(TestVelocityComponent());
+			e.getComponent<TestVelocityComponent>().velocity = Vector2f(rng.getFloat(-1, 1), rng.getFloat(-1, 1));
+			alive.push_back(e.getEntityId());
+		}
+	}
+
+	struct Result {
+		double iterateMs = 0;
+		double churnMs = 0;
+		float checksum = 0;
+	};
+
+	Result run(const Options& options, bool sorted)
+	{
+		TestWorld testWorld;
+		auto& world = testWorld.getWorld();
+		world.setSortFamiliesByComponentAddress(sorted);
+		auto& system = static_cast<MovementSystem&>(world.addSystem(std::make_unique<MovementSystem>(), TimeLine::FixedUpdate));
+
+		Random rng(1234u);
+		Vector<EntityId> alive;
+		spawnShuffled(world, options.entities, rng, alive);
+		world.step(TimeLine::FixedUpdate, 1.0 / 60.0);
+
+		Result result;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < options.frames; ++i) {
+			world.step(TimeLine::FixedUpdate, 1.0 / 60.0);
+		}
+		result.iterateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / options.frames;
+
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < options.frames; ++i) {
+			for (int j = 0; j < options.churn && !alive.empty(); ++j) {
+				const auto idx = rng.getSizeT(0, alive.size() - 1);
+				world.destroyEntity(alive[idx]);
+				alive[idx] = alive.back();
+				alive.pop_back();
+			}
+			spawnShuffled(world, options.churn, rng, alive);
+			world.step(TimeLine::FixedUpdate, 1.0 / 60.0);
+		}
+		result.churnMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / options.frames;
+
+		result.checksum = system.checksum;
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+
+		const auto unsorted = run(options, false);
+		const auto sorted = run(options, true);
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << options.entities << " entities, time per frame (ms):" << std::endl;
+		std::cout << "  Iteration: unsorted " << unsorted.iterateMs << ", sorted " << sorted.iterateMs << std::endl;
+		std::cout << "  Iteration with " << options.churn << " entities replaced per frame: unsorted " << unsorted.churnMs << ", sorted " << sorted.churnMs << std::endl;
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Family benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
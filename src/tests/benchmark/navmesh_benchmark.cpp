@@ -0,0 +1,70 @@
+// Measures Navmesh::pathfindNodes latency on grids of increasing size, with random queries that all have a path.
+// Consecutive queries reuse the navmesh's scratch state, as they would in a game.
+//
+// Usage: halley-navmesh-benchmark [--queries N] [--max-size N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "navmesh_grid.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		size_t queries = 200;
+		int maxSize = 250;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--queries", options.queries, 1)
+			.add("--max-size", options.maxSize, 16)
+			.parse(argc, argv);
+		return options;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Navmesh::pathfindNodes time (us/query):" << std::endl;
+		for (int size: { 16, 32, 64, 128, 250 }) {
+			if (size > options.maxSize) {
+				break;
+			}
+
+			const auto navmesh = makeGridNavmesh(size);
+			const auto side = size * 10.0f;
+
+			Random rng(12345u);
+			Vector<NavigationQuery> queries;
+			for (size_t i = 0; i < options.queries; ++i) {
+				queries.push_back(makeGridQuery(Vector2f(rng.getFloat(0, side), rng.getFloat(0, side)), Vector2f(rng.getFloat(0, side), rng.getFloat(0, side))));
+			}
+
+			size_t found = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (const auto& query: queries) {
+				found += navmesh.pathfindNodes(query).has_value() ? 1 : 0;
+			}
+			const auto us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / double(queries.size());
+
+			if (found != queries.size()) {
+				throw Exception("Only " + toString(found) + " of " + toString(queries.size()) + " queries found a path", HalleyExceptions::Tools);
+			}
+			std::cout << "  " << navmesh.getNumNodes() << " nodes: " << us << std::endl;
+		}
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Navmesh benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
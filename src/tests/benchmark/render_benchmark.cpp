@@ -0,0 +1,291 @@
+// Measures the CPU side of rendering a representative frame, with no window or GPU.
+// The scene goes through SpritePainter, TextRenderer and a RenderGraph, and is rendered with the dummy video backend.
+// One frame is captured in a RenderSnapshot, which is used to count draw calls and what broke each batch, and is then played back.
+//
+// Usage: halley-render-benchmark [--frames N] [--sprites N] [--texts N] [--textures N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "headless_renderer.h"
+#include "test_executors.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	constexpr int worldMask = 1;
+	constexpr int uiMask = 2;
+	const Vector2i screenSize = Vector2i(1280, 720);
+
+	struct Options {
+		int frames = 30;
+		size_t sprites = 20000;
+		size_t texts = 200;
+		size_t textures = 4;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--frames", options.frames, 1)
+			.add("--sprites", options.sprites, 0)
+			.add("--texts", options.texts, 0)
+			.add("--textures", options.textures, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	// Total time spent in each stage, kept in the order they were first seen
+	class StageTimes {
+	public:
+		template <typename F>
+		void measure(const String& stage, F f)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			f();
+			add(stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		void add(const String& stage, double ms)
+		{
+			for (auto& [name, total]: stages) {
+				if (name == stage) {
+					total += ms;
+					return;
+				}
+			}
+			stages.emplace_back(stage, ms);
+		}
+
+		const Vector<std::pair<String, double>>& getStages() const
+		{
+			return stages;
+		}
+
+	private:
+		Vector<std::pair<String, double>> stages;
+	};
+
+	// World, then an overlay over it, then UI on top
+	std::shared_ptr<RenderGraphDefinition> makeRenderGraph(HeadlessRenderer& renderer)
+	{
+		renderer.getResources().of<MaterialDefinition>().setResource(0, "Benchmark/Overlay", renderer.makeSpriteMaterial("Benchmark/Overlay"));
+
+		auto graph = std::make_shared<RenderGraphDefinition>();
+		auto paintSettings = [] (const String& name, int mask, std::optional<String> clear)
+		{
+			ConfigNode::MapType settings;
+			settings["name"] = name;
+			settings["cameraId"] = "main";
+			settings["paintMasks"] = ConfigNode::SequenceType{ ConfigNode(mask) };
+			if (clear) {
+				settings["colourClear"] = *clear;
+			}
+			return ConfigNode(std::move(settings));
+		};
+		ConfigNode::MapType overlaySettings;
+		overlaySettings["name"] = "overlay";
+		overlaySettings["material"] = "Benchmark/Overlay";
+
+		const auto world = graph->addNode("paint", Vector2f(), paintSettings("world", worldMask, "#101020"));
+		const auto overlay = graph->addNode("overlay", Vector2f(), ConfigNode(std::move(overlaySettings)));
+		const auto ui = graph->addNode("paint", Vector2f(), paintSettings("ui", uiMask, std::nullopt));
+		const auto output = graph->addNode("output", Vector2f(), ConfigNode(ConfigNode::MapType{ { "name", ConfigNode("output") } }));
+
+		// Assigns node types, and the overlay's texture pins come from its material, so this goes before connecting
+		graph->loadMaterials(renderer.getResources());
+		graph->connectPins(world, 3, overlay, 4); // Colour out -> overlay texture
+		graph->connectPins(overlay, 2, ui, 0); // Colour out -> colour in
+		graph->connectPins(ui, 3, output, 0); // Colour out -> colour in
+		graph->finishGraph();
+		return graph;
+	}
+
+	class BenchmarkScene {
+	public:
+		BenchmarkScene(HeadlessRenderer& renderer, const Options& options)
+			: options(options)
+			, font(renderer.makeFont("Benchmark"))
+			, renderGraph(makeRenderGraph(renderer))
+		{
+			// One definition with a texture each, like sprites from different spritesheets
+			const auto spriteDefinition = renderer.makeSpriteMaterial("Benchmark/Sprite");
+			for (size_t i = 0; i < options.textures; ++i) {
+				auto material = std::make_shared<Material>(spriteDefinition);
+				material->set(0, renderer.makeTexture("benchmark_sprite" + toString(i) + ".png", Vector2i(64, 64)));
+				materials.push_back(std::move(material));
+			}
+
+			renderGraph.setCamera("main", Camera(Vector2f(screenSize) * 0.5f));
+			renderGraph.setDrawCallback([this] (SpriteMaskBase mask, Painter& painter)
+			{
+				times->measure(mask == worldMask ? "SpritePainter draw (world)" : "SpritePainter draw (UI)", [&] ()
+				{
+					spritePainter.draw(mask, painter);
+				});
+			});
+		}
+
+		// Sprites spread over a few layers, so materials interleave, and lines of text with outlines on top
+		void populate(int frame)
+		{
+			spritePainter.startFrame();
+			Random rng(uint32_t(1234 + frame));
+			for (size_t i = 0; i < options.sprites; ++i) {
+				Sprite sprite;
+				sprite.setMaterial(materials[rng.getSizeT(0, materials.size() - 1)])
+					.setPosition(Vector2f(rng.getFloat(0, float(screenSize.x)), rng.getFloat(0, float(screenSize.y))))
+					.setSize(Vector2f(32, 32))
+					.setRotation(Angle1f::fromDegrees(rng.getFloat(0, 360)));
+				spritePainter.add(std::move(sprite), worldMask, rng.getInt(0, 3), sprite.getPosition().y);
+			}
+
+			for (size_t i = 0; i < options.texts; ++i) {
+				auto text = TextRenderer(font, "Text line number " + toString(i), 16)
+					.setPosition(Vector2f(rng.getFloat(0, float(screenSize.x - 200)), rng.getFloat(0, float(screenSize.y - 20))));
+				if (i % 4 == 0) {
+					text.setOutline(1.0f, Colour4f(0, 0, 0, 1));
+				}
+				spritePainter.add(std::move(text), uiMask, 0, float(i));
+			}
+		}
+
+		void render(RenderContext& rc, VideoAPI& video, StageTimes& stageTimes)
+		{
+			times = &stageTimes;
+			times->measure("RenderGraph render", [&] ()
+			{
+				renderGraph.render(rc, video);
+			});
+			times = nullptr;
+		}
+
+	private:
+		Options options;
+		std::shared_ptr<Font> font;
+		Vector<std::shared_ptr<const Material>> materials;
+		RenderGraph renderGraph;
+		SpritePainter spritePainter;
+		StageTimes* times = nullptr;
+	};
+
+	struct SnapshotStats {
+		size_t drawCommands = 0;
+		size_t vertices = 0;
+		size_t triangles = 0;
+		std::map<RenderSnapshot::Reason, size_t> breaks;
+	};
+
+	SnapshotStats getSnapshotStats(const RenderSnapshot& snapshot)
+	{
+		SnapshotStats stats;
+		for (size_t i = 0; i < snapshot.getNumCommands(); ++i) {
+			const auto info = snapshot.getCommandInfo(i);
+			if (info.type == RenderSnapshot::CommandType::Draw) {
+				++stats.drawCommands;
+				stats.vertices += info.numVertices;
+				stats.triangles += info.numTriangles;
+				++stats.breaks[info.reason];
+			}
+		}
+		return stats;
+	}
+
+	const char* getReasonName(RenderSnapshot::Reason reason)
+	{
+		switch (reason) {
+		case RenderSnapshot::Reason::First:
+			return "first";
+		case RenderSnapshot::Reason::Clear:
+			return "clear";
+		case RenderSnapshot::Reason::AfterClear:
+			return "after clear";
+		case RenderSnapshot::Reason::ChangeBind:
+			return "render target or camera change";
+		case RenderSnapshot::Reason::ChangeClip:
+			return "clip change";
+		case RenderSnapshot::Reason::MaterialDefinition:
+			return "material definition change";
+		case RenderSnapshot::Reason::MaterialParameters:
+			return "material parameters change";
+		case RenderSnapshot::Reason::Textures:
+			return "texture change";
+		default:
+			return "unknown";
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+
+		TestExecutors executors(std::thread::hardware_concurrency());
+
+		HeadlessRenderer renderer(screenSize);
+		auto& painter = renderer.getPainter();
+		auto& video = *renderer.getAPI().video;
+		BenchmarkScene scene(renderer, options);
+
+		// Warm up, so the first frame's allocations don't count
+		scene.populate(-1);
+		StageTimes warmUp;
+		renderer.render([&] (RenderContext& rc) { scene.render(rc, video, warmUp); });
+
+		StageTimes times;
+		size_t painterDrawCalls = 0;
+		for (int frame = 0; frame < options.frames; ++frame) {
+			times.measure("Scene population", [&] () { scene.populate(frame); });
+			times.measure("Frame total", [&] ()
+			{
+				renderer.render([&] (RenderContext& rc) { scene.render(rc, video, times); });
+			});
+			painterDrawCalls += painter.getNumDrawCalls();
+		}
+
+		// Same frame again, recorded
+		RenderSnapshot snapshot;
+		scene.populate(0);
+		StageTimes snapshotTimes;
+		const auto captureStart = std::chrono::steady_clock::now();
+		renderer.render([&] (RenderContext& rc) { scene.render(rc, video, snapshotTimes); }, &snapshot);
+		const auto captureEnd = std::chrono::steady_clock::now();
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p)
+			{
+				snapshot.playback(p, std::nullopt);
+			});
+		});
+		const auto playbackEnd = std::chrono::steady_clock::now();
+
+		const auto stats = getSnapshotStats(snapshot);
+		const auto frames = double(options.frames);
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Scene: " << options.sprites << " sprites, " << options.texts << " texts, " << options.textures << " sprite textures, " << screenSize << " screen" << std::endl;
+		std::cout << "Draw commands: " << stats.drawCommands << std::endl;
+		std::cout << "Draw calls, one per pass: " << (painterDrawCalls / options.frames) << std::endl;
+		std::cout << "Vertices: " << stats.vertices << std::endl;
+		std::cout << "Triangles: " << stats.triangles << std::endl;
+		std::cout << "Batch breaks:" << std::endl;
+		for (const auto& [reason, count]: stats.breaks) {
+			std::cout << "  " << getReasonName(reason) << ": " << count << std::endl;
+		}
+		std::cout << "CPU time per frame (ms), average of " << options.frames << " frames:" << std::endl;
+		for (const auto& [stage, total]: times.getStages()) {
+			std::cout << "  " << stage << ": " << (total / frames) << std::endl;
+		}
+		std::cout << "  Snapshot capture frame: " << std::chrono::duration<double, std::milli>(captureEnd - captureStart).count() << std::endl;
+		std::cout << "  Snapshot playback: " << std::chrono::duration<double, std::milli>(playbackEnd - captureEnd).count() << std::endl;
+
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Render benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,122 @@
+// Measures SpritePainter's radix sort of its entries against std::sort with the entries' comparison operator.
+// Sprites are spread over few layers with lots of repeated tie breakers, like sprites sorted by a quantised y.
+// Then measures the render thread time of drawing sprites through the headless renderer, with serial and parallel vertex generation.
+//
+// Usage: halley-sprite-painter-benchmark [--max-sprites N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "headless_renderer.h"
+#include "test_executors.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		size_t maxSprites = 200000;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--max-sprites", options.maxSprites, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	void addSprites(SpritePainter& painter, size_t n, uint32_t seed)
+	{
+		Random rng(seed);
+		for (size_t i = 0; i < n; ++i) {
+			Sprite sprite;
+			sprite.setPosition(Vector2f(rng.getFloat(-1000, 1000), rng.getFloat(-1000, 1000))).setSize(Vector2f(16, 16));
+			const int layer = rng.getInt(-3, 3);
+			const float tieBreaker = float(rng.getInt(-200, 200)) * (rng.getInt(0, 9) == 0 ? -0.0f : 0.5f);
+			painter.addCopy(sprite, 1, layer, tieBreaker);
+		}
+	}
+
+	// Returns the render thread time of drawing n sprites in one frame
+	double measureDraw(HeadlessRenderer& renderer, const std::shared_ptr<const Material>& material, size_t n, bool parallel)
+	{
+		SpritePainter spritePainter;
+		spritePainter.setParallelVertexGeneration(parallel);
+		Random rng(4321u);
+		for (size_t i = 0; i < n; ++i) {
+			Sprite sprite;
+			sprite.setMaterial(material);
+			sprite.setPosition(Vector2f(rng.getFloat(0, 1260), rng.getFloat(0, 700))).setSize(Vector2f(16, 16)).setColour(Colour4f(rng.getFloat(0, 1), 1, 1, 1));
+			spritePainter.add(std::move(sprite), 1, 0, float(i % 100));
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p)
+			{
+				spritePainter.draw(1, p);
+			});
+		});
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	template <typename F>
+	double measure(F f)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Entry sort time (ms):" << std::endl;
+		for (size_t n: { 10000, 30000, 100000, 200000 }) {
+			const auto nSprites = std::min(n, options.maxSprites);
+			SpritePainter painter;
+			addSprites(painter, nSprites, 1234);
+
+			auto entries = Vector<SpritePainterEntry>(painter.getEntries().begin(), painter.getEntries().end());
+			const auto comparisonMs = measure([&] () { std::sort(entries.begin(), entries.end()); });
+			const auto radixMs = measure([&] () { painter.sort(); });
+			if (entries.back().getSortKey() != painter.getEntries().back().getSortKey()) {
+				throw Exception("Sorts disagree", HalleyExceptions::Tools);
+			}
+
+			std::cout << "  " << nSprites << " sprites: std::sort " << comparisonMs << ", radix sort " << radixMs << std::endl;
+			if (nSprites == options.maxSprites) {
+				break;
+			}
+		}
+
+		TestExecutors executors(std::thread::hardware_concurrency());
+		HeadlessRenderer renderer;
+		const auto material = std::make_shared<Material>(renderer.makeSpriteMaterial("Benchmark/Sprite"));
+
+		// Warm up, so the first frame's allocations don't count
+		measureDraw(renderer, material, std::min(size_t(10000), options.maxSprites), false);
+		std::cout << "Render thread time (ms):" << std::endl;
+		for (size_t n: { 10000, 50000, 200000 }) {
+			const auto nSprites = std::min(n, options.maxSprites);
+			const auto serialMs = measureDraw(renderer, material, nSprites, false);
+			const auto parallelMs = measureDraw(renderer, material, nSprites, true);
+			std::cout << "  " << nSprites << " sprites: serial " << serialMs << ", parallel " << parallelMs << std::endl;
+			if (nSprites == options.maxSprites) {
+				break;
+			}
+		}
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Sprite painter benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
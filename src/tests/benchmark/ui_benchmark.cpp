@@ -0,0 +1,195 @@
+// Measures UIRoot::update on a large widget tree where only one label changes per frame, with no window or GPU.
+// The same frames are then run again with every label invalidated, which is what a full layout of the tree costs.
+// Finally, compares UIVirtualList against UIList showing the same long list in a scroll pane.
+//
+// Usage: halley-ui-benchmark [--frames N] [--panels N] [--rows N] [--list-items N]
+
+#include <halley.hpp>
+#include "benchmark_options.h"
+#include "headless_renderer.h"
+#include "ui_list_styles.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace Halley;
+
+namespace {
+	struct Options {
+		int frames = 120;
+		size_t panels = 100;
+		size_t rows = 25;
+		size_t listItems = 5000;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		BenchmarkOptions()
+			.add("--frames", options.frames, 1)
+			.add("--panels", options.panels, 1)
+			.add("--rows", options.rows, 1)
+			.add("--list-items", options.listItems, 1)
+			.parse(argc, argv);
+		return options;
+	}
+
+	// A window holding a grid of panels, each a column of rows with an icon and two labels
+	class BenchmarkUI {
+	public:
+		BenchmarkUI(UIRoot& root, const std::shared_ptr<Font>& font, const Options& options)
+		{
+			const auto text = TextRenderer(font, "", 14);
+			auto window = std::make_shared<UIWidget>("window", Vector2f(), UISizer(UISizerType::Grid, 4.0f, 10));
+			for (size_t i = 0; i < options.panels; ++i) {
+				auto panel = std::make_shared<UIWidget>("panel" + toString(i), Vector2f(), UISizer(UISizerType::Vertical, 2.0f), Vector4f(4, 4, 4, 4));
+				for (size_t j = 0; j < options.rows; ++j) {
+					auto row = std::make_shared<UIWidget>("", Vector2f(), UISizer(UISizerType::Horizontal, 4.0f));
+					row->add(std::make_shared<UIImage>(Sprite().setSize(Vector2f(16, 16))), 0, {}, UISizerAlignFlags::Centre);
+
+					auto name = std::make_shared<UILabel>("", UIStyle(), text, LocalisedString::fromUserString("Row " + toString(j)));
+					row->add(name, 1);
+					auto value = std::make_shared<UILabel>("", UIStyle(), text, LocalisedString::fromUserString(toString(i * options.rows + j)));
+					row->add(value);
+					labels.push_back(value);
+
+					panel->add(row);
+				}
+				window->add(panel);
+			}
+			root.addChild(window);
+		}
+
+		void changeLabel(int frame)
+		{
+			// Alternate lengths, so the label's minimum size changes and layout has to be redone
+			auto& label = *labels[size_t(frame * 7919) % labels.size()];
+			label.setText(LocalisedString::fromUserString(frame % 2 == 0 ? "Changed" : "Changed to something longer"));
+		}
+
+		void invalidateAll()
+		{
+			for (auto& label: labels) {
+				label->markAsNeedingLayout();
+			}
+		}
+
+	private:
+		Vector<std::shared_ptr<UILabel>> labels;
+	};
+
+	size_t countWidgets(UIRoot& root)
+	{
+		size_t n = 0;
+		root.descend([&] (const std::shared_ptr<UIWidget>&) { ++n; });
+		return n;
+	}
+
+	template <typename F>
+	double measureFrames(int frames, F f)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; ++frame) {
+			f(frame);
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / double(frames);
+	}
+
+	// Average UIRoot::update time of a root holding only a scroll pane with list in it, starting from its first frame
+	double measureList(const HalleyAPI& api, int frames, std::shared_ptr<UIWidget> list)
+	{
+		UIRoot root(api, Rect4f(0, 0, 1280, 720));
+		auto pane = std::make_shared<UIScrollPane>("pane", Vector2f(400, 300), UISizer(UISizerType::Vertical));
+		pane->add(std::move(list), 1);
+		root.addChild(pane);
+
+		const auto ms = measureFrames(frames, [&] (int frame)
+		{
+			root.update(1.0 / 60.0, UIInputType::Mouse, {}, {});
+		});
+		BaseFrameData::getCurrent().uiRootData.erase(&root);
+		return ms;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		const auto options = parseOptions(argc, argv);
+
+		// UIRoot::update prepares render data into the current frame
+		DefaultFrameData frameData;
+		BaseFrameData::setThreadFrameData(&frameData);
+
+		HeadlessRenderer renderer;
+		const auto font = renderer.makeFont("Benchmark");
+		UIRoot root(renderer.getAPI(), Rect4f(0, 0, 1280, 720));
+		const auto update = [&] () { root.update(1.0 / 60.0, UIInputType::Mouse, {}, {}); };
+
+		BenchmarkUI ui(root, font, options);
+		const auto firstStart = std::chrono::steady_clock::now();
+		update();
+		const auto firstMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - firstStart).count();
+
+		const auto idleMs = measureFrames(options.frames, [&] (int frame)
+		{
+			update();
+		});
+		const auto oneLabelMs = measureFrames(options.frames, [&] (int frame)
+		{
+			ui.changeLabel(frame);
+			update();
+		});
+		const auto fullLayoutMs = measureFrames(options.frames, [&] (int frame)
+		{
+			ui.changeLabel(frame);
+			ui.invalidateAll();
+			update();
+		});
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "Tree: " << countWidgets(root) << " widgets, " << options.panels << " panels of " << options.rows << " rows" << std::endl;
+		std::cout << "UIRoot::update time (ms):" << std::endl;
+		std::cout << "  First frame: " << firstMs << std::endl;
+		std::cout << "  Nothing changed, average of " << options.frames << " frames: " << idleMs << std::endl;
+		std::cout << "  One label changed per frame, average of " << options.frames << " frames: " << oneLabelMs << std::endl;
+		std::cout << "  Every label invalidated per frame, average of " << options.frames << " frames: " << fullLayoutMs << std::endl;
+
+		// The list stylesheet's text renderer needs this font
+		const auto listFont = renderer.makeFont("Ubuntu Bold");
+		const auto styleFile = ConfigFile(makeListStyles());
+		const auto styleSheet = std::make_shared<UIStyleSheet>(renderer.getResources(), styleFile, std::make_shared<UIColourScheme>());
+
+		const auto listStyle = UIStyle("list", styleSheet);
+		auto virtualList = std::make_shared<UIVirtualList>("list", listStyle, [&] ()
+		{
+			return std::make_shared<UILabel>("label", listStyle, TextRenderer(listFont, "", 16), LocalisedString());
+		}, [] (UIWidget& contents, size_t idx)
+		{
+			dynamic_cast<UILabel&>(contents).setText(LocalisedString::fromUserString("Item " + toString(idx)));
+		});
+		Vector<String> ids;
+		for (size_t i = 0; i < options.listItems; ++i) {
+			ids.push_back("item" + toString(i));
+		}
+		virtualList->setItems(std::move(ids));
+		const auto virtualListMs = measureList(renderer.getAPI(), options.frames, std::move(virtualList));
+
+		auto uiList = std::make_shared<UIList>("uiList", UIStyle("uiList", styleSheet));
+		for (size_t i = 0; i < options.listItems; ++i) {
+			uiList->addTextItem("item" + toString(i), LocalisedString::fromUserString("Item " + toString(i)));
+		}
+		const auto uiListMs = measureList(renderer.getAPI(), options.frames, std::move(uiList));
+
+		std::cout << "List of " << options.listItems << " items, average UIRoot::update time of " << options.frames << " frames from the first (ms):" << std::endl;
+		std::cout << "  UIVirtualList: " << virtualListMs << std::endl;
+		std::cout << "  UIList: " << uiListMs << std::endl;
+
+		frameData.uiRootData.clear();
+		BaseFrameData::setThreadFrameData(nullptr);
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "UI benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/assets/asset_collector.h"
+#include "halley/bytes/compression.h"
+
+using namespace Halley;
+
+namespace {
+	// The first randomFraction of the data is incompressible, the rest is all zeroes
+	Bytes makeData(size_t size, float randomFraction)
+	{
+		Random rng(1234u);
+		Bytes data(size, 0);
+		rng.getBytes(gsl::span<Byte>(data.data(), size_t(float(size) * randomFraction)));
+		return data;
+	}
+
+	struct CollectedAsset {
+		Bytes data;
+		Metadata metadata;
+	};
+
+	CollectedAsset collect(AssetType type, const Bytes& data, const String& compression)
+	{
+		ImportingAsset asset;
+		AssetCollector collector(asset, Path(), {}, {});
+		Metadata meta;
+		meta.set("asset_compression", compression);
+		collector.output("test", type, data, meta, "pc", Path());
+
+		auto outFiles = collector.collectOutFiles();
+		EXPECT_EQ(outFiles.size(), 1);
+		return { outFiles.at(0).second.value(), collector.getAssets().at(0).platformVersions.at("pc").metadata };
+	}
+
+	Bytes decompress(const Bytes& data)
+	{
+		size_t size = 0;
+		const auto result = Compression::lz4DecompressAnyToSharedPtr(data.byte_span(), size);
+		return Bytes(reinterpret_cast<const Byte*>(result.get()), reinterpret_cast<const Byte*>(result.get()) + size);
+	}
+}
+
+TEST(AssetCollector, AutoCompressionKeepsWhatCompresses)
+{
+	const auto data = makeData(256 * 1024, 0.1f);
+	const auto result = collect(AssetType::ConfigFile, data, "auto");
+	EXPECT_EQ(result.metadata.getString("asset_compression", ""), "lz4");
+	EXPECT_LT(result.data.size(), data.size() / 2);
+	EXPECT_EQ(decompress(result.data), data);
+}
+
+TEST(AssetCollector, AutoCompressionDropsWhatDoesNot)
+{
+	const auto data = makeData(256 * 1024, 1.0f);
+	const auto result = collect(AssetType::ConfigFile, data, "auto");
+	EXPECT_FALSE(result.metadata.hasKey("asset_compression"));
+	EXPECT_EQ(result.data, data);
+
+	// Nothing to gain from compressing nothing
+	const auto empty = collect(AssetType::ConfigFile, Bytes(), "auto");
+	EXPECT_FALSE(empty.metadata.hasKey("asset_compression"));
+	EXPECT_TRUE(empty.data.empty());
+
+	// Explicit compression is always kept
+	const auto forced = collect(AssetType::ConfigFile, data, "lz4");
+	EXPECT_EQ(forced.metadata.getString("asset_compression", ""), "lz4");
+	EXPECT_EQ(decompress(forced.data), data);
+}
+
+TEST(AssetCollector, AutoCompressionThresholdDependsOnType)
+{
+	// Compresses to about 80%: worth it for most assets, but not for streamed audio
+	const auto data = makeData(256 * 1024, 0.8f);
+
+	const auto config = collect(AssetType::ConfigFile, data, "auto");
+	EXPECT_EQ(config.metadata.getString("asset_compression", ""), "lz4");
+	EXPECT_LT(config.data.size(), data.size());
+
+	const auto audio = collect(AssetType::AudioClip, data, "auto");
+	EXPECT_FALSE(audio.metadata.hasKey("asset_compression"));
+	EXPECT_EQ(audio.data, data);
+}
@@ -0,0 +1,322 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/resources/asset_pack.h"
+#include "halley/resources/asset_database.h"
+#include "halley/utils/encrypt.h"
+#include "halley/bytes/compression.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t nAssets = 512;
+	constexpr size_t assetSize = 32 * 1024;
+
+	String getAssetName(size_t i)
+	{
+		return "asset" + toString(i);
+	}
+
+	const std::array<uint8_t, 16> testKey = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+	Byte getExpectedByte(size_t i)
+	{
+		return static_cast<Byte>((i * 31 + i / assetSize) & 0xFF);
+	}
+
+	AssetPack makeTestPack()
+	{
+		AssetPack pack;
+		auto& data = pack.getData();
+		data.resize(nAssets * assetSize);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = getExpectedByte(i);
+		}
+		for (size_t i = 0; i < nAssets; ++i) {
+			pack.getAssetDatabase().addAsset(getAssetName(i), AssetType::BinaryFile, AssetDatabase::Entry(toString(i * assetSize) + ":" + toString(assetSize), Metadata()));
+		}
+		return pack;
+	}
+
+	Path writeTestFile(const Bytes& bytes)
+	{
+		const auto path = std::filesystem::temp_directory_path() / "halley_asset_pack_test.dat";
+		std::ofstream out(path, std::ios::binary);
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return Path(path.string());
+	}
+
+	Path writeTestPack(bool encrypted = false)
+	{
+		auto pack = makeTestPack();
+		if (encrypted) {
+			pack.encrypt(testKey);
+		}
+		return writeTestFile(pack.writeOut());
+	}
+
+	void checkAsset(AssetPack& pack, size_t idx)
+	{
+		const auto data = pack.getData(getAssetName(idx), AssetType::BinaryFile, false);
+		ASSERT_TRUE(data);
+		const auto span = dynamic_cast<ResourceDataStatic&>(*data).getSpan();
+		ASSERT_EQ(assetSize, size_t(span.size()));
+		for (size_t j = 0; j < assetSize; j += 97) {
+			ASSERT_EQ(getExpectedByte(idx * assetSize + j), static_cast<Byte>(span[j]));
+		}
+	}
+
+	// Positioned reads from memory, without exposing a mapping, like a mapped file reader whose mapping failed
+	class MemoryReadAtReader final : public ResourceDataReader {
+	public:
+		explicit MemoryReadAtReader(Bytes bytes) : bytes(std::move(bytes)) {}
+
+		size_t size() const override { return bytes.size(); }
+		int read(gsl::span<gsl::byte> dst) override
+		{
+			const int n = readAt(pos, dst);
+			pos += size_t(n);
+			return n;
+		}
+		void seek(int64_t p, int whence) override { pos = size_t(p); }
+		size_t tell() const override { return pos; }
+		void close() override {}
+
+		bool supportsReadAt() const override { return true; }
+		int readAt(size_t p, gsl::span<gsl::byte> dst) override
+		{
+			const size_t n = p < bytes.size() ? std::min(bytes.size() - p, size_t(dst.size())) : 0;
+			memcpy(dst.data(), bytes.data() + p, n);
+			return int(n);
+		}
+
+	private:
+		Bytes bytes;
+		size_t pos = 0;
+	};
+
+	// Loads every asset from nThreads threads at once, returning the sum of one byte per page across all of them
+	uint64_t loadConcurrently(AssetPack& pack, size_t nThreads)
+	{
+		std::atomic<uint64_t> total = 0;
+		Vector<std::thread> threads;
+		for (size_t t = 0; t < nThreads; ++t) {
+			threads.emplace_back([&, t] () {
+				uint64_t sum = 0;
+				for (size_t i = 0; i < nAssets; ++i) {
+					const auto data = pack.getData(getAssetName((i + t * 37) % nAssets), AssetType::BinaryFile, false);
+					const auto span = dynamic_cast<ResourceDataStatic&>(*data).getSpan();
+					for (size_t j = 0; j < span.size(); j += 4096) {
+						sum += static_cast<uint8_t>(span[j]);
+					}
+				}
+				total += sum;
+			});
+		}
+		for (auto& t: threads) {
+			t.join();
+		}
+		return total.load();
+	}
+}
+
+TEST(AssetPack, ConcurrentLoads)
+{
+	constexpr size_t nThreads = 4;
+	const auto path = writeTestPack();
+
+	uint64_t expected = 0;
+	for (size_t i = 0; i < nAssets * assetSize; i += 4096) {
+		expected += static_cast<uint8_t>(getExpectedByte(i));
+	}
+
+	AssetPack locked(std::make_unique<ResourceDataReaderFileSystem>(path), std::nullopt, false);
+	EXPECT_EQ(expected * nThreads, loadConcurrently(locked, nThreads));
+
+	auto mappedReader = ResourceDataReaderMappedFile::tryOpen(path);
+	ASSERT_TRUE(mappedReader);
+	AssetPack mapped(std::move(mappedReader), std::nullopt, false);
+	EXPECT_EQ(expected * nThreads, loadConcurrently(mapped, nThreads));
+
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, MappedReaderReadAt)
+{
+	const auto path = writeTestPack();
+	auto reader = ResourceDataReaderMappedFile::tryOpen(path);
+	ASSERT_TRUE(reader);
+	EXPECT_TRUE(reader->supportsReadAt());
+
+	std::array<gsl::byte, 16> a;
+	std::array<gsl::byte, 16> b;
+	reader->seek(100, SEEK_SET);
+	EXPECT_EQ(16, reader->read(a));
+	EXPECT_EQ(16, reader->readAt(100, b));
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(116u, reader->tell());
+
+	EXPECT_EQ(4, reader->readAt(reader->size() - 4, b));
+	EXPECT_EQ(0, reader->readAt(reader->size() + 10, b));
+
+	reader.reset();
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, TruncatedPackThrows)
+{
+	auto bytes = makeTestPack().writeOut();
+	bytes.resize(bytes.size() - assetSize / 2);
+	const auto path = writeTestFile(bytes);
+
+	AssetPack locked(std::make_unique<ResourceDataReaderFileSystem>(path), std::nullopt, false);
+	checkAsset(locked, 0);
+	EXPECT_THROW(locked.getData(getAssetName(nAssets - 1), AssetType::BinaryFile, false), Exception);
+
+	AssetPack lockFree(std::make_unique<MemoryReadAtReader>(bytes), std::nullopt, false);
+	checkAsset(lockFree, 0);
+	EXPECT_THROW(lockFree.getData(getAssetName(nAssets - 1), AssetType::BinaryFile, false), Exception);
+
+	AssetPack mapped(ResourceDataReaderMappedFile::tryOpen(path), std::nullopt, false);
+	EXPECT_THROW(mapped.getData(getAssetName(nAssets - 1), AssetType::BinaryFile, false), Exception);
+
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, MappedDataOutlivesPack)
+{
+	const auto path = writeTestPack();
+
+	std::unique_ptr<ResourceData> data;
+	{
+		AssetPack pack(ResourceDataReaderMappedFile::tryOpen(path), std::nullopt, false);
+		data = pack.getData(getAssetName(7), AssetType::BinaryFile, false);
+	}
+
+	const auto span = dynamic_cast<ResourceDataStatic&>(*data).getSpan();
+	ASSERT_EQ(assetSize, size_t(span.size()));
+	for (size_t j = 0; j < assetSize; j += 97) {
+		ASSERT_EQ(getExpectedByte(7 * assetSize + j), static_cast<Byte>(span[j]));
+	}
+
+	data.reset();
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, EncryptCTRRanges)
+{
+	std::array<uint8_t, 16> iv;
+	for (size_t i = 0; i < iv.size(); ++i) {
+		iv[i] = static_cast<uint8_t>(0xF0 + i); // Close to overflowing, so the counter carries across bytes
+	}
+
+	Bytes plain(1000);
+	for (size_t i = 0; i < plain.size(); ++i) {
+		plain[i] = static_cast<Byte>(i * 7);
+	}
+	auto whole = plain;
+	Encrypt::applyAESCTR(iv, testKey, 0, gsl::as_writable_bytes(gsl::span<Byte>(whole)));
+	EXPECT_NE(plain, whole);
+
+	// Any sub-range encrypted on its own has to match the same range of the whole buffer
+	for (const auto& [start, len]: { std::pair<size_t, size_t>{ 0, 1 }, { 5, 3 }, { 15, 2 }, { 16, 16 }, { 17, 100 }, { 333, 667 } }) {
+		Bytes part(plain.begin() + start, plain.begin() + start + len);
+		Encrypt::applyAESCTR(iv, testKey, start, gsl::as_writable_bytes(gsl::span<Byte>(part)));
+		EXPECT_TRUE(std::equal(part.begin(), part.end(), whole.begin() + start)) << start << ":" << len;
+	}
+
+	Encrypt::applyAESCTR(iv, testKey, 0, gsl::as_writable_bytes(gsl::span<Byte>(whole)));
+	EXPECT_EQ(plain, whole);
+}
+
+TEST(AssetPack, EncryptedPackLoads)
+{
+	const auto path = writeTestPack(true);
+
+	for (bool preLoad: { false, true }) {
+		AssetPack mapped(ResourceDataReaderMappedFile::tryOpen(path), gsl::span<const uint8_t, 16>(testKey), preLoad);
+		AssetPack file(std::make_unique<ResourceDataReaderFileSystem>(path), gsl::span<const uint8_t, 16>(testKey), preLoad);
+		for (size_t i: { 0, 1, 255, 511 }) {
+			checkAsset(mapped, i);
+			checkAsset(file, i);
+		}
+	}
+
+	// Streamed reads at offsets that don't line up with AES blocks
+	AssetPack pack(ResourceDataReaderMappedFile::tryOpen(path), gsl::span<const uint8_t, 16>(testKey), false);
+	const auto stream = pack.getData(getAssetName(3), AssetType::BinaryFile, true);
+	auto reader = dynamic_cast<ResourceDataStream&>(*stream).getReader();
+	reader->seek(7, SEEK_SET);
+	std::array<gsl::byte, 21> buffer;
+	EXPECT_EQ(21, reader->read(buffer));
+	for (size_t j = 0; j < buffer.size(); ++j) {
+		EXPECT_EQ(getExpectedByte(3 * assetSize + 7 + j), static_cast<Byte>(buffer[j]));
+	}
+
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, IndexLookup)
+{
+	const auto path = writeTestPack();
+
+	for (bool preLoad: { false, true }) {
+		AssetPack pack(ResourceDataReaderMappedFile::tryOpen(path), std::nullopt, preLoad);
+		for (size_t i = 0; i < nAssets; i += 17) {
+			checkAsset(pack, i);
+		}
+		EXPECT_FALSE(pack.getData("missing", AssetType::BinaryFile, false));
+		EXPECT_FALSE(pack.getData(getAssetName(0), AssetType::Sprite, false));
+	}
+
+	// Packs assembled in memory are looked up through the database
+	auto inMemory = makeTestPack();
+	checkAsset(inMemory, 5);
+
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, LegacyPackLoads)
+{
+	// Version 1 packs have no index, so one gets built from the database
+	auto pack = makeTestPack();
+	const auto assetDbBytes = Compression::compress(Serializer::toBytes(pack.getAssetDatabase()));
+	AssetPackHeader header;
+	header.init(1, 0, assetDbBytes.size());
+
+	Bytes bytes(size_t(header.dataStartPos) + pack.getData().size());
+	memcpy(bytes.data(), &header, sizeof(header));
+	memcpy(bytes.data() + header.assetDbStartPos, assetDbBytes.data(), assetDbBytes.size());
+	memcpy(bytes.data() + header.dataStartPos, pack.getData().data(), pack.getData().size());
+	const auto path = writeTestFile(bytes);
+
+	AssetPack loaded(std::make_unique<ResourceDataReaderFileSystem>(path), std::nullopt, false);
+	for (size_t i: { 0, 100, 511 }) {
+		checkAsset(loaded, i);
+	}
+
+	std::filesystem::remove(path.string());
+}
+
+TEST(AssetPack, IndexMatchesDatabase)
+{
+	constexpr size_t nNames = 1000;
+	AssetDatabase db;
+	Vector<String> names;
+	for (size_t i = 0; i < nNames; ++i) {
+		names.push_back("sprites/level_" + toString(i % 50) + "/object_" + toString(i));
+		db.addAsset(names.back(), AssetType::Sprite, AssetDatabase::Entry(toString(i * 1000) + ":1000", Metadata()));
+	}
+	const auto index = AssetPackIndex::fromDatabase(db);
+	const auto view = AssetPackIndex::fromView(index.getBytes());
+
+	for (size_t i = 0; i < nNames; ++i) {
+		const auto* entry = view.tryGet(names[i], AssetType::Sprite);
+		ASSERT_TRUE(entry);
+		EXPECT_EQ(i * 1000, entry->pos);
+		EXPECT_EQ(1000u, entry->size);
+		EXPECT_FALSE(view.tryGet(names[i], AssetType::Animation));
+	}
+	EXPECT_FALSE(view.tryGet("sprites/level_0/object_missing", AssetType::Sprite));
+}
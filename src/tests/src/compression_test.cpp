@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_executors.h"
+#include "halley/bytes/compression.h"
+
+using namespace Halley;
+
+namespace {
+	// Somewhat compressible, with an incompressible stretch in the middle
+	Bytes makeTestData(size_t size)
+	{
+		Bytes data(size);
+		Random rng(777u);
+		for (size_t i = 0; i < size; ++i) {
+			const bool noisy = i > size / 3 && i < size / 2;
+			data[i] = noisy ? static_cast<Byte>(rng.getInt(0, 255)) : static_cast<Byte>((i / 7) % 13);
+		}
+		return data;
+	}
+
+	class MemoryReader final : public ResourceDataReader {
+	public:
+		MemoryReader(Bytes data) : data(std::move(data)) {}
+
+		size_t size() const override { return data.size(); }
+		int read(gsl::span<gsl::byte> dst) override
+		{
+			const size_t n = std::min(size_t(dst.size()), data.size() - std::min(pos, data.size()));
+			memcpy(dst.data(), data.data() + pos, n);
+			pos += n;
+			return int(n);
+		}
+		void seek(int64_t p, int whence) override { pos = whence == SEEK_SET ? size_t(p) : whence == SEEK_CUR ? size_t(pos + p) : size_t(data.size() + p); }
+		size_t tell() const override { return pos; }
+		void close() override {}
+
+	private:
+		Bytes data;
+		size_t pos = 0;
+	};
+}
+
+TEST(Compression, LZ4ChunkedRoundTrip)
+{
+	for (size_t size: { size_t(0), size_t(1), size_t(1000), size_t(64 * 1024), size_t(300 * 1024 + 17) }) {
+		const auto data = makeTestData(size);
+		const auto compressed = Compression::lz4CompressChunked(data.byte_span(), {}, 16 * 1024);
+		ASSERT_TRUE(Compression::readLZ4ChunkedHeader(compressed.byte_span()).has_value());
+
+		size_t outSize = 0;
+		const auto result = Compression::lz4DecompressAnyToSharedPtr(compressed.byte_span(), outSize);
+		ASSERT_EQ(size, outSize);
+		EXPECT_EQ(0, memcmp(result.get(), data.data(), size));
+	}
+
+	// Regular LZ4 files still decompress
+	const auto data = makeTestData(5000);
+	const auto legacy = Compression::lz4CompressFile(data.byte_span(), {});
+	EXPECT_FALSE(Compression::readLZ4ChunkedHeader(legacy.byte_span()).has_value());
+	size_t outSize = 0;
+	const auto result = Compression::lz4DecompressAnyToSharedPtr(legacy.byte_span(), outSize);
+	ASSERT_EQ(data.size(), outSize);
+	EXPECT_EQ(0, memcmp(result.get(), data.data(), data.size()));
+}
+
+TEST(Compression, LZ4ChunkedStream)
+{
+	const auto data = makeTestData(200 * 1024 + 5);
+	ResourceDataReaderLZ4Chunked reader(std::make_unique<MemoryReader>(Compression::lz4CompressChunked(data.byte_span(), {}, 8 * 1024)));
+	ASSERT_EQ(data.size(), reader.size());
+
+	// Sequential reads in sizes that straddle chunks
+	Bytes result;
+	std::array<gsl::byte, 3001> buffer;
+	while (true) {
+		const int n = reader.read(buffer);
+		if (n == 0) {
+			break;
+		}
+		result.insert(result.end(), reinterpret_cast<Byte*>(buffer.data()), reinterpret_cast<Byte*>(buffer.data()) + n);
+	}
+	EXPECT_EQ(data, result);
+
+	// Random access
+	for (size_t pos: { size_t(8191), size_t(0), size_t(100000), size_t(data.size() - 10) }) {
+		reader.seek(int64_t(pos), SEEK_SET);
+		std::array<gsl::byte, 10> small;
+		ASSERT_EQ(10, reader.read(small));
+		EXPECT_EQ(0, memcmp(small.data(), data.data() + pos, small.size()));
+	}
+	EXPECT_EQ(0, reader.read(buffer));
+}
+
+TEST(Compression, LZ4ChunkedParallel)
+{
+	TestExecutors executors;
+
+	const auto data = makeTestData(4 * 1024 * 1024 + 3);
+	const auto chunked = Compression::lz4CompressChunked(data.byte_span(), {}, 64 * 1024);
+
+	size_t outSize = 0;
+	const auto result = Compression::lz4DecompressAnyToSharedPtr(chunked.byte_span(), outSize, &Executors::getCPU());
+	ASSERT_EQ(data.size(), outSize);
+	EXPECT_EQ(0, memcmp(result.get(), data.data(), data.size()));
+}
@@ -30,3 +30,66 @@ TEST(HalleyConfigNode, Sequence)
 	EXPECT_TRUE(node.getType() == ConfigNodeType::Sequence);
 	EXPECT_EQ(node.asSequence().size(), 1);
 }
+
+namespace {
+	template <typename T>
+	uint64_t getFieldHash(const T& value)
+	{
+		EntitySerializationContext context;
+		Hash::Hasher hasher;
+		ConfigNodeHelper<T>::feedToHash(value, context, hasher);
+		return hasher.digest();
+	}
+
+	// Constructs value over storage full of garbage, so any padding fed to the hash would show up
+	template <typename T, typename... Args>
+	T* constructOverGarbage(std::array<std::byte, sizeof(T)>& storage, std::byte garbage, Args&&... args)
+	{
+		std::fill(storage.begin(), storage.end(), garbage);
+		return new (storage.data()) T(std::forward<Args>(args)...);
+	}
+}
+
+TEST(HalleyConfigNodeHash, EqualValuesHashEqual)
+{
+	EXPECT_EQ(getFieldHash(String("hello")), getFieldHash(String("hello")));
+	EXPECT_EQ(getFieldHash(Vector2f(1, 2)), getFieldHash(Vector2f(1, 2)));
+	EXPECT_EQ(getFieldHash(Vector<int>{ 1, 2, 3 }), getFieldHash(Vector<int>{ 1, 2, 3 }));
+	EXPECT_EQ(getFieldHash(ResourceReference<SpriteResource>()), getFieldHash(ResourceReference<SpriteResource>()));
+
+	// A disengaged optional must not hash whatever it used to hold
+	std::optional<int> reset = 5;
+	reset.reset();
+	EXPECT_EQ(getFieldHash(reset), getFieldHash(std::optional<int>()));
+	OptionalLite<uint8_t> resetLite = 7;
+	resetLite.reset();
+	EXPECT_EQ(getFieldHash(resetLite), getFieldHash(OptionalLite<uint8_t>()));
+
+	// Padding bytes must not be fed
+	using Pair = std::pair<EntityId, uint8_t>;
+	alignas(Pair) std::array<std::byte, sizeof(Pair)> a;
+	alignas(Pair) std::array<std::byte, sizeof(Pair)> b;
+	const auto* pairA = constructOverGarbage<Pair>(a, std::byte(0xAA), EntityId(42), uint8_t(3));
+	const auto* pairB = constructOverGarbage<Pair>(b, std::byte(0x55), EntityId(42), uint8_t(3));
+	EXPECT_EQ(getFieldHash(*pairA), getFieldHash(*pairB));
+	EXPECT_EQ(getFieldHash(Vector<Pair>{ *pairA }), getFieldHash(Vector<Pair>{ *pairB }));
+}
+
+TEST(HalleyConfigNodeHash, ChangesAlterHash)
+{
+	EXPECT_NE(getFieldHash(String("hello")), getFieldHash(String("hellp")));
+	EXPECT_NE(getFieldHash(Vector2f(1, 2)), getFieldHash(Vector2f(2, 1)));
+	EXPECT_NE(getFieldHash(Vector<int>{ 1, 2, 3 }), getFieldHash(Vector<int>{ 1, 2 }));
+	EXPECT_NE(getFieldHash(std::optional<int>(0)), getFieldHash(std::optional<int>()));
+	EXPECT_NE(getFieldHash(Vector<String>{ "ab", "c" }), getFieldHash(Vector<String>{ "a", "bc" }));
+	EXPECT_NE(getFieldHash(std::pair<EntityId, uint8_t>(EntityId(1), 2)), getFieldHash(std::pair<EntityId, uint8_t>(EntityId(1), 3)));
+
+	Sprite sprite;
+	const auto original = getFieldHash(sprite);
+	EXPECT_EQ(getFieldHash(Sprite()), original);
+	sprite.setColour(Colour4f(1, 0, 0, 1));
+	EXPECT_NE(getFieldHash(sprite), original);
+	sprite.setColour(Colour4f(1, 1, 1, 1));
+	sprite.setVisible(false);
+	EXPECT_NE(getFieldHash(sprite), original);
+}
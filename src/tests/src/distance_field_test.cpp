@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "distance_field_reference.h"
+#include "test_executors.h"
+#include "halley/tools/distance_field/distance_field_generator.h"
+
+using namespace Halley;
+
+TEST(DistanceField, MatchesBruteForce)
+{
+	TestExecutors executors;
+
+	for (const auto& [srcSize, dstSize, radius]: { std::tuple<int, int, float>{ 64, 64, 4.0f }, { 128, 32, 2.5f }, { 256, 64, 6.0f }, { 256, 256, 0.0f } }) {
+		auto src = makeDistanceFieldShapes(Vector2i(srcSize, srcSize));
+		const auto expected = generateReferenceSDF(*src, Vector2i(dstSize, dstSize), radius);
+		const auto result = DistanceFieldGenerator::generateSDF(*src, Vector2i(dstSize, dstSize), radius);
+
+		// The brute force gave up past its search window, where the exact distance is already almost fully saturated
+		const auto e = expected->getPixelBytes();
+		const auto r = result->getPixelBytes();
+		ASSERT_EQ(e.size(), r.size());
+		int maxDiff = 0;
+		size_t nDiff = 0;
+		for (size_t i = 0; i < e.size(); ++i) {
+			const int diff = std::abs(int(e[i]) - int(r[i]));
+			maxDiff = std::max(maxDiff, diff);
+			nDiff += diff > 0 ? 1 : 0;
+		}
+		EXPECT_LE(maxDiff, 8) << srcSize << " -> " << dstSize << ", radius " << radius;
+		EXPECT_LE(nDiff, e.size() / 50) << srcSize << " -> " << dstSize << ", radius " << radius;
+	}
+}
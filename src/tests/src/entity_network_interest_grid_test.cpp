@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/net/entity/entity_network_interest_grid.h"
+
+using namespace Halley;
+
+TEST(EntityNetworkInterestGrid, MatchesBruteForce)
+{
+	Random rng(1234u);
+	Vector<std::optional<Vector2i>> positions;
+	for (int i = 0; i < 2000; ++i) {
+		if (i % 50 == 0) {
+			positions.push_back(std::nullopt);
+		} else {
+			positions.push_back(Vector2i(rng.getInt(-5000, 5000), rng.getInt(-5000, 5000)));
+		}
+	}
+
+	EntityNetworkInterestGrid grid(512);
+	for (size_t i = 0; i < positions.size(); ++i) {
+		grid.add(i, positions[i]);
+	}
+	grid.build();
+
+	for (int q = 0; q < 100; ++q) {
+		const auto p = Vector2i(rng.getInt(-6000, 6000), rng.getInt(-6000, 6000));
+		const auto rect = Rect4i(p, p + Vector2i(rng.getInt(0, 2000), rng.getInt(0, 2000)));
+
+		Vector<size_t> expected;
+		for (size_t i = 0; i < positions.size(); ++i) {
+			if (!positions[i] || rect.contains(*positions[i])) {
+				expected.push_back(i);
+			}
+		}
+
+		Vector<size_t> result;
+		grid.query(rect, result);
+		EXPECT_EQ(expected, result);
+	}
+}
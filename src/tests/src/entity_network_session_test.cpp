@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/net/entity/entity_network_session.h"
+
+using namespace Halley;
+
+TEST(EntityNetworkSerializationStats, SharedAndUnchangedEntitiesCountOnce)
+{
+	// Three peers all see entity 1, two of them also see entity 2, and one sees entity 3
+	Vector<int> requests = { 1, 2, 3, 1, 2, 1 };
+	const size_t unique = 3;
+
+	// Nothing reused: three serializations shared by six requests
+	EntityNetworkSerializationStats stats;
+	stats.update(requests.size(), unique, 0, 0.3);
+	EXPECT_EQ(stats.requested, 6u);
+	EXPECT_EQ(stats.serialized, 3u);
+	EXPECT_EQ(stats.unchanged, 0u);
+	EXPECT_EQ(stats.getSaved(), 3u);
+	EXPECT_DOUBLE_EQ(stats.savedTime, 0.3);
+
+	// Entity 1 didn't change, so only two serializations were done for all six requests
+	stats.update(requests.size(), unique, 1, 0.2);
+	EXPECT_EQ(stats.serialized, 2u);
+	EXPECT_EQ(stats.unchanged, 1u);
+	EXPECT_EQ(stats.getSaved(), 4u);
+	EXPECT_EQ(stats.serialized + stats.getSaved(), stats.requested);
+	EXPECT_DOUBLE_EQ(stats.savedTime, 0.4);
+
+	// Nothing changed: nothing serialized, and no time to estimate the savings from
+	stats.update(requests.size(), unique, unique, 0);
+	EXPECT_EQ(stats.serialized, 0u);
+	EXPECT_EQ(stats.getSaved(), 6u);
+	EXPECT_EQ(stats.savedTime, 0);
+}
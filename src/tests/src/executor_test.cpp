@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_executors.h"
+
+using namespace Halley;
+
+namespace {
+	// Queues nOuter tasks which each queue nInner more from inside the pool, and waits for all of them to run
+	void runSpawnTasks(size_t nThreads, int nOuter, int nInner)
+	{
+		TestExecutors executors(nThreads);
+
+		std::atomic<int> count = 0;
+
+		Vector<Future<void>> futures;
+		for (int i = 0; i < nOuter; ++i) {
+			futures.push_back(Concurrent::execute(Executors::getCPU(), [&] () {
+				for (int j = 0; j < nInner; ++j) {
+					Executors::getCPU().addToQueue([&] () { ++count; });
+				}
+				++count;
+			}));
+		}
+		Concurrent::whenAll(futures.begin(), futures.end()).wait();
+		while (count.load() < nOuter * (nInner + 1)) {
+			std::this_thread::yield();
+		}
+
+		EXPECT_EQ(nOuter * (nInner + 1), count.load());
+	}
+}
+
+TEST(Executor, TaskBaseStorage)
+{
+	int calls = 0;
+	TaskBase small([&] () { ++calls; });
+	std::array<char, 256> big = {};
+	big[0] = 1;
+	TaskBase large([&calls, big] () { calls += big[0]; });
+
+	TaskBase moved = std::move(large);
+	EXPECT_FALSE(large);
+	EXPECT_TRUE(moved);
+
+	small();
+	moved();
+	EXPECT_EQ(2, calls);
+
+	auto shared = std::make_shared<int>(0);
+	{
+		TaskBase holder([shared] () {});
+		EXPECT_EQ(2, shared.use_count());
+	}
+	EXPECT_EQ(1, shared.use_count());
+}
+
+TEST(Executor, RunPending)
+{
+	ExecutionQueue queue;
+	Executor executor(queue);
+
+	int value = 0;
+	for (int i = 0; i < 10; ++i) {
+		queue.addToQueue([&value, i] () { value = value * 10 + (i % 10); });
+	}
+	executor.runUpTo(4);
+	EXPECT_EQ(123, value);
+	executor.runPending();
+	EXPECT_EQ(123456789, value);
+}
+
+TEST(Executor, AbortDiscardsWorkerTasks)
+{
+	ExecutionQueue queue;
+	queue.setWorkStealing(true);
+	Executor executor(queue);
+
+	std::atomic<int> ran = 0;
+	std::atomic<bool> queued = false;
+	std::atomic<bool> stopped = false;
+	queue.addToQueue([&] () {
+		// Queued from the worker, so these go into its own deque
+		for (int i = 0; i < 100; ++i) {
+			queue.addToQueue([&] () { ++ran; });
+		}
+		queued = true;
+		while (!stopped) {
+			std::this_thread::yield();
+		}
+	});
+
+	std::thread thread([&] () { executor.runForever(); });
+	while (!queued) {
+		std::this_thread::yield();
+	}
+	executor.stop();
+	stopped = true;
+	thread.join();
+
+	EXPECT_EQ(0, ran.load());
+	EXPECT_TRUE(queue.getAll().empty());
+}
+
+TEST(Executor, WorkStealingRunsAllTasks)
+{
+	runSpawnTasks(4, 200, 2000);
+}
+
+TEST(Executor, ParallelFor)
+{
+	TestExecutors executors;
+
+	for (size_t grainSize: { 0, 1, 7, 1000 }) {
+		Vector<int> hits(10000, 0);
+		Concurrent::parallelFor(hits.size(), grainSize, [&] (size_t start, size_t end) {
+			for (size_t i = start; i < end; ++i) {
+				++hits[i];
+			}
+		});
+		EXPECT_EQ(hits.size(), size_t(std::count(hits.begin(), hits.end(), 1)));
+	}
+
+	const auto sum = Concurrent::parallelReduce(size_t(100000), 0, int64_t(0), [] (size_t start, size_t end) {
+		int64_t partial = 0;
+		for (size_t i = start; i < end; ++i) {
+			partial += int64_t(i);
+		}
+		return partial;
+	}, [] (int64_t a, int64_t b) { return a + b; });
+	EXPECT_EQ(int64_t(100000) * 99999 / 2, sum);
+
+	EXPECT_THROW(Concurrent::parallelFor(100, 1, [] (size_t start, size_t end) {
+		if (start == 50) {
+			throw Exception("Test", HalleyExceptions::Concurrency);
+		}
+	}), Exception);
+}
+
+TEST(Executor, NestedParallelFor)
+{
+	// More outer chunks than threads, each blocking on an inner loop, would deadlock if callers didn't help
+	TestExecutors executors(2);
+
+	std::atomic<int> count = 0;
+	Concurrent::parallelFor(16, 1, [&] (size_t, size_t) {
+		Concurrent::parallelFor(16, 1, [&] (size_t, size_t) {
+			Concurrent::parallelFor(16, 1, [&] (size_t, size_t) {
+				++count;
+			});
+		});
+	});
+	EXPECT_EQ(16 * 16 * 16, count.load());
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_components.h"
+#include "test_world.h"
+#include <chrono>
+
+using namespace Halley;
+
+namespace {
+	EntityId getElementId(const Family& family, size_t idx)
+	{
+		return static_cast<const FamilyBase*>(family.getElement(idx))->entityId;
+	}
+
+	const void* getPositionAddress(const Family& family, size_t idx)
+	{
+		return &static_cast<const TestMovementFamily*>(family.getElement(idx))->position;
+	}
+
+	void checkIndex(const Family& family)
+	{
+		for (size_t i = 0; i < family.count(); ++i) {
+			EXPECT_EQ(family.tryGetElementIndex(getElementId(family, i)), i);
+		}
+	}
+
+	// Exposes the updates that World would drive, so the family can be tested on its own
+	template <typename T>
+	class TestFamily : public FamilyImpl<T> {
+	public:
+		using FamilyImpl<T>::FamilyImpl;
+		using FamilyImpl<T>::addEntity;
+		using FamilyImpl<T>::refreshEntity;
+		using FamilyImpl<T>::removeEntity;
+		using FamilyImpl<T>::updateEntities;
+	};
+
+	EntityId spawn(World& world)
+	{
+		auto e = world.createEntity();
+		e.addComponent(TestPositionComponent());
+		e.addComponent(TestVelocityComponent());
+		return e.getEntityId();
+	}
+
+	// Counts entities whose element is missing, or whose optional reference doesn't match the entity's component
+	size_t countOptionalMismatches(World& world, const Family& family, const Vector<EntityId>& ids)
+	{
+		size_t mismatches = 0;
+		for (auto id: ids) {
+			const auto idx = family.tryGetElementIndex(id);
+			if (!idx || *idx >= family.count()) {
+				++mismatches;
+				continue;
+			}
+			const auto& elem = *static_cast<const TestOptionalHealthFamily*>(family.getElement(*idx));
+			const auto* entity = world.tryGetRawEntity(id);
+			if (elem.entityId != id || elem.health.tryGet() != entity->tryGetComponent<TestHealthComponent>()) {
+				++mismatches;
+			}
+		}
+		return mismatches;
+	}
+
+	void toggleHealth(World& world, EntityId id)
+	{
+		auto e = world.getEntity(id);
+		if (e.hasComponent<TestHealthComponent>()) {
+			e.removeComponent<TestHealthComponent>();
+		} else {
+			e.addComponent(TestHealthComponent());
+		}
+	}
+
+	Vector<EntityId> spawnWithOptionalHealth(World& world, size_t count)
+	{
+		Vector<EntityId> ids;
+		ids.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			auto e = world.createEntity();
+			e.addComponent(TestPositionComponent());
+			if (i % 3 == 0) {
+				e.addComponent(TestHealthComponent());
+			}
+			ids.push_back(e.getEntityId());
+		}
+		world.spawnPending();
+		return ids;
+	}
+
+	struct FamilyUpdateTimes {
+		double add = std::numeric_limits<double>::max();
+		double refresh = std::numeric_limits<double>::max();
+		double remove = std::numeric_limits<double>::max();
+	};
+
+	// Best of a few runs, in seconds, of adding entities to a family, refreshing all of them, and then removing half of them, each in one update
+	FamilyUpdateTimes timeFamilyUpdates(size_t count)
+	{
+		using Clock = std::chrono::steady_clock;
+		const auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+		FamilyUpdateTimes result;
+
+		for (int run = 0; run < 3; ++run) {
+			TestWorld testWorld;
+			auto& world = testWorld.getWorld();
+			auto ids = spawnWithOptionalHealth(world, count);
+			Vector<Entity*> entities;
+			entities.reserve(count);
+			for (auto id: ids) {
+				entities.push_back(world.tryGetRawEntity(id));
+			}
+			TestFamily<TestOptionalHealthFamily> family(world.getMaskStorage());
+
+			const auto t0 = Clock::now();
+			for (auto* e: entities) {
+				family.addEntity(*e);
+			}
+			family.updateEntities();
+			const auto t1 = Clock::now();
+			for (auto* e: entities) {
+				family.refreshEntity(*e);
+			}
+			family.updateEntities();
+			const auto t2 = Clock::now();
+
+			// Shuffled, so the swaps land all over the family
+			Random rng(static_cast<uint32_t>(run));
+			shuffle(entities.begin(), entities.end(), rng);
+			const auto t3 = Clock::now();
+			for (size_t i = 0; i < count / 2; ++i) {
+				family.removeEntity(*entities[i]);
+			}
+			family.updateEntities();
+			const auto t4 = Clock::now();
+
+			EXPECT_EQ(family.count(), count - count / 2);
+			result.add = std::min(result.add, seconds(t1 - t0));
+			result.refresh = std::min(result.refresh, seconds(t2 - t1));
+			result.remove = std::min(result.remove, seconds(t4 - t3));
+		}
+		return result;
+	}
+}
+
+TEST(Family, SortedByComponentAddressAfterChurn)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+	world.setSortFamiliesByComponentAddress(true);
+	auto& family = world.getFamily<TestMovementFamily>();
+
+	Random rng(42u);
+	Vector<EntityId> alive;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 20 && !alive.empty(); ++i) {
+			const auto idx = rng.getSizeT(0, alive.size() - 1);
+			world.destroyEntity(alive[idx]);
+			alive[idx] = alive.back();
+			alive.pop_back();
+		}
+		for (int i = 0; i < 50; ++i) {
+			alive.push_back(spawn(world));
+		}
+		world.spawnPending();
+
+		ASSERT_EQ(family.count(), alive.size());
+		for (size_t i = 1; i < family.count(); ++i) {
+			EXPECT_LT(getPositionAddress(family, i - 1), getPositionAddress(family, i));
+		}
+		checkIndex(family);
+	}
+}
+
+TEST(Family, SwapRemoveFixesIndex)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+	TestFamily<TestMovementFamily> family(world.getMaskStorage());
+
+	Vector<EntityId> ids;
+	for (int i = 0; i < 6; ++i) {
+		ids.push_back(spawn(world));
+	}
+	world.spawnPending();
+
+	// Entities only become elements on update
+	for (auto id: ids) {
+		family.addEntity(*world.tryGetRawEntity(id));
+	}
+	EXPECT_EQ(family.tryGetElementIndex(ids[0]), std::nullopt);
+	family.updateEntities();
+	ASSERT_EQ(family.count(), 6u);
+	checkIndex(family);
+
+	// Remove from the middle and the end: the last live elements are swapped into the gaps
+	family.removeEntity(*world.tryGetRawEntity(ids[1]));
+	family.removeEntity(*world.tryGetRawEntity(ids[5]));
+	family.removeEntity(*world.tryGetRawEntity(ids[2]));
+	family.updateEntities();
+	ASSERT_EQ(family.count(), 3u);
+	checkIndex(family);
+	for (auto id: { ids[1], ids[2], ids[5] }) {
+		EXPECT_EQ(family.tryGetElementIndex(id), std::nullopt);
+	}
+	for (auto id: { ids[0], ids[3], ids[4] }) {
+		const auto idx = family.tryGetElementIndex(id);
+		ASSERT_TRUE(idx.has_value());
+		EXPECT_EQ(getElementId(family, *idx), id);
+	}
+
+	// Removed and re-added before the update: the new entry is the one that stays
+	family.removeEntity(*world.tryGetRawEntity(ids[0]));
+	family.addEntity(*world.tryGetRawEntity(ids[0]));
+	family.updateEntities();
+	ASSERT_EQ(family.count(), 3u);
+	checkIndex(family);
+	EXPECT_TRUE(family.tryGetElementIndex(ids[0]).has_value());
+
+	// Remove everything
+	for (auto id: { ids[0], ids[3], ids[4] }) {
+		family.removeEntity(*world.tryGetRawEntity(id));
+	}
+	family.updateEntities();
+	EXPECT_EQ(family.count(), 0u);
+	EXPECT_EQ(family.tryGetElementIndex(ids[3]), std::nullopt);
+}
+
+TEST(Family, OptionalComponentToggleStress)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+	auto& family = world.getFamily<TestOptionalHealthFamily>();
+
+	constexpr size_t count = 50000;
+	auto ids = spawnWithOptionalHealth(world, count);
+	ASSERT_EQ(family.count(), count);
+	EXPECT_EQ(countOptionalMismatches(world, family, ids), 0u);
+
+	// Toggle most of them in a single frame
+	Random rng(42u);
+	for (auto id: ids) {
+		if (rng.getFloat(0.0f, 1.0f) < 0.8f) {
+			toggleHealth(world, id);
+		}
+	}
+	world.spawnPending();
+	ASSERT_EQ(family.count(), count);
+	EXPECT_EQ(countOptionalMismatches(world, family, ids), 0u);
+
+	// Then spread over several frames, some entities toggling more than once
+	for (int frame = 0; frame < 5; ++frame) {
+		for (int i = 0; i < 10000; ++i) {
+			toggleHealth(world, ids[rng.getSizeT(0, ids.size() - 1)]);
+		}
+		world.spawnPending();
+		ASSERT_EQ(family.count(), count);
+		EXPECT_EQ(countOptionalMismatches(world, family, ids), 0u);
+	}
+
+	// Destroy a large fraction, toggling some of the survivors in the same frame
+	Vector<EntityId> alive;
+	Vector<EntityId> dead;
+	for (auto id: ids) {
+		const auto roll = rng.getFloat(0.0f, 1.0f);
+		if (roll < 0.6f) {
+			world.destroyEntity(id);
+			dead.push_back(id);
+		} else {
+			if (roll < 0.8f) {
+				toggleHealth(world, id);
+			}
+			alive.push_back(id);
+		}
+	}
+	world.spawnPending();
+	ASSERT_EQ(family.count(), alive.size());
+	EXPECT_EQ(countOptionalMismatches(world, family, alive), 0u);
+	for (auto id: dead) {
+		ASSERT_EQ(family.tryGetElementIndex(id), std::nullopt);
+	}
+}
+
+TEST(Family, RefreshAndRemoveScaleLinearly)
+{
+	// Adding is linear, and touches the same memory; a per-entity scan of the family would make these thousands of times slower
+	const auto times = timeFamilyUpdates(50000);
+	EXPECT_LT(times.refresh, times.add * 4);
+	EXPECT_LT(times.remove, times.add * 4);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/resources/asset_pack.h"
+#include "halley/resources/asset_database.h"
+#include "halley/tools/file/filesystem.h"
+#include <filesystem>
+
+using namespace Halley;
+
+namespace {
+	Bytes makePackData(size_t size, Byte value)
+	{
+		AssetPack pack;
+		pack.getData().resize(size, value);
+		pack.getAssetDatabase().addAsset("asset", AssetType::BinaryFile, AssetDatabase::Entry("0:" + toString(size), Metadata()));
+		return pack.writeOut();
+	}
+}
+
+TEST(FileSystem, ReplaceFileKeepsMappedPackReadable)
+{
+#ifdef _WIN32
+	GTEST_SKIP() << "Windows won't replace a file while a view of it is mapped";
+#endif
+
+	const auto dir = Path(std::filesystem::temp_directory_path().string()) / "halley_filesystem_test";
+	FileSystem::remove(dir);
+	const auto path = dir / "pack.dat";
+	ASSERT_TRUE(FileSystem::replaceFile(path, makePackData(256 * 1024, 1)));
+
+	AssetPack mapped(ResourceDataReaderMappedFile::tryOpen(path), std::nullopt, false);
+	const auto data = mapped.getData("asset", AssetType::BinaryFile, false);
+	const auto span = dynamic_cast<ResourceDataStatic&>(*data).getSpan();
+
+	// Rebuild it smaller while it's mapped, as the packer does with a game running
+	// Writing it in place would truncate the mapped file, and touching the view would then fault
+	ASSERT_TRUE(FileSystem::replaceFile(path, makePackData(1024, 2)));
+	ASSERT_EQ(span.size(), 256 * 1024);
+	EXPECT_TRUE(std::all_of(span.begin(), span.end(), [](gsl::byte b) { return b == gsl::byte(1); }));
+
+	AssetPack rebuilt(ResourceDataReaderMappedFile::tryOpen(path), std::nullopt, false);
+	const auto rebuiltData = rebuilt.getData("asset", AssetType::BinaryFile, false);
+	const auto rebuiltSpan = dynamic_cast<ResourceDataStatic&>(*rebuiltData).getSpan();
+	ASSERT_EQ(rebuiltSpan.size(), 1024);
+	EXPECT_EQ(rebuiltSpan[0], gsl::byte(2));
+
+	// No temporary files are left behind
+	EXPECT_EQ(FileSystem::enumerateDirectory(dir).size(), 1);
+
+	FileSystem::remove(dir);
+}
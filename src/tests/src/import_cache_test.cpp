@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/file/filesystem.h"
+#include <filesystem>
+
+using namespace Halley;
+
+namespace {
+	class TestImporter : public IAssetImporter {
+	public:
+		explicit TestImporter(int version) : version(version) {}
+
+		ImportAssetType getType() const override { return ImportAssetType::ConfigFile; }
+		int getVersion() const override { return version; }
+
+	private:
+		int version;
+	};
+
+	// Two checkouts of the same project, sharing one cache directory
+	class ImportCacheTest : public ::testing::Test {
+	protected:
+		void SetUp() override
+		{
+			root = Path(std::filesystem::temp_directory_path().string()) / "halley_import_cache_test";
+			FileSystem::remove(root);
+			cacheDir = root / "cache";
+			checkoutA = root / "a" / "assets_src";
+			checkoutB = root / "b" / "assets_src";
+			writeDependency(checkoutA, "palette");
+			writeDependency(checkoutB, "palette");
+		}
+
+		void TearDown() override
+		{
+			FileSystem::remove(root);
+		}
+
+		void writeDependency(const Path& assetsSrc, const String& contents)
+		{
+			const auto path = assetsSrc / "config" / "palette.yaml";
+			FileSystem::createParentDir(path);
+			FileSystem::writeFile(path, contents.toBytes());
+		}
+
+		ImportingAsset makeAsset(const String& contents) const
+		{
+			ImportingAsset asset;
+			asset.assetId = "test";
+			asset.assetType = ImportAssetType::ConfigFile;
+			asset.inputFiles.emplace_back(Path("config/test.yaml"), contents.toBytes(), Metadata());
+			return asset;
+		}
+
+		ImportAssetsTask::ImportResult makeResult(const Path& assetsSrc) const
+		{
+			ImportAssetsTask::ImportResult result;
+			result.outFiles.emplace_back(Path("config/test"), String("output").toBytes());
+			const auto dependency = assetsSrc / "config" / "palette.yaml";
+			result.additionalInputs.emplace_back(dependency, FileSystem::getLastWriteTime(dependency));
+			result.success = true;
+			return result;
+		}
+
+		Path root;
+		Path cacheDir;
+		Path checkoutA;
+		Path checkoutB;
+		TestImporter importer{ 1 };
+		Vector<std::reference_wrapper<IAssetImporter>> importers{ importer };
+	};
+}
+
+TEST_F(ImportCacheTest, HitReturnsStoredResult)
+{
+	ImportCache cache(cacheDir, { checkoutA }, 0);
+	const auto key = cache.getKey(makeAsset("input"), importers);
+	ASSERT_TRUE(key);
+	EXPECT_FALSE(cache.load(*key));
+	ASSERT_TRUE(cache.store(*key, makeResult(checkoutA)));
+
+	const auto result = cache.load(*key);
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result->outFiles.size(), 1);
+	EXPECT_EQ(result->outFiles[0].first.getString(), "config/test");
+	EXPECT_EQ(result->outFiles[0].second, String("output").toBytes());
+	ASSERT_EQ(result->additionalInputs.size(), 1);
+	EXPECT_EQ(result->additionalInputs[0].first.getString(), (checkoutA / "config" / "palette.yaml").getString());
+}
+
+TEST_F(ImportCacheTest, ChangedInputsMiss)
+{
+	ImportCache cache(cacheDir, { checkoutA }, 0);
+	const auto key = cache.getKey(makeAsset("input"), importers);
+	ASSERT_TRUE(key);
+	ASSERT_TRUE(cache.store(*key, makeResult(checkoutA)));
+
+	EXPECT_NE(cache.getKey(makeAsset("changed"), importers), key);
+
+	TestImporter newerImporter(2);
+	EXPECT_NE(cache.getKey(makeAsset("input"), { newerImporter }), key);
+
+	ImportCache otherSalt(cacheDir, { checkoutA }, 1);
+	EXPECT_NE(otherSalt.getKey(makeAsset("input"), importers), key);
+
+	// Without a version there's no telling when the importer's output changes
+	TestImporter unversioned(0);
+	EXPECT_FALSE(cache.getKey(makeAsset("input"), { unversioned }));
+}
+
+TEST_F(ImportCacheTest, ChangedDependencyInvalidates)
+{
+	ImportCache cache(cacheDir, { checkoutA }, 0);
+	const auto key = cache.getKey(makeAsset("input"), importers);
+	ASSERT_TRUE(key);
+	ASSERT_TRUE(cache.store(*key, makeResult(checkoutA)));
+	ASSERT_TRUE(cache.load(*key));
+
+	writeDependency(checkoutA, "changed palette");
+	EXPECT_FALSE(cache.load(*key));
+
+	FileSystem::remove(checkoutA / "config" / "palette.yaml");
+	EXPECT_FALSE(cache.load(*key));
+}
+
+TEST_F(ImportCacheTest, DependenciesResolveInEachCheckout)
+{
+	ImportCache cacheA(cacheDir, { checkoutA }, 0);
+	const auto key = cacheA.getKey(makeAsset("input"), importers);
+	ASSERT_TRUE(key);
+	ASSERT_TRUE(cacheA.store(*key, makeResult(checkoutA)));
+
+	// Checkout B finds the entry written by A, and checks the dependency against its own copy
+	ImportCache cacheB(cacheDir, { checkoutB }, 0);
+	ASSERT_EQ(cacheB.getKey(makeAsset("input"), importers), key);
+	const auto result = cacheB.load(*key);
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result->additionalInputs.size(), 1);
+	EXPECT_EQ(result->additionalInputs[0].first.getString(), (checkoutB / "config" / "palette.yaml").getString());
+
+	writeDependency(checkoutB, "changed palette");
+	EXPECT_FALSE(cacheB.load(*key));
+	EXPECT_TRUE(cacheA.load(*key));
+}
+
+TEST_F(ImportCacheTest, StoreReplacesEntry)
+{
+	ImportCache cache(cacheDir, { checkoutA }, 0);
+	const auto key = cache.getKey(makeAsset("input"), importers);
+	ASSERT_TRUE(key);
+	ASSERT_TRUE(cache.store(*key, makeResult(checkoutA)));
+
+	auto result = makeResult(checkoutA);
+	result.outFiles[0].second = String("new output").toBytes();
+	ASSERT_TRUE(cache.store(*key, result));
+
+	const auto loaded = cache.load(*key);
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(loaded->outFiles[0].second, String("new output").toBytes());
+
+	// The temporary file was renamed into place
+	EXPECT_EQ(FileSystem::enumerateDirectory(cacheDir).size(), 1);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "navmesh_grid.h"
+#include "test_executors.h"
+
+using namespace Halley;
+
+TEST(Navmesh, PathfindReusesState)
+{
+	const auto navmesh = makeGridNavmesh(20);
+
+	const auto longQuery = makeGridQuery(Vector2f(5, 5), Vector2f(195, 195));
+	const auto shortQuery = makeGridQuery(Vector2f(15, 5), Vector2f(5, 5));
+	const auto expected = navmesh.pathfindNodes(longQuery);
+	ASSERT_TRUE(expected.has_value());
+	EXPECT_EQ(0, expected->front().node);
+	EXPECT_EQ(399, expected->back().node);
+
+	// Consecutive queries share scratch state, so a stale entry would show up as a different or missing path
+	for (int i = 0; i < 10; ++i) {
+		const auto shortPath = navmesh.pathfindNodes(shortQuery);
+		ASSERT_TRUE(shortPath.has_value());
+		EXPECT_EQ(2u, shortPath->size());
+
+		const auto path = navmesh.pathfindNodes(longQuery);
+		ASSERT_TRUE(path.has_value());
+		EXPECT_EQ(expected.value(), path.value());
+	}
+
+	EXPECT_FALSE(navmesh.pathfindNodes(makeGridQuery(Vector2f(5, 5), Vector2f(500, 500))).has_value());
+}
+
+TEST(Navmesh, PathfindBatch)
+{
+	TestExecutors executors;
+
+	NavmeshSet navmeshSet;
+	navmeshSet.add(makeGridNavmesh(64));
+
+	Random rng(54321u);
+	Vector<NavigationQuery> queries;
+	for (int i = 0; i < 100; ++i) {
+		queries.push_back(makeGridQuery(Vector2f(rng.getFloat(0, 640), rng.getFloat(0, 640)), Vector2f(rng.getFloat(0, 640), rng.getFloat(0, 640))));
+	}
+	queries.push_back(makeGridQuery(Vector2f(5, 5), Vector2f(5000, 5000)));
+
+	const auto results = navmeshSet.pathfindBatch(queries).get();
+	ASSERT_EQ(queries.size(), results.size());
+	for (size_t i = 0; i < queries.size(); ++i) {
+		String error;
+		const auto expected = navmeshSet.pathfind(queries[i], &error);
+		ASSERT_EQ(expected.has_value(), results[i].path.has_value());
+		EXPECT_EQ(error, results[i].error);
+		if (expected) {
+			EXPECT_EQ(expected->path.size(), results[i].path->path.size());
+		}
+	}
+	EXPECT_FALSE(results.back().path.has_value());
+	EXPECT_FALSE(results.back().error.isEmpty());
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "headless_renderer.h"
+#include "test_executors.h"
+
+using namespace Halley;
+
+namespace {
+	// Headless painter which keeps a copy of every draw call's vertices and indices
+	class CapturingPainter final : public HeadlessPainter {
+	public:
+		using HeadlessPainter::HeadlessPainter;
+
+		Vector<char> vertices;
+		Vector<IndexType> indices;
+		size_t drawCalls = 0;
+
+		void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indexData, bool standardQuadsOnly) override
+		{
+			const auto* src = static_cast<const char*>(vertexData);
+			vertices.insert(vertices.end(), src, src + numVertices * material.getVertexStride());
+			indices.insert(indices.end(), indexData, indexData + numIndices);
+			++drawCalls;
+		}
+	};
+
+	std::unique_ptr<HeadlessRenderer> makeRenderer()
+	{
+		return std::make_unique<HeadlessRenderer>(Vector2i(1280, 720), [] (VideoAPI& video, Resources& resources)
+		{
+			return std::make_unique<CapturingPainter>(video, resources);
+		});
+	}
+
+	void addSprites(SpritePainter& spritePainter, const std::shared_ptr<const Material>& material, size_t n)
+	{
+		Random rng(4321u);
+		for (size_t i = 0; i < n; ++i) {
+			Sprite sprite;
+			sprite.setMaterial(material);
+			sprite.setPosition(Vector2f(rng.getFloat(0, 1260), rng.getFloat(0, 700))).setSize(Vector2f(16, 16)).setColour(Colour4f(rng.getFloat(0, 1), 1, 1, 1));
+			spritePainter.add(std::move(sprite), 1, 0, float(i % 100));
+		}
+	}
+
+	// Draws n sprites through a SpritePainter
+	void drawSprites(HeadlessRenderer& renderer, const std::shared_ptr<const Material>& material, size_t n, bool parallel)
+	{
+		SpritePainter spritePainter;
+		spritePainter.setParallelVertexGeneration(parallel);
+		addSprites(spritePainter, material, n);
+
+		auto& painter = dynamic_cast<CapturingPainter&>(renderer.getPainter());
+		painter.vertices.clear();
+		painter.indices.clear();
+		painter.drawCalls = 0;
+
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p)
+			{
+				spritePainter.draw(1, p);
+			});
+		});
+
+		EXPECT_EQ(n, spritePainter.getStats().drawn);
+	}
+}
+
+TEST(Painter, ParallelSpriteVerticesMatch)
+{
+	TestExecutors executors;
+	const auto renderer = makeRenderer();
+	const auto material = std::make_shared<Material>(renderer->makeSpriteMaterial("Test/Sprite"));
+	const auto& painter = dynamic_cast<CapturingPainter&>(renderer->getPainter());
+
+	// Spans more than one draw call's worth of vertices
+	constexpr size_t n = 40000;
+	drawSprites(*renderer, material, n, false);
+	const auto serialVertices = painter.vertices;
+	const auto serialIndices = painter.indices;
+	const auto serialDrawCalls = painter.drawCalls;
+	EXPECT_EQ(n * 4 * material->getDefinition().getVertexStride(), serialVertices.size());
+	EXPECT_LT(1u, serialDrawCalls);
+
+	drawSprites(*renderer, material, n, true);
+	EXPECT_EQ(serialDrawCalls, painter.drawCalls);
+	EXPECT_TRUE(serialIndices == painter.indices);
+	EXPECT_TRUE(serialVertices == painter.vertices);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+
+using namespace Halley;
+
+namespace {
+	// Few layers and lots of repeated tie breakers, like sprites sorted by a quantised y
+	void addSprites(SpritePainter& painter, size_t n, uint32_t seed)
+	{
+		Random rng(seed);
+		for (size_t i = 0; i < n; ++i) {
+			Sprite sprite;
+			sprite.setPosition(Vector2f(rng.getFloat(-1000, 1000), rng.getFloat(-1000, 1000))).setSize(Vector2f(16, 16));
+			const int layer = rng.getInt(-3, 3);
+			const float tieBreaker = float(rng.getInt(-200, 200)) * (rng.getInt(0, 9) == 0 ? -0.0f : 0.5f);
+			painter.addCopy(sprite, 1, layer, tieBreaker);
+		}
+	}
+}
+
+TEST(SpritePainter, SortMatchesComparison)
+{
+	for (size_t n: { 10, 1000, 5000 }) {
+		SpritePainter painter;
+		addSprites(painter, n, 42);
+
+		// Unsorted entries are in insertion order, and so are cached sprite indices
+		auto expected = Vector<SpritePainterEntry>(painter.getEntries().begin(), painter.getEntries().end());
+		std::stable_sort(expected.begin(), expected.end());
+
+		painter.sort();
+		const auto entries = painter.getEntries();
+		ASSERT_EQ(expected.size(), size_t(entries.size()));
+		for (size_t i = 0; i < expected.size(); ++i) {
+			EXPECT_EQ(expected[i].getSortKey(), entries[i].getSortKey());
+			EXPECT_EQ(expected[i].getIndex(), entries[i].getIndex());
+		}
+	}
+
+	// Keys compare the same way as the layer and tie breaker they came from
+	SpritePainter painter;
+	painter.addCopy(Sprite(), 1, 1, -1.0f);
+	painter.addCopy(Sprite(), 1, -1, 5.0f);
+	painter.addCopy(Sprite(), 1, 1, -2.5f);
+	painter.addCopy(Sprite(), 1, 1, 0.0f);
+	painter.addCopy(Sprite(), 1, -1, -5.0f);
+	painter.addCopy(Sprite(), 1, 1, -0.0f);
+	painter.sort();
+	Vector<uint32_t> order;
+	for (const auto& e: painter.getEntries()) {
+		order.push_back(e.getIndex());
+	}
+	EXPECT_EQ(Vector<uint32_t>({ 4, 1, 2, 0, 3, 5 }), order);
+}
+
+TEST(SpritePainter, CullingGridMatchesBruteForce)
+{
+	// A large scrolling level, with a few entries that are huge or never culled
+	Random rng(777u);
+	Vector<std::optional<Rect4f>> bounds;
+	for (size_t i = 0; i < 20000; ++i) {
+		if (i % 500 == 0) {
+			bounds.push_back(std::nullopt);
+		} else if (i % 700 == 0) {
+			bounds.push_back(Rect4f(rng.getFloat(-10000, 10000), rng.getFloat(-10000, 10000), 5000, 3000));
+		} else {
+			bounds.push_back(Rect4f(rng.getFloat(-10000, 10000), rng.getFloat(-10000, 10000), rng.getFloat(0, 64), rng.getFloat(0, 64)));
+		}
+	}
+
+	SpritePainterCullingGrid grid;
+	grid.build(bounds);
+
+	Vector<uint32_t> result;
+	for (int i = 0; i < 50; ++i) {
+		const auto view = Rect4f(rng.getFloat(-12000, 12000), rng.getFloat(-12000, 12000), 1920, 1080);
+		grid.query(view, result);
+
+		Vector<uint32_t> expected;
+		for (uint32_t j = 0; j < uint32_t(bounds.size()); ++j) {
+			if (!bounds[j] || bounds[j]->overlaps(view)) {
+				expected.push_back(j);
+			}
+		}
+		EXPECT_EQ(expected, result);
+	}
+
+	// Everything in view
+	grid.query(Rect4f(-20000, -20000, 40000, 40000), result);
+	EXPECT_EQ(bounds.size(), result.size());
+
+	// Nothing to cull
+	Vector<std::optional<Rect4f>> noBounds(10);
+	grid.build(noBounds);
+	grid.query(Rect4f(0, 0, 10, 10), result);
+	EXPECT_EQ(10u, result.size());
+}
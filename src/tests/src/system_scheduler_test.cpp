@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_components.h"
+#include "test_executors.h"
+#include "test_world.h"
+
+using namespace Halley;
+
+namespace {
+	template <typename T>
+	class TestSystem : public System {
+	public:
+		using UpdateCallback = std::function<void(FamilyBinding<T>&)>;
+
+		explicit TestSystem(String name, Vector<int> messageTypesReceived = {})
+			: System({ &family }, std::move(messageTypesReceived))
+		{
+			setName(std::move(name));
+		}
+
+		TestSystem& setConcurrent(Vector<int> messageTypesSent = {}, Vector<String> servicesUsed = {})
+		{
+			declareConcurrentAccess(std::move(messageTypesSent), std::move(servicesUsed));
+			return *this;
+		}
+
+		TestSystem& setOnUpdate(UpdateCallback callback)
+		{
+			onUpdate = std::move(callback);
+			return *this;
+		}
+
+	protected:
+		void updateBase(Time) override
+		{
+			if (onUpdate) {
+				onUpdate(family);
+			}
+		}
+
+	private:
+		FamilyBinding<T> family;
+		UpdateCallback onUpdate;
+	};
+
+	template <typename T>
+	TestSystem<T>& addSystem(World& world, String name, Vector<int> messageTypesReceived = {})
+	{
+		return static_cast<TestSystem<T>&>(world.addSystem(std::make_unique<TestSystem<T>>(std::move(name), std::move(messageTypesReceived)), TimeLine::FixedUpdate));
+	}
+
+	Vector<Vector<String>> getBatchNames(const TestWorld& testWorld)
+	{
+		Vector<Vector<String>> result;
+		for (const auto& batch: testWorld.getSystemBatches(TimeLine::FixedUpdate)) {
+			auto& names = result.emplace_back();
+			for (const auto* system: batch) {
+				names.push_back(system->getName());
+			}
+		}
+		return result;
+	}
+}
+
+TEST(SystemScheduler, ComponentConflicts)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+
+	auto& movement = addSystem<TestMovementFamily>(world, "movement").setConcurrent();
+	auto& reader1 = addSystem<TestPositionReadFamily>(world, "reader1").setConcurrent();
+	auto& reader2 = addSystem<TestPositionReadFamily>(world, "reader2").setConcurrent();
+	auto& health = addSystem<TestHealthFamily>(world, "health").setConcurrent();
+
+	// Readers don't conflict with each other, writers conflict with readers and writers of the same component
+	EXPECT_TRUE(reader1.canRunConcurrentlyWith(reader2));
+	EXPECT_FALSE(movement.canRunConcurrentlyWith(reader1));
+	EXPECT_FALSE(reader1.canRunConcurrentlyWith(movement));
+	EXPECT_TRUE(movement.canRunConcurrentlyWith(health));
+	EXPECT_TRUE(health.canRunConcurrentlyWith(reader1));
+
+	// A system that didn't declare its access conflicts with everything
+	auto& undeclared = addSystem<TestHealthFamily>(world, "undeclared");
+	EXPECT_FALSE(undeclared.canRunConcurrentlyWith(reader1));
+	EXPECT_FALSE(reader1.canRunConcurrentlyWith(undeclared));
+}
+
+TEST(SystemScheduler, MessageAndServiceConflicts)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+
+	auto& sender = addSystem<TestPositionReadFamily>(world, "sender").setConcurrent({ 1 });
+	auto& otherSender = addSystem<TestPositionReadFamily>(world, "otherSender").setConcurrent({ 1 });
+	auto& receiver = addSystem<TestPositionReadFamily>(world, "receiver", { 1 }).setConcurrent();
+	auto& unrelated = addSystem<TestPositionReadFamily>(world, "unrelated", { 2 }).setConcurrent({ 3 });
+
+	EXPECT_FALSE(sender.canRunConcurrentlyWith(otherSender));
+	EXPECT_FALSE(sender.canRunConcurrentlyWith(receiver));
+	EXPECT_FALSE(receiver.canRunConcurrentlyWith(sender));
+	EXPECT_TRUE(sender.canRunConcurrentlyWith(unrelated));
+	EXPECT_TRUE(receiver.canRunConcurrentlyWith(unrelated));
+
+	auto& service1 = addSystem<TestPositionReadFamily>(world, "service1").setConcurrent({}, { "Physics" });
+	auto& service2 = addSystem<TestPositionReadFamily>(world, "service2").setConcurrent({}, { "Physics", "Audio" });
+	auto& service3 = addSystem<TestPositionReadFamily>(world, "service3").setConcurrent({}, { "Audio" });
+	EXPECT_FALSE(service1.canRunConcurrentlyWith(service2));
+	EXPECT_FALSE(service3.canRunConcurrentlyWith(service2));
+	EXPECT_TRUE(service1.canRunConcurrentlyWith(service3));
+}
+
+TEST(SystemScheduler, BatchesKeepConflictingSystemsInOrder)
+{
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+
+	addSystem<TestMovementFamily>(world, "movement").setConcurrent();
+	addSystem<TestHealthFamily>(world, "health").setConcurrent();
+	addSystem<TestPositionReadFamily>(world, "reader").setConcurrent();
+	addSystem<TestHealthFamily>(world, "health2").setConcurrent();
+	EXPECT_EQ(getBatchNames(testWorld), (Vector<Vector<String>>{ { "movement", "health" }, { "reader", "health2" } }));
+
+	// Batches are rebuilt when systems change, and a system that didn't declare its access is a barrier
+	addSystem<TestHealthFamily>(world, "undeclared");
+	addSystem<TestPositionReadFamily>(world, "reader2").setConcurrent();
+	EXPECT_EQ(getBatchNames(testWorld), (Vector<Vector<String>>{ { "movement", "health" }, { "reader", "health2" }, { "undeclared" }, { "reader2" } }));
+}
+
+TEST(SystemScheduler, ParallelUpdateMatchesSequential)
+{
+	auto run = [] (bool parallel)
+	{
+		TestExecutors executors;
+		TestWorld testWorld;
+		auto& world = testWorld.getWorld();
+		world.setParallelUpdate(parallel);
+
+		Vector<float> seen;
+		addSystem<TestMovementFamily>(world, "movement").setConcurrent().setOnUpdate([] (auto& family)
+		{
+			for (auto& e: family) {
+				e.position.position += e.velocity.velocity;
+			}
+		});
+		addSystem<TestHealthFamily>(world, "health").setConcurrent().setOnUpdate([] (auto& family)
+		{
+			for (auto& e: family) {
+				--e.health.health;
+			}
+		});
+		addSystem<TestPositionReadFamily>(world, "reader").setConcurrent().setOnUpdate([&] (auto& family)
+		{
+			for (auto& e: family) {
+				seen.push_back(e.position.position.x);
+			}
+		});
+
+		for (int i = 0; i < 10; ++i) {
+			auto e = world.createEntity();
+			e.addComponent(TestPositionComponent());
+			e.addComponent(TestVelocityComponent());
+			e.addComponent(TestHealthComponent());
+			e.getComponent<TestVelocityComponent>().velocity = Vector2f(float(i), 0);
+			e.getComponent<TestHealthComponent>().health = 100;
+		}
+
+		for (int i = 0; i < 3; ++i) {
+			world.step(TimeLine::FixedUpdate, 1.0 / 60.0);
+		}
+
+		int totalHealth = 0;
+		for (auto e: world.getEntities()) {
+			totalHealth += e.getComponent<TestHealthComponent>().health;
+		}
+		return std::pair(seen, totalHealth);
+	};
+
+	const auto sequential = run(false);
+	const auto parallel = run(true);
+	EXPECT_EQ(sequential.second, 10 * 97);
+	EXPECT_EQ(parallel, sequential);
+	ASSERT_EQ(parallel.first.size(), 30u);
+	EXPECT_FLOAT_EQ(parallel.first.back(), 27.0f);
+}
@@ -0,0 +1,136 @@
+#include "ui_test_fixture.h"
+
+using namespace Halley;
+
+namespace {
+	class UILayoutTest : public UITestFixture {
+	protected:
+		void SetUp() override
+		{
+			UITestFixture::SetUp();
+			font = renderer->makeFont("Test");
+		}
+
+		std::shared_ptr<UILabel> makeLabel(const String& text) const
+		{
+			return std::make_shared<UILabel>("", UIStyle(), TextRenderer(font, "", 16), LocalisedString::fromUserString(text));
+		}
+
+		// Window at (10, 10) with a row of two labels
+		std::shared_ptr<UIWidget> makeWindow()
+		{
+			auto window = std::make_shared<UIWidget>("window", Vector2f(), UISizer(UISizerType::Vertical));
+			window->setPosition(Vector2f(10, 10));
+			auto row = std::make_shared<UIWidget>("row", Vector2f(), UISizer(UISizerType::Horizontal, 0.0f));
+			first = makeLabel("First");
+			second = makeLabel("Second");
+			row->add(first);
+			row->add(second);
+			window->add(row);
+			root->addChild(window);
+			return window;
+		}
+
+		std::shared_ptr<Font> font;
+		std::shared_ptr<UILabel> first;
+		std::shared_ptr<UILabel> second;
+	};
+}
+
+TEST_F(UILayoutTest, TextChangeMovesSiblings)
+{
+	makeWindow();
+	update();
+	const auto before = second->getPosition();
+	EXPECT_EQ(before.x, 10 + first->getSize().x);
+
+	first->setText(LocalisedString::fromUserString("First, but longer"));
+	update();
+	EXPECT_GT(second->getPosition().x, before.x);
+	EXPECT_EQ(second->getPosition().x, 10 + first->getSize().x);
+	EXPECT_EQ(second->getPosition().y, before.y);
+}
+
+TEST_F(UILayoutTest, MovingWidgetMovesChildren)
+{
+	auto window = makeWindow();
+	update();
+	const auto before = first->getPosition();
+
+	window->setPosition(Vector2f(110, 60));
+	update();
+	EXPECT_EQ(first->getPosition(), before + Vector2f(100, 50));
+}
+
+TEST_F(UILayoutTest, SizerChangeRelaysOut)
+{
+	auto window = makeWindow();
+	update();
+	const auto before = first->getPosition();
+
+	// Spacers aren't widgets, so only the sizer itself can invalidate the layout
+	window->getWidget("row")->getSizer().add(std::make_shared<UISizerSpacer>(Vector2f(30, 0)), 0, {}, UISizerFillFlags::Fill, 0);
+	update();
+	EXPECT_EQ(first->getPosition(), before + Vector2f(30, 0));
+}
+
+TEST_F(UILayoutTest, SizerEntryChangeRelaysOut)
+{
+	auto window = makeWindow();
+	update();
+	const auto before = second->getPosition();
+
+	// Changed through the entry, which only the sizer knows about
+	window->getWidget("row")->getSizer()[1].setBorder(Vector4f(25, 0, 0, 0));
+	update();
+	EXPECT_EQ(second->getPosition(), before + Vector2f(25, 0));
+}
+
+TEST_F(UILayoutTest, MovingChildKeepsMinimumSizes)
+{
+	// Without a sizer, children are laid out at their own positions
+	auto window = makeWindow();
+	auto holder = std::make_shared<UIWidget>("holder", Vector2f(50, 50));
+	auto child = std::make_shared<UIWidget>("child", Vector2f(10, 10));
+	holder->add(child);
+	window->add(holder);
+	update();
+	ASSERT_FALSE(window->needsLayout());
+
+	child->setPosition(Vector2f(300, 200));
+	EXPECT_FALSE(window->needsLayout());
+	update();
+	EXPECT_EQ(child->getPosition(), Vector2f(300, 200));
+	EXPECT_EQ(child->getRect().getTopLeft(), Vector2f(300, 200));
+}
+
+TEST_F(UILayoutTest, ScrollingMovesContents)
+{
+	auto pane = std::make_shared<UIScrollPane>("pane", Vector2f(200, 100), UISizer(UISizerType::Vertical));
+	Vector<std::shared_ptr<UILabel>> labels;
+	for (int i = 0; i < 50; ++i) {
+		labels.push_back(makeLabel("Line " + toString(i)));
+		pane->add(labels.back());
+	}
+	root->addChild(pane);
+	update();
+	const auto before = labels[10]->getPosition();
+
+	pane->scrollTo(Vector2f(0, 50));
+	update();
+	EXPECT_EQ(labels[10]->getPosition(), before - Vector2f(0, 50));
+}
+
+TEST_F(UILayoutTest, UnchangedTreeKeepsLayout)
+{
+	makeWindow();
+	update();
+	const auto firstRect = first->getRect();
+	const auto secondRect = second->getRect();
+
+	for (int i = 0; i < 3; ++i) {
+		update();
+	}
+	EXPECT_EQ(first->getRect(), firstRect);
+	EXPECT_EQ(second->getRect(), secondRect);
+}
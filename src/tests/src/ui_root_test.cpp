@@ -0,0 +1,130 @@
+#include "ui_test_fixture.h"
+
+using namespace Halley;
+
+namespace {
+	class CountingWidget : public UIWidget {
+	public:
+		using Callback = std::function<void(CountingWidget&)>;
+
+		explicit CountingWidget(String id, Callback onUpdate = {})
+			: UIWidget(std::move(id), Vector2f(10, 10))
+			, onUpdate(std::move(onUpdate))
+		{}
+
+		void update(Time t, bool moved) override
+		{
+			++updates;
+			if (onUpdate) {
+				onUpdate(*this);
+			}
+		}
+
+		int updates = 0;
+
+	private:
+		Callback onUpdate;
+	};
+
+	class UIRootTest : public UITestFixture {};
+}
+
+TEST_F(UIRootTest, RemovedWidgetSurvivesUntilUpdateEnds)
+{
+	int removedUpdates = 0;
+	auto removed = std::make_shared<CountingWidget>("removed", [&] (CountingWidget&) { ++removedUpdates; });
+	std::weak_ptr<UIWidget> weakRemoved = removed;
+
+	// Removes its sibling on the first update of the second frame, while the sibling is still waiting for its own update
+	root->addChild(std::make_shared<CountingWidget>("remover", [&] (CountingWidget& remover)
+	{
+		if (remover.updates == 3) {
+			root->removeChild(*weakRemoved.lock());
+		}
+	}));
+	root->addChild(std::move(removed));
+	update();
+	EXPECT_EQ(removedUpdates, 2);
+
+	update();
+	EXPECT_EQ(removedUpdates, 2);
+	EXPECT_TRUE(weakRemoved.expired());
+	EXPECT_EQ(root->tryGetWidget("removed"), nullptr);
+}
+
+TEST_F(UIRootTest, ChildSpawnedDuringUpdateIsUpdated)
+{
+	std::shared_ptr<CountingWidget> child;
+	root->addChild(std::make_shared<CountingWidget>("parent", [&] (CountingWidget& parent)
+	{
+		if (!child) {
+			child = std::make_shared<CountingWidget>("child");
+			parent.add(child);
+		}
+	}));
+	update();
+
+	ASSERT_NE(child, nullptr);
+	EXPECT_GT(child->updates, 0);
+
+	const auto before = child->updates;
+	update();
+	EXPECT_GT(child->updates, before);
+}
+
+TEST_F(UIRootTest, InactiveWidgetsAreNotUpdated)
+{
+	auto parent = std::make_shared<CountingWidget>("parent");
+	auto child = std::make_shared<CountingWidget>("child");
+	parent->add(child);
+	root->addChild(parent);
+	update();
+	EXPECT_GT(child->updates, 0);
+
+	parent->setActive(false);
+	update();
+	const auto inactiveUpdates = child->updates;
+	update();
+	EXPECT_EQ(child->updates, inactiveUpdates);
+
+	parent->setActive(true);
+	update();
+	EXPECT_GT(child->updates, inactiveUpdates);
+}
+
+TEST_F(UIRootTest, UpdateOrderFollowsHierarchy)
+{
+	Vector<String> order;
+	const auto record = [&] (CountingWidget& w) { order.push_back(w.getId()); };
+
+	auto a = std::make_shared<CountingWidget>("a", record);
+	a->add(std::make_shared<CountingWidget>("a1", record));
+	root->addChild(a);
+	root->addChild(std::make_shared<CountingWidget>("b", record));
+	update();
+
+	// Breadth-first, then the same again for the partial update after layout
+	order.clear();
+	update();
+	EXPECT_EQ(order, (Vector<String>{ "a", "b", "a1", "a", "b", "a1" }));
+
+	// New children are spawned by their parent's update and visited in the same pass
+	a->add(std::make_shared<CountingWidget>("a2", record));
+	order.clear();
+	update();
+	EXPECT_EQ(order, (Vector<String>{ "a", "b", "a1", "a2", "a", "b", "a1", "a2" }));
+}
+
+TEST_F(UIRootTest, RenderListIsReusedUntilHierarchyChanges)
+{
+	root->addChild(std::make_shared<CountingWidget>("a"));
+	update();
+	const auto first = frameData->uiRootData.at(root.get());
+
+	update();
+	EXPECT_EQ(frameData->uiRootData.at(root.get()), first);
+
+	root->addChild(std::make_shared<CountingWidget>("b"));
+	update();
+	EXPECT_NE(frameData->uiRootData.at(root.get()), first);
+}
@@ -0,0 +1,198 @@
+#include "ui_list_styles.h"
+#include "ui_test_fixture.h"
+
+using namespace Halley;
+
+namespace {
+	class UIVirtualListTest : public UITestFixture {
+	protected:
+		void SetUp() override
+		{
+			UITestFixture::SetUp();
+
+			// The stylesheet's default text renderer needs this font
+			font = renderer->makeFont("Ubuntu Bold");
+			styleFile = std::make_unique<ConfigFile>(makeListStyles());
+			styleSheet = std::make_shared<UIStyleSheet>(renderer->getResources(), *styleFile, std::make_shared<UIColourScheme>());
+
+			pane = std::make_shared<UIScrollPane>("pane", Vector2f(400, 300), UISizer(UISizerType::Vertical));
+			root->addChild(pane);
+		}
+
+		void TearDown() override
+		{
+			pane.reset();
+			root.reset();
+			styleSheet.reset();
+			UITestFixture::TearDown();
+		}
+
+		UIStyle getStyle() const
+		{
+			return UIStyle("list", styleSheet);
+		}
+
+		std::shared_ptr<UIVirtualList> makeList(size_t n)
+		{
+			auto list = std::make_shared<UIVirtualList>("list", getStyle(), [=] ()
+			{
+				return std::make_shared<UILabel>("label", getStyle(), TextRenderer(font, "", 16), LocalisedString());
+			}, [=] (UIWidget& contents, size_t idx)
+			{
+				dynamic_cast<UILabel&>(contents).setText(LocalisedString::fromUserString("Item " + toString(idx)));
+			});
+			list->setItems(makeIds(n));
+			pane->add(list, 1);
+			return list;
+		}
+
+		static Vector<String> makeIds(size_t n)
+		{
+			Vector<String> ids;
+			ids.reserve(n);
+			for (size_t i = 0; i < n; ++i) {
+				ids.push_back("item" + toString(i));
+			}
+			return ids;
+		}
+
+		void update(int frames = 2)
+		{
+			UITestFixture::update(frames);
+		}
+
+		std::shared_ptr<Font> font;
+		std::unique_ptr<ConfigFile> styleFile;
+		std::shared_ptr<UIStyleSheet> styleSheet;
+		std::shared_ptr<UIScrollPane> pane;
+	};
+}
+
+TEST_F(UIVirtualListTest, OnlyItemsInViewHaveRows)
+{
+	auto list = makeList(5000);
+	update();
+
+	EXPECT_EQ(list->getCount(), 5000);
+	EXPECT_EQ(list->getItemsInView().first, 0);
+	EXPECT_GT(list->getItemsInView().second, 0);
+	EXPECT_LT(list->getNumRows(), 50);
+	EXPECT_GT(list->getSize().y, 300.0f);
+
+	auto* row = dynamic_cast<UIVirtualListRow*>(root->tryGetWidget("item3").get());
+	ASSERT_NE(row, nullptr);
+	EXPECT_EQ(row->getItemIndex(), 3);
+	EXPECT_EQ(dynamic_cast<UILabel&>(*row->getContents()).getText().getString(), "Item 3");
+}
+
+TEST_F(UIVirtualListTest, RowsAreReusedWhenScrolling)
+{
+	auto list = makeList(5000);
+	update();
+
+	pane->scrollTo(Vector2f(0, list->getSize().y * 0.25f));
+	update();
+	const auto numRows = list->getNumRows();
+
+	pane->scrollTo(Vector2f(0, list->getSize().y * 0.5f));
+	update();
+
+	const auto [first, last] = list->getItemsInView();
+	EXPECT_GT(first, 1000);
+	EXPECT_LT(last, 4000);
+	EXPECT_LE(list->getNumRows(), numRows + 1);
+	EXPECT_LT(list->getNumRows(), 50);
+
+	const auto middle = (first + last) / 2;
+	auto* row = dynamic_cast<UIVirtualListRow*>(root->tryGetWidget("item" + toString(middle)).get());
+	ASSERT_NE(row, nullptr);
+	EXPECT_EQ(dynamic_cast<UILabel&>(*row->getContents()).getText().getString(), "Item " + toString(middle));
+	EXPECT_EQ(root->tryGetWidget("item0"), nullptr);
+}
+
+TEST_F(UIVirtualListTest, SelectionSurvivesSetItems)
+{
+	auto list = makeList(100);
+	update();
+
+	list->setSelectedOptionId("item50");
+	EXPECT_EQ(list->getSelectedOption(), 50);
+
+	auto ids = makeIds(100);
+	ids.erase(ids.begin(), ids.begin() + 10);
+	list->setItems(std::move(ids));
+	update();
+
+	EXPECT_EQ(list->getSelectedOptionId(), "item50");
+	EXPECT_EQ(list->getSelectedOption(), 40);
+}
+
+TEST_F(UIVirtualListTest, TreeOnlyListsExpandedBranches)
+{
+	auto tree = std::make_shared<UIVirtualTreeList>("tree", getStyle());
+	for (int i = 0; i < 50; ++i) {
+		const auto parentId = "parent" + toString(i);
+		tree->addTreeItem(parentId, "", std::numeric_limits<size_t>::max(), LocalisedString::fromUserString(parentId), Sprite(), false);
+		for (int j = 0; j < 100; ++j) {
+			const auto childId = parentId + "_" + toString(j);
+			tree->addTreeItem(childId, parentId, std::numeric_limits<size_t>::max(), LocalisedString::fromUserString(childId));
+		}
+	}
+	pane->add(tree, 1);
+	update();
+
+	EXPECT_EQ(tree->getCount(), 50);
+
+	tree->setExpanded("parent3", true);
+	update();
+	EXPECT_EQ(tree->getCount(), 150);
+	EXPECT_EQ(tree->getItemId(4), "parent3_0");
+
+	tree->setAllExpanded(true);
+	update();
+	EXPECT_EQ(tree->getCount(), 5050);
+	EXPECT_LT(tree->getNumRows(), 50);
+
+	tree->removeItem("parent0");
+	update();
+	EXPECT_EQ(tree->getCount(), 4949);
+	EXPECT_EQ(tree->getItemId(0), "parent1");
+}
+
+TEST_F(UIVirtualListTest, TreeRemoveAndScrollInSameFrame)
+{
+	auto tree = std::make_shared<UIVirtualTreeList>("tree", getStyle());
+	for (int i = 0; i < 20; ++i) {
+		const auto parentId = "parent" + toString(i);
+		tree->addTreeItem(parentId, "", std::numeric_limits<size_t>::max(), LocalisedString::fromUserString(parentId));
+		for (int j = 0; j < 20; ++j) {
+			const auto childId = parentId + "_" + toString(j);
+			tree->addTreeItem(childId, parentId, std::numeric_limits<size_t>::max(), LocalisedString::fromUserString(childId));
+		}
+	}
+	pane->add(tree, 1);
+	update();
+
+	// Removes the branch just below the view, then scrolls it into view and lays out before the tree gets a chance to refresh
+	pane->scrollTo(Vector2f(0, tree->getSize().y * 0.25f));
+	update();
+	const auto removedId = tree->getItemId(tree->getItemsInView().second + 1).split('_').front();
+	tree->removeItem(removedId);
+	tree->setLabel("parent0", LocalisedString::fromUserString("renamed"), Sprite());
+	pane->scrollBy(Vector2f(0, 200));
+	pane->layout();
+	update(1);
+
+	// The rows in view are bound to the refreshed items within that same frame
+	EXPECT_EQ(tree->getCount(), 19 * 21);
+	EXPECT_FALSE(tree->tryGetItemIndex(removedId));
+	const auto [newFirst, newLast] = tree->getItemsInView();
+	for (size_t i = newFirst; i < newLast; ++i) {
+		const auto& id = tree->getItemId(i);
+		EXPECT_FALSE(id.startsWith(removedId + "_"));
+		auto* row = dynamic_cast<UIVirtualListRow*>(root->tryGetWidget(id).get());
+		ASSERT_NE(row, nullptr);
+		EXPECT_EQ(row->getItemIndex(), i);
+		EXPECT_EQ(row->getContents()->getWidgetAs<UILabel>("label")->getText().getString(), id);
+	}
+}
@@ -0,0 +1,31 @@
+#include "benchmark_options.h"
+#include "halley/support/exception.h"
+
+using namespace Halley;
+
+BenchmarkOptions& BenchmarkOptions::add(String name, int& value, int minValue)
+{
+	options.emplace_back(std::move(name), [&value, minValue] (int v) { value = std::max(v, minValue); });
+	return *this;
+}
+
+BenchmarkOptions& BenchmarkOptions::add(String name, size_t& value, size_t minValue)
+{
+	options.emplace_back(std::move(name), [&value, minValue] (int v) { value = std::max(size_t(std::max(v, 0)), minValue); });
+	return *this;
+}
+
+void BenchmarkOptions::parse(int argc, char** argv) const
+{
+	for (int i = 1; i < argc; i += 2) {
+		const auto key = String(argv[i]);
+		const auto iter = std::find_if(options.begin(), options.end(), [&] (const auto& o) { return o.first == key; });
+		if (iter == options.end()) {
+			throw Exception("Unknown option: " + key, HalleyExceptions::Tools);
+		}
+		if (i + 1 >= argc) {
+			throw Exception("Missing value for option: " + key, HalleyExceptions::Tools);
+		}
+		iter->second(String(argv[i + 1]).toInteger());
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include "halley/data_structures/vector.h"
+#include "halley/text/halleystring.h"
+
+namespace Halley {
+	// Command line options of a benchmark, given as "--name value" pairs. Each value is raised to its option's minimum.
+	class BenchmarkOptions {
+	public:
+		BenchmarkOptions& add(String name, int& value, int minValue);
+		BenchmarkOptions& add(String name, size_t& value, size_t minValue);
+
+		// Throws on options that weren't added, or that are missing their value
+		void parse(int argc, char** argv) const;
+
+	private:
+		Vector<std::pair<String, std::function<void(int)>>> options;
+	};
+}
@@ -0,0 +1,80 @@
+#include "distance_field_reference.h"
+
+#include <climits>
+#include <cmath>
+#include "halley/file_formats/image.h"
+#include "halley/utils/utils.h"
+
+using namespace Halley;
+
+namespace {
+	// The original brute force generator, which searched a square window around each sample
+	float getReferenceDistanceAt(const int* src, int srcW, int srcH, int x, int y, float radius)
+	{
+		const bool inside = ((src[x + y * srcW] & 0xFF000000) >> 24) > 127;
+		if (radius < 0.001f) {
+			return inside ? 1.0f : 0.0f;
+		}
+
+		const int iRadius = int(std::ceil(radius));
+		int bestDistSqr = INT_MAX;
+		for (int j = std::max(0, y - iRadius); j < std::min(srcH, y + iRadius + 1); ++j) {
+			for (int i = std::max(0, x - iRadius); i < std::min(srcW, x + iRadius + 1); ++i) {
+				const bool otherInside = ((src[i + j * srcW] & 0xFF000000) >> 24) > 127;
+				if (otherInside != inside) {
+					const int dx = i - x;
+					const int dy = j - y;
+					bestDistSqr = std::min(bestDistSqr, dx * dx + dy * dy);
+				}
+			}
+		}
+
+		const float dist = std::sqrt(float(bestDistSqr));
+		const float normalDistance = (2 * dist - 1) / (2 * radius);
+		return 0.5f * (inside ? 1.0f + normalDistance : 1.0f - normalDistance);
+	}
+}
+
+std::unique_ptr<Image> Halley::generateReferenceSDF(Image& srcImg, Vector2i size, float radius)
+{
+	const int srcW = srcImg.getWidth();
+	const int srcH = srcImg.getHeight();
+	const auto src = srcImg.getPixels4BPP().data();
+	auto dstImg = std::make_unique<Image>(Image::Format::SingleChannel, size);
+	const auto dst = dstImg->getPixelBytes();
+
+	const int w = size.x;
+	const int h = size.y;
+	const int texelW = srcW / w;
+	const int texelH = srcH / h;
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			float distAcc = 0;
+			for (int j = 0; j < texelH; ++j) {
+				for (int i = 0; i < texelW; ++i) {
+					distAcc += getReferenceDistanceAt(src, srcW, srcH, x * srcW / w + i, y * srcH / h + j, radius * srcW / w);
+				}
+			}
+			dst[x + y * w] = static_cast<unsigned char>(clamp(int(distAcc * 255 / (texelW * texelH)), 0, 255));
+		}
+	}
+	return dstImg;
+}
+
+std::unique_ptr<Image> Halley::makeDistanceFieldShapes(Vector2i size)
+{
+	auto img = std::make_unique<Image>(Image::Format::RGBA, size);
+	const auto pixels = img->getPixels4BPP();
+	const auto s = float(size.x);
+	for (int y = 0; y < size.y; ++y) {
+		for (int x = 0; x < size.x; ++x) {
+			const auto p = Vector2f(float(x), float(y));
+			const bool a = (p - Vector2f(0.3f, 0.35f) * s).length() < 0.2f * s;
+			const bool b = (p - Vector2f(0.55f, 0.4f) * s).length() < 0.15f * s;
+			const float ring = (p - Vector2f(0.6f, 0.7f) * s).length();
+			const bool c = ring > 0.1f * s && ring < 0.2f * s;
+			pixels[x + y * size.x] = int(a || b || c ? 0xFFFFFFFFu : 0x00FFFFFFu);
+		}
+	}
+	return img;
+}
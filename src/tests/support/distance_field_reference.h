@@ -0,0 +1,14 @@
+#pragma once
+
+#include <memory>
+#include "halley/maths/vector2.h"
+
+namespace Halley {
+	class Image;
+
+	// The original brute force distance field generator, which searched a square window around each sample
+	std::unique_ptr<Image> generateReferenceSDF(Image& srcImg, Vector2i size, float radius);
+
+	// A few overlapping circles and a ring, so there are both convex and concave edges
+	std::unique_ptr<Image> makeDistanceFieldShapes(Vector2i size);
+}
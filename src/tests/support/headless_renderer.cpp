@@ -0,0 +1,212 @@
+#include "headless_renderer.h"
+
+#include "halley/api/halley_api.h"
+#include "halley/graphics/camera.h"
+#include "halley/graphics/painter.h"
+#include "halley/graphics/shader.h"
+#include "halley/graphics/render_context.h"
+#include "halley/graphics/render_snapshot.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/window.h"
+#include "halley/graphics/material/material_definition.h"
+#include "halley/graphics/render_target/render_target_screen.h"
+#include "halley/graphics/text/font.h"
+#include "halley/resources/resource_locator.h"
+#include "halley/resources/resources.h"
+#include "halley/resources/standard_resources.h"
+#include "dummy/dummy_input.h"
+#include "dummy/dummy_system.h"
+#include "dummy/dummy_video.h"
+
+using namespace Halley;
+
+namespace {
+	using T = ShaderParameterType;
+
+	std::shared_ptr<MaterialDefinition> makeMaterial(VideoAPI& video, const String& name, const Vector<std::pair<String, ShaderParameterType>>& attributes, const Vector<String>& textures,
+		Vector<MaterialUniform> materialUniforms = {}, int numPasses = 1)
+	{
+		auto definition = std::make_shared<MaterialDefinition>();
+		definition->setName(name);
+
+		Vector<MaterialAttribute> attribs;
+		for (const auto& [attribName, type]: attributes) {
+			attribs.emplace_back(attribName, type, int(attribs.size()));
+			attribs.back().isVertexPos = attribName == "vertPos";
+		}
+		definition->setAttributes(std::move(attribs));
+
+		Vector<MaterialTexture> texs;
+		for (const auto& texName: textures) {
+			texs.emplace_back(texName, "", TextureSamplerType::Texture2D);
+		}
+		definition->setTextures(std::move(texs));
+
+		// As in material_base.material
+		Vector<MaterialUniformBlock> blocks;
+		blocks.emplace_back("HalleyBlock", Vector<MaterialUniform>{
+			MaterialUniform("u_mvp", T::Matrix4, ShaderParameterSemanticType::Number),
+			MaterialUniform("u_viewPortSize", T::Float2, ShaderParameterSemanticType::Number)
+		});
+		if (!materialUniforms.empty()) {
+			blocks.emplace_back("MaterialBlock", std::move(materialUniforms));
+		}
+		definition->setUniformBlocks(std::move(blocks));
+
+		for (int i = 0; i < numPasses; ++i) {
+			definition->addPass(MaterialPass(video.createShader(ShaderDefinition())));
+		}
+		definition->initialize(video);
+		return definition;
+	}
+
+	const Vector<std::pair<String, ShaderParameterType>>& getSpriteAttributes()
+	{
+		// As in sprite_base.material
+		static const Vector<std::pair<String, ShaderParameterType>> attributes = {
+			{ "vertPos", T::Float4 }, { "position", T::Float2 }, { "pivot", T::Float2 }, { "size", T::Float2 }, { "scale", T::Float2 }, { "colour", T::Float4 },
+			{ "texCoord0", T::Float4 }, { "texCoord1", T::Float4 }, { "custom0", T::Float4 }, { "custom1", T::Float4 }, { "custom2", T::Float4 }, { "custom3", T::Float4 },
+			{ "rotation", T::Float }, { "textureRotation", T::Float }
+		};
+		return attributes;
+	}
+
+	// Shadow, outline and fill passes, as in text.material
+	std::shared_ptr<MaterialDefinition> makeTextMaterial(VideoAPI& video, const String& name)
+	{
+		const auto number = ShaderParameterSemanticType::Number;
+		return makeMaterial(video, name, getSpriteAttributes(), { "tex0" }, {
+			MaterialUniform("u_smoothness", T::Float, number),
+			MaterialUniform("u_outline", T::Float, number),
+			MaterialUniform("u_shadowSmoothness", T::Float, number),
+			MaterialUniform("u_shadowDistance", T::Float2, number),
+			MaterialUniform("u_outlineColour", T::Float4, number),
+			MaterialUniform("u_shadowColour", T::Float4, number)
+		}, 3);
+	}
+
+	std::shared_ptr<MaterialDefinition> makeLineMaterial(VideoAPI& video, const String& name)
+	{
+		return makeMaterial(video, name, { { "colour", T::Float4 }, { "dashing", T::Float4 }, { "position", T::Float2 }, { "normal", T::Float2 }, { "width", T::Float2 } }, {});
+	}
+
+	std::shared_ptr<MaterialDefinition> makeBlitMaterial(VideoAPI& video, const String& name)
+	{
+		return makeMaterial(video, name, { { "position", T::Float4 }, { "texCoord0", T::Float4 } }, { "tex0" });
+	}
+}
+
+HeadlessPainter::HeadlessPainter(VideoAPI& video, Resources& resources)
+	: Painter(video, resources)
+{}
+
+void HeadlessPainter::doStartRender() {}
+
+void HeadlessPainter::doEndRender() {}
+
+void HeadlessPainter::setVertices(const MaterialDefinition&, size_t, const void*, size_t, const IndexType*, bool) {}
+
+void HeadlessPainter::drawTriangles(size_t) {}
+
+void HeadlessPainter::doClear(std::optional<Colour>, std::optional<float>, std::optional<uint8_t>) {}
+
+void HeadlessPainter::setMaterialPass(const Material&, int) {}
+
+void HeadlessPainter::setMaterialData(const Material&) {}
+
+void HeadlessPainter::setViewPort(Rect4i) {}
+
+void HeadlessPainter::setClip(Rect4i, bool) {}
+
+void HeadlessPainter::onUpdateProjection(Material&, bool) {}
+
+HeadlessRenderer::HeadlessRenderer(Vector2i screenSize, PainterFactory painterFactory)
+{
+	system = std::make_unique<DummySystemAPI>();
+	video = std::make_unique<DummyVideoAPI>(*system);
+	video->setWindow(WindowDefinition(WindowType::None, screenSize, "Headless"));
+	input = std::make_unique<DummyInputAPI>();
+
+	api = std::make_unique<HalleyAPI>();
+	api->system = system.get();
+	api->video = video.get();
+	api->input = input.get();
+
+	resources = std::make_unique<Resources>(std::make_unique<ResourceLocator>(*system), *api, ResourceOptions());
+	StandardResources::initialize(*resources);
+	auto& materials = resources->of<MaterialDefinition>();
+	materials.setResource(0, "Halley/MaterialBase", makeMaterial(*video, "Halley/MaterialBase", {}, {}));
+	materials.setResource(0, "Halley/SolidLine", makeLineMaterial(*video, "Halley/SolidLine"));
+	materials.setResource(0, "Halley/SolidPolygon", makeLineMaterial(*video, "Halley/SolidPolygon"));
+	materials.setResource(0, "Halley/Blit", makeBlitMaterial(*video, "Halley/Blit"));
+	materials.setResource(0, "Halley/BlitDepth", makeBlitMaterial(*video, "Halley/BlitDepth"));
+	materials.setResource(0, "Halley/Sprite", makeSpriteMaterial("Halley/Sprite", { "image" }));
+	materials.setResource(0, "Halley/Text", makeTextMaterial(*video, "Halley/Text"));
+
+	painter = painterFactory ? painterFactory(*video, *resources) : std::make_unique<HeadlessPainter>(*video, *resources);
+	screenTarget = video->createScreenRenderTarget();
+	camera = std::make_unique<Camera>(Vector2f(screenSize) * 0.5f);
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+	painter.reset();
+	resources.reset();
+}
+
+const HalleyAPI& HeadlessRenderer::getAPI() const
+{
+	return *api;
+}
+
+Resources& HeadlessRenderer::getResources() const
+{
+	return *resources;
+}
+
+Painter& HeadlessRenderer::getPainter() const
+{
+	return *painter;
+}
+
+void HeadlessRenderer::render(const std::function<void(RenderContext&)>& f, RenderSnapshot* snapshot)
+{
+	video->startRender();
+	painter->renderFrame(*camera, *screenTarget, f, snapshot);
+	if (snapshot) {
+		snapshot->finish();
+	}
+	video->finishRender();
+}
+
+std::shared_ptr<MaterialDefinition> HeadlessRenderer::makeSpriteMaterial(const String& name, Vector<String> textures) const
+{
+	return makeMaterial(*video, name, getSpriteAttributes(), textures);
+}
+
+std::shared_ptr<Texture> HeadlessRenderer::makeTexture(const String& name, Vector2i size) const
+{
+	std::shared_ptr<Texture> texture = video->createTexture(size);
+	texture->setAssetId(name);
+	resources->of<Texture>().setResource(0, name, texture);
+	return texture;
+}
+
+std::shared_ptr<Font> HeadlessRenderer::makeFont(const String& name) const
+{
+	// Glyphs laid out on a 16x6 grid
+	const auto imageSize = Vector2i(512, 192);
+	const auto imageName = name + ".png";
+	makeTexture(imageName, imageSize);
+
+	auto font = std::make_shared<Font>(name, imageName, 26.0f, 32.0f, 32.0f, 1.0f, imageSize, 4.0f, Vector<String>(), false);
+	for (int c = 0; c < 128; ++c) {
+		const int cell = std::max(c - 32, 0);
+		const auto cellSize = Vector2f(32, 32);
+		const auto area = Rect4f(Vector2f(float(cell % 16), float(cell / 16)) * cellSize / Vector2f(imageSize), cellSize / Vector2f(imageSize));
+		font->addGlyph(Font::Glyph(c, area, Vector2f(24, 30), Vector2f(2, 26), Vector2f(0, 0), Vector2f(20, 0), {}));
+	}
+	font->loadMaterial(*resources);
+	resources->of<Font>().setResource(0, name, font);
+	return font;
+}
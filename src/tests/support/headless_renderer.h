@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "halley/graphics/painter.h"
+#include "halley/maths/vector2.h"
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/vector.h"
+
+namespace Halley {
+	class Camera;
+	class Font;
+	class HalleyAPI;
+	class InputAPIInternal;
+	class MaterialDefinition;
+	class RenderContext;
+	class RenderSnapshot;
+	class Resources;
+	class ScreenRenderTarget;
+	class SystemAPI;
+	class Texture;
+	class VideoAPI;
+	class VideoAPIInternal;
+
+	// Painter which draws nothing. Tests can override its backend calls (e.g. setVertices) to inspect what would be drawn.
+	class HeadlessPainter : public Painter {
+	public:
+		HeadlessPainter(VideoAPI& video, Resources& resources);
+
+	protected:
+		void doStartRender() override;
+		void doEndRender() override;
+		void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indices, bool standardQuadsOnly) override;
+		void drawTriangles(size_t numIndices) override;
+		void doClear(std::optional<Colour> colour, std::optional<float> depth, std::optional<uint8_t> stencil) override;
+		void setMaterialPass(const Material& material, int pass) override;
+		void setMaterialData(const Material& material) override;
+		void setViewPort(Rect4i rect) override;
+		void setClip(Rect4i clip, bool enable) override;
+		void onUpdateProjection(Material& material, bool hashChanged) override;
+	};
+
+	// Renders frames through the dummy video API, with no window or GPU.
+	// Meant for tests and benchmarks of the CPU side of rendering and UI. Input is the dummy input API.
+	class HeadlessRenderer {
+	public:
+		using PainterFactory = std::function<std::unique_ptr<Painter>(VideoAPI& video, Resources& resources)>;
+
+		// Resources start empty, other than placeholders for the materials that Painter, sprites and text need.
+		// painterFactory defaults to HeadlessPainter.
+		explicit HeadlessRenderer(Vector2i screenSize = Vector2i(1280, 720), PainterFactory painterFactory = {});
+		~HeadlessRenderer();
+
+		const HalleyAPI& getAPI() const;
+		Resources& getResources() const;
+		Painter& getPainter() const;
+
+		// Renders one frame, calling f with the screen as the default render target, like Stage::onRender.
+		// If snapshot is set, the frame is recorded into it.
+		void render(const std::function<void(RenderContext&)>& f, RenderSnapshot* snapshot = nullptr);
+
+		// Material with the vertex layout and uniforms of sprite_base.material, and a single pass with a dummy shader
+		std::shared_ptr<MaterialDefinition> makeSpriteMaterial(const String& name, Vector<String> textures = { "tex0" }) const;
+
+		// Blank texture, registered in resources under name
+		std::shared_ptr<Texture> makeTexture(const String& name, Vector2i size) const;
+
+		// Distance field font covering printable ASCII with placeholder glyphs, registered in resources under name
+		std::shared_ptr<Font> makeFont(const String& name) const;
+
+	private:
+		std::unique_ptr<SystemAPI> system;
+		std::unique_ptr<VideoAPIInternal> video;
+		std::unique_ptr<InputAPIInternal> input;
+		std::unique_ptr<HalleyAPI> api;
+		std::unique_ptr<Resources> resources;
+		std::unique_ptr<Painter> painter;
+		std::unique_ptr<ScreenRenderTarget> screenTarget;
+		std::unique_ptr<Camera> camera;
+	};
+}
@@ -0,0 +1,37 @@
+#include "navmesh_grid.h"
+
+using namespace Halley;
+
+Navmesh Halley::makeGridNavmesh(int size, float cellSize)
+{
+	auto isOpen = [&] (int x, int y)
+	{
+		return x >= 0 && y >= 0 && x < size && y < size && (x % 7 != 6 || y == (x * 13) % size);
+	};
+	auto idx = [&] (int x, int y) { return y * size + x; };
+
+	Vector<Navmesh::PolygonData> polys;
+	polys.resize(size * size);
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			auto& poly = polys[idx(x, y)];
+			poly.polygon = Polygon(Rect4f(x * cellSize, y * cellSize, cellSize, cellSize));
+			poly.weight = isOpen(x, y) ? 1.0f : 1000.0f;
+
+			// Edges are top, right, bottom, left
+			const std::array<Vector2i, 4> neighbours = { Vector2i(x, y - 1), Vector2i(x + 1, y), Vector2i(x, y + 1), Vector2i(x - 1, y) };
+			for (const auto& n: neighbours) {
+				const bool valid = n.x >= 0 && n.y >= 0 && n.x < size && n.y < size;
+				poly.connections.push_back(valid ? idx(n.x, n.y) : -1);
+			}
+		}
+	}
+
+	const auto side = size * cellSize;
+	return Navmesh(std::move(polys), NavmeshBounds(Vector2f(), Vector2f(side, 0), Vector2f(0, side), 1, 1, Vector2f(1, 1)), 0);
+}
+
+NavigationQuery Halley::makeGridQuery(Vector2f from, Vector2f to)
+{
+	return NavigationQuery(WorldPosition(from, 0), WorldPosition(to, 0), NavigationQuery::PostProcessingType::None, NavigationQuery::QuantizationType::None);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "halley/navigation/navmesh.h"
+#include "halley/navigation/navigation_query.h"
+
+namespace Halley {
+	// Grid of square cells, every 7th column walled off except for a gap, so paths have to wind around
+	Navmesh makeGridNavmesh(int size, float cellSize = 10.0f);
+
+	NavigationQuery makeGridQuery(Vector2f from, Vector2f to);
+}
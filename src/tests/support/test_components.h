@@ -0,0 +1,91 @@
+#pragma once
+
+#include "halley/entity/component.h"
+#include "halley/entity/family.h"
+#include "halley/entity/family_type.h"
+#include "halley/data_structures/maybe_ref.h"
+#include "halley/maths/vector2.h"
+
+namespace Halley {
+	// Hand-written equivalents of codegen components, for worlds built without the codegen step (see TestWorld)
+	template <typename T, int index>
+	class TestComponentBase : public Component {
+	public:
+		static constexpr int componentIndex = index;
+
+		void* operator new(std::size_t size, std::align_val_t align) { return doNew<T>(size, align); }
+		void* operator new(std::size_t size) { return doNew<T>(size); }
+		void operator delete(void* ptr) { return doDelete<T>(ptr); }
+	};
+
+	class TestPositionComponent : public TestComponentBase<TestPositionComponent, 0> {
+	public:
+		static constexpr const char* componentName = "TestPosition";
+		Vector2f position;
+	};
+
+	class TestVelocityComponent : public TestComponentBase<TestVelocityComponent, 1> {
+	public:
+		static constexpr const char* componentName = "TestVelocity";
+		Vector2f velocity;
+	};
+
+	class TestHealthComponent : public TestComponentBase<TestHealthComponent, 2> {
+	public:
+		static constexpr const char* componentName = "TestHealth";
+		int health = 0;
+	};
+
+	// Families, as codegen would declare them inside a system
+	class TestMovementFamily : public FamilyBaseOf<TestMovementFamily> {
+	public:
+		TestPositionComponent& position;
+		const TestVelocityComponent& velocity;
+
+		using Type = FamilyType<TestPositionComponent, const TestVelocityComponent>;
+
+	protected:
+		TestMovementFamily(TestPositionComponent& position, const TestVelocityComponent& velocity)
+			: position(position)
+			, velocity(velocity)
+		{}
+	};
+
+	class TestPositionReadFamily : public FamilyBaseOf<TestPositionReadFamily> {
+	public:
+		const TestPositionComponent& position;
+
+		using Type = FamilyType<const TestPositionComponent>;
+
+	protected:
+		TestPositionReadFamily(const TestPositionComponent& position)
+			: position(position)
+		{}
+	};
+
+	class TestHealthFamily : public FamilyBaseOf<TestHealthFamily> {
+	public:
+		TestHealthComponent& health;
+
+		using Type = FamilyType<TestHealthComponent>;
+
+	protected:
+		TestHealthFamily(TestHealthComponent& health)
+			: health(health)
+		{}
+	};
+
+	class TestOptionalHealthFamily : public FamilyBaseOf<TestOptionalHealthFamily> {
+	public:
+		const TestPositionComponent& position;
+		MaybeRef<TestHealthComponent> health;
+
+		using Type = FamilyType<const TestPositionComponent, MaybeRef<TestHealthComponent>>;
+
+	protected:
+		TestOptionalHealthFamily(const TestPositionComponent& position, MaybeRef<TestHealthComponent> health)
+			: position(position)
+			, health(health)
+		{}
+	};
+}
@@ -0,0 +1,15 @@
+#include "test_executors.h"
+
+using namespace Halley;
+
+TestExecutors::TestExecutors(size_t nCPUThreads)
+{
+	Executors::setInstance(executors);
+	cpuPool = std::make_unique<ThreadPool>("Test", Executors::getCPU(), nCPUThreads, [] (String name, std::function<void()> f) { return std::thread(std::move(f)); });
+}
+
+TestExecutors::~TestExecutors()
+{
+	cpuPool.reset();
+	Executors::resetInstance();
+}
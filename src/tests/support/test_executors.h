@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+#include "halley/concurrency/executor.h"
+
+namespace Halley {
+	// Installs a fresh set of executors as the global instance, with nCPUThreads workers on the CPU queue.
+	// The global instance is cleared on destruction, after the workers have joined, so nothing is left pointing at it.
+	class TestExecutors {
+	public:
+		explicit TestExecutors(size_t nCPUThreads = 4);
+		~TestExecutors();
+
+		TestExecutors(const TestExecutors& other) = delete;
+		TestExecutors& operator=(const TestExecutors& other) = delete;
+
+	private:
+		Executors executors;
+		std::unique_ptr<ThreadPool> cpuPool;
+	};
+}
@@ -0,0 +1,76 @@
+#include "test_world.h"
+
+#include "halley/api/halley_api.h"
+#include "halley/entity/world_reflection.h"
+#include "halley/resources/resource_locator.h"
+#include "halley/resources/resources.h"
+#include "dummy/dummy_system.h"
+
+using namespace Halley;
+
+namespace {
+	class TestCoreAPI : public CoreAPI {
+	public:
+		void quit(int exitCode) override {}
+		void setStage(StageID stage) override { noStages(); }
+		void setStage(std::unique_ptr<Stage> stage) override { noStages(); }
+		void initStage(Stage& stage) override { noStages(); }
+		Stage& getCurrentStage() override { noStages(); }
+
+		HalleyStatics& getStatics() override { throw Exception("TestCoreAPI has no statics", HalleyExceptions::Core); }
+		const Environment& getEnvironment() override { return environment; }
+
+		void addProfilerCallback(IProfileCallback* callback) override {}
+		void removeProfilerCallback(IProfileCallback* callback) override {}
+		void addStartFrameCallback(IStartFrameCallback* callback) override {}
+		void removeStartFrameCallback(IStartFrameCallback* callback) override {}
+
+		Future<std::unique_ptr<RenderSnapshot>> requestRenderSnapshot() override { throw Exception("TestCoreAPI can't render", HalleyExceptions::Core); }
+
+		bool isDevMode() override { return false; }
+
+		DevConClient* getDevConClient() const override { return nullptr; }
+
+	private:
+		Environment environment;
+
+		[[noreturn]] static void noStages()
+		{
+			throw Exception("TestCoreAPI has no stages", HalleyExceptions::Core);
+		}
+	};
+}
+
+TestWorld::TestWorld()
+{
+	core = std::make_unique<TestCoreAPI>();
+	system = std::make_unique<DummySystemAPI>();
+
+	api = std::make_unique<HalleyAPI>();
+	api->core = core.get();
+	api->system = system.get();
+
+	resources = std::make_unique<Resources>(std::make_unique<ResourceLocator>(*system), *api, ResourceOptions());
+	world = std::make_unique<World>(*api, *resources, std::make_shared<WorldReflection>());
+}
+
+TestWorld::~TestWorld()
+{
+	world.reset();
+	resources.reset();
+}
+
+World& TestWorld::getWorld() const
+{
+	return *world;
+}
+
+const HalleyAPI& TestWorld::getAPI() const
+{
+	return *api;
+}
+
+const Vector<Vector<System*>>& TestWorld::getSystemBatches(TimeLine timeline) const
+{
+	return world->getSystemBatches(timeline);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include "halley/entity/world.h"
+
+namespace Halley {
+	class CoreAPI;
+	class SystemAPI;
+
+	// An empty World with no scene or codegen reflection, for tests and benchmarks of entities, families and system scheduling.
+	// The core API reports dev mode off and has no stages. Components, families and systems are declared by hand (see test_components.h).
+	class TestWorld {
+	public:
+		TestWorld();
+		~TestWorld();
+
+		TestWorld(const TestWorld& other) = delete;
+		TestWorld& operator=(const TestWorld& other) = delete;
+
+		World& getWorld() const;
+		const HalleyAPI& getAPI() const;
+
+		// The World's system batches for the timeline, kept private to the World outside of tests
+		const Vector<Vector<System*>>& getSystemBatches(TimeLine timeline) const;
+
+	private:
+		std::unique_ptr<CoreAPI> core;
+		std::unique_ptr<SystemAPI> system;
+		std::unique_ptr<HalleyAPI> api;
+		std::unique_ptr<Resources> resources;
+		std::unique_ptr<World> world;
+	};
+}
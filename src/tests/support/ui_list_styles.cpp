@@ -0,0 +1,59 @@
+#include "ui_list_styles.h"
+
+using namespace Halley;
+
+ConfigNode Halley::makeListStyles()
+{
+	ConfigNode::MapType item;
+	item["normal"] = "";
+	item["hover"] = "";
+	item["selected"] = "";
+	item["innerBorder"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(0), ConfigNode(0), ConfigNode(0) };
+	item["minSize"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(20) };
+
+	ConfigNode::MapType label;
+	label["font"] = "Ubuntu Bold";
+	label["size"] = 16;
+	label["colour"] = "#FFFFFF";
+
+	ConfigNode::MapType labelStyle;
+	labelStyle["normal"] = label;
+	labelStyle["selected"] = label;
+
+	ConfigNode::MapType button;
+	button["normal"] = "";
+	button["hover"] = "";
+	button["down"] = "";
+	button["disabled"] = "";
+	button["innerBorder"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(0), ConfigNode(0), ConfigNode(0) };
+
+	ConfigNode::MapType controls;
+	controls["expandButton"] = button;
+	controls["collapseButton"] = button;
+	controls["leaf"] = "";
+	controls["guide_l"] = "";
+	controls["guide_t"] = "";
+	controls["guide_i"] = "";
+
+	ConfigNode::MapType list;
+	list["background"] = "";
+	list["gap"] = 0;
+	list["innerBorder"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(0), ConfigNode(0), ConfigNode(0) };
+	list["item"] = item;
+	list["label"] = labelStyle;
+	list["labelBorder"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(0), ConfigNode(0), ConfigNode(0) };
+	list["controls"] = controls;
+
+	// UIList takes its label text renderer straight from "label"
+	ConfigNode::MapType uiList = list;
+	uiList["label"] = label;
+	uiList["extraMouseBorder"] = ConfigNode::SequenceType{ ConfigNode(0), ConfigNode(0), ConfigNode(0), ConfigNode(0) };
+
+	ConfigNode::MapType styles;
+	styles["list"] = list;
+	styles["uiList"] = uiList;
+
+	ConfigNode::MapType root;
+	root["uiStyle"] = styles;
+	return ConfigNode(std::move(root));
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "halley/data_structures/config_node.h"
+
+namespace Halley {
+	// UI stylesheet with a "list" style for UIVirtualList and UIVirtualTreeList, and a "uiList" style for UIList.
+	// Text uses the "Ubuntu Bold" font, which has to be in resources before the stylesheet is loaded.
+	ConfigNode makeListStyles();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "headless_renderer.h"
+
+namespace Halley {
+	// Fixture for tests that drive a UIRoot, with the headless renderer providing the API and resources
+	class UITestFixture : public ::testing::Test {
+	protected:
+		void SetUp() override
+		{
+			// UIRoot::update prepares render data into the current frame
+			frameData = std::make_unique<DefaultFrameData>();
+			BaseFrameData::setThreadFrameData(frameData.get());
+
+			renderer = std::make_unique<HeadlessRenderer>();
+			root = std::make_unique<UIRoot>(renderer->getAPI(), Rect4f(0, 0, 1280, 720));
+		}
+
+		void TearDown() override
+		{
+			BaseFrameData::setThreadFrameData(nullptr);
+			frameData.reset();
+			root.reset();
+			renderer.reset();
+		}
+
+		void update(int frames = 1)
+		{
+			for (int i = 0; i < frames; ++i) {
+				root->update(1.0 / 60.0, UIInputType::Mouse, {}, {});
+			}
+		}
+
+		std::unique_ptr<DefaultFrameData> frameData;
+		std::unique_ptr<HeadlessRenderer> renderer;
+		std::unique_ptr<UIRoot> root;
+	};
+}
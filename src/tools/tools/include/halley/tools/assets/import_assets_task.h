@@ -3,6 +3,8 @@
 #include "halley/file/path.h"
 #include "import_assets_database.h"
 #include "halley/data_structures/vector.h"
+#include "halley/data_structures/hash_map.h"
+#include <condition_variable>
 #include <set>
 
 #include "asset_collector.h"
@@ -10,6 +12,8 @@
 namespace Halley
 {
 	class Project;
+	class ImportCache;
+	class Stopwatch;
 	
 	class ImportAssetsTask : public Task
 	{
@@ -21,7 +25,6 @@ namespace Halley
 			bool success = false;
 			String errorMsg;
 		};
-		using MetadataFetchCallback = std::function<std::optional<Metadata>(const Path&)>;
 		
 		ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter);
 
@@ -31,6 +34,7 @@ namespace Halley
 	private:
 		ImportAssetsDatabase& db;
 		std::shared_ptr<AssetImporter> importer;
+		std::shared_ptr<ImportCache> cache;
 		Path assetsPath;
 		Project& project;
 		const bool packAfter;
@@ -42,15 +46,40 @@ namespace Halley
 		std::atomic<int64_t> totalImportTime;
 		std::atomic<size_t> assetsImported{};
 		size_t assetsToImport{};
+		std::atomic<size_t> cacheHits{};
+		std::atomic<size_t> cacheMisses{};
 
 		std::mutex mutex;
+
+		// Finished imports waiting to be written to db, which is only done from the task's own thread
+		std::mutex dbMutex;
+		std::condition_variable dbCondition;
+		Vector<std::pair<ImportAssetsDatabaseEntry*, bool>> dbPending;
+		size_t filesFinished = 0;
+
+		struct ImporterTime {
+			int64_t nanoseconds = 0;
+			size_t count = 0;
+		};
+		std::mutex timesMutex;
+		HashMap<const IAssetImporter*, ImporterTime> importerTimes; // Several importers can handle the same type
 		
 		std::string curFileLabel;
 
-		bool doImportAsset(ImportAssetsDatabaseEntry& asset);
+		struct ImportNode;
+		struct PendingImport;
+
+		void schedule(std::function<void()> f);
+		void startImport(ImportAssetsDatabaseEntry& asset);
+		void importNode(std::shared_ptr<PendingImport> pending, ImportNode& node);
+		void finishImport(PendingImport& pending);
+		void onImportFinished(ImportAssetsDatabaseEntry* asset, bool success);
+		void addImporterTime(const IAssetImporter& assetImporter, Stopwatch& timer);
+		void writeToDatabase();
 
 		Vector<Path> loadFont(const ImportAssetsDatabaseEntry& asset, Path dstDir);
 		Vector<Path> genericImporter(const ImportAssetsDatabaseEntry& asset, Path dstDir);
-		ImportResult importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter = {});
+		String getCacheStats() const;
+		String getImporterTimes() const;
 	};
 }
@@ -0,0 +1,35 @@
+#pragma once
+#include "halley/file/path.h"
+#include "halley/plugin/iasset_importer.h"
+#include "import_assets_task.h"
+
+namespace Halley
+{
+	// Local store of previous import results, keyed by a hash of everything that goes into an import,
+	// so identical inputs don't get imported again after a fresh checkout, a branch switch, or on another project sharing the directory.
+	class ImportCache
+	{
+	public:
+		// Salt should cover anything else that affects the output of every importer, e.g. asset version and platforms
+		// Additional inputs are stored relative to assetsSrc, so entries are valid in any checkout
+		ImportCache(Path directory, Vector<Path> assetsSrc, uint64_t salt);
+
+		// Returns nothing if any of the importers is unversioned, as there'd be no way to tell when its output changes
+		std::optional<uint64_t> getKey(const ImportingAsset& asset, const Vector<std::reference_wrapper<IAssetImporter>>& importers) const;
+
+		// Returns nothing if there's no entry, or if any of the additional files read during that import have changed since
+		std::optional<ImportAssetsTask::ImportResult> load(uint64_t key) const;
+
+		// Returns false if the result can't be cached, e.g. because the importer wrote files directly
+		bool store(uint64_t key, const ImportAssetsTask::ImportResult& result);
+
+	private:
+		Path directory;
+		Vector<Path> assetsSrc;
+		uint64_t salt;
+
+		Path getEntryPath(uint64_t key) const;
+		std::optional<Path> makeRelativeToAssetsSrc(const Path& path) const;
+		std::optional<Path> resolveInAssetsSrc(const Path& relativePath) const;
+	};
+}
@@ -28,6 +28,9 @@ namespace Halley {
 		static bool writeFile(const Path& path, gsl::span<const gsl::byte> data);
 		static bool writeFile(const Path& path, const Bytes& data);
 		static bool writeFile(const Path& path, const String& data);
+		// Writes to a uniquely named file next to path, then renames it over path, so readers never see it truncated or half written
+		static bool replaceFile(const Path& path, gsl::span<const gsl::byte> data);
+		static bool replaceFile(const Path& path, const Bytes& data);
 		static Bytes readFile(const Path& path);
 
 		static Vector<Path> enumerateDirectory(const Path& path);
@@ -21,6 +21,7 @@ namespace Halley
 	class IHalleyEntryPoint;
 	class ProjectLoader;
 	class ImportAssetsDatabase;
+	class ImportCache;
 
 	class HalleyStatics;
 	class IHalleyPlugin;
@@ -92,6 +93,7 @@ namespace Halley
 		ImportAssetType getImportAssetType(const Path& filePath) override;
 
 		const std::shared_ptr<AssetImporter>& getAssetImporter() const;
+		const std::shared_ptr<ImportCache>& getImportCache() const; // Null if disabled
 		Vector<std::unique_ptr<IAssetImporter>> getAssetImportersFromPlugins(ImportAssetType type) const;
 
 		void setDevConServer(DevConServer* server);
@@ -198,6 +200,7 @@ namespace Halley
 		std::unique_ptr<ImportAssetsDatabase> codegenDatabase;
 		std::unique_ptr<ImportAssetsDatabase> sharedCodegenDatabase;
 		std::shared_ptr<AssetImporter> assetImporter;
+		std::shared_ptr<ImportCache> importCache;
 
 		std::unique_ptr<ProjectProperties> properties;
 		std::unique_ptr<ProjectComments> comments;
@@ -28,6 +28,10 @@ namespace Halley {
 		bool getImportByExtension() const;
     	void setImportByExtension(bool enabled);
 
+    	// Directory for the import cache, relative to the project root. Empty if disabled.
+    	const String& getImportCache() const;
+    	void setImportCache(String path);
+
     	void setDefaultZoom(float zoom);
 		float getDefaultZoom() const;
 
@@ -43,6 +47,7 @@ namespace Halley {
         I18NLanguage originalLanguage;
         Vector<I18NLanguage> languages;
     	bool importByExtension = false;
+    	String importCache;
     	float defaultZoom = 1.0f;
     	Vector<String> platforms;
 
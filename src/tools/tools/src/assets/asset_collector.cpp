@@ -8,6 +8,19 @@
 
 using namespace Halley;
 
+namespace {
+	// Largest compressed/original size ratio worth keeping, for assets set to "auto" compression.
+	// Streamed audio is read and decompressed on the fly, so it has to save more to be worth it.
+	float getMaxCompressionRatio(AssetType type)
+	{
+		switch (type) {
+		case AssetType::AudioClip:
+			return 0.75f;
+		default:
+			return 0.9f;
+		}
+	}
+}
 
 AssetCollector::AssetCollector(const ImportingAsset& asset, const Path& dstDir, const Vector<Path>& assetsSrc, ProgressReporter reporter)
 	: asset(asset)
@@ -22,11 +35,25 @@ void AssetCollector::output(const String& name, AssetType type, const Bytes& dat
 	Path filePath = Path(toString(type)) / id;
 	Path fullPath = Path(platform) / filePath;
 
-	if (metadata && metadata->getString("asset_compression", "") == "lz4") {
+	const auto compression = metadata ? metadata->getString("asset_compression", "") : "";
+	if (compression == "lz4" || compression == "auto") {
+		// Chunked, so it can be decompressed in parallel, or streamed
 		Compression::LZ4Options options;
 		options.mode = Compression::LZ4Mode::HC;
-		outFiles.emplace_back(fullPath, Compression::lz4CompressFile(data.byte_span(), {}, options));
-	} else if (metadata && metadata->getString("asset_compression", "") == "deflate") {
+		auto compressed = Compression::lz4CompressChunked(data.byte_span(), options);
+
+		bool keep = true;
+		if (compression == "auto") {
+			// Measure it, and only keep it compressed if it's worth paying for decompression
+			keep = !data.empty() && float(compressed.size()) <= float(data.size()) * getMaxCompressionRatio(type);
+			if (keep) {
+				metadata->set("asset_compression", "lz4");
+			} else {
+				metadata->erase("asset_compression");
+			}
+		}
+		outFiles.emplace_back(fullPath, keep ? std::move(compressed) : data);
+	} else if (compression == "deflate") {
 		auto newData = Compression::compress(data);
 		outFiles.emplace_back(fullPath, newData);
 	} else {
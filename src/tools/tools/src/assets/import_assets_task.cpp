@@ -11,6 +11,7 @@
 #include "halley/support/debug.h"
 #include "halley/tools/file/filesystem_cache.h"
 #include "halley/utils/algorithm.h"
+#include "halley/tools/assets/import_cache.h"
 
 using namespace Halley;
 
@@ -18,6 +19,7 @@ ImportAssetsTask::ImportAssetsTask(String taskName, ImportAssetsDatabase& db, st
 	: Task(std::move(taskName), true, !files.empty(), { files.size() == 1 && files[0].assetId == ":codegen" ? "code" : "assets" })
 	, db(db)
 	, importer(std::move(importer))
+	, cache(project.getImportCache())
 	, assetsPath(std::move(assetsPath))
 	, project(project)
 	, packAfter(packAfter)
@@ -26,45 +28,89 @@ ImportAssetsTask::ImportAssetsTask(String taskName, ImportAssetsDatabase& db, st
 	, totalImportTime(0)
 {}
 
+// One asset in an import. Secondary assets emitted by its importers become child nodes, which are imported as soon as their parent is done.
+struct ImportAssetsTask::ImportNode {
+	ImportingAsset asset;
+	Vector<AssetResource> out;
+	Vector<std::pair<Path, std::optional<Bytes>>> outFiles;
+	Vector<TimestampedPath> additionalInputs;
+	Vector<std::unique_ptr<ImportNode>> children;
+};
+
+// A file from the database being imported, along with all the nodes it generated
+struct ImportAssetsTask::PendingImport {
+	ImportAssetsDatabaseEntry& entry;
+	ImportNode root;
+	std::optional<uint64_t> cacheKey;
+	std::optional<ImportResult> cachedResult;
+	std::atomic<int> nodesLeft = 1;
+
+	std::mutex mutex;
+	bool failed = false;
+	String errorMsg;
+
+	PendingImport(ImportAssetsDatabaseEntry& entry)
+		: entry(entry)
+	{}
+
+	void fail(String msg)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!failed) {
+			failed = true;
+			errorMsg = std::move(msg);
+		}
+	}
+
+	bool hasFailed()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		return failed;
+	}
+
+	// Same order as the nodes were generated in, so the output doesn't depend on scheduling
+	ImportResult collectResult()
+	{
+		ImportResult result;
+		collect(root, result);
+		result.success = !failed;
+		result.errorMsg = errorMsg;
+		return result;
+	}
+
+private:
+	void collect(ImportNode& node, ImportResult& result)
+	{
+		for (auto& o: node.out) {
+			result.out.push_back(std::move(o));
+		}
+		for (auto& f: node.outFiles) {
+			result.outFiles.push_back(std::move(f));
+		}
+		for (auto& i: node.additionalInputs) {
+			result.additionalInputs.push_back(std::move(i));
+		}
+		for (auto& c: node.children) {
+			collect(*c, result);
+		}
+	}
+};
+
 void ImportAssetsTask::run()
 {
 	Stopwatch timer;
-	using namespace std::chrono_literals;
-	auto lastSave = std::chrono::steady_clock::now();
 
 	assetsImported = 0;
 	assetsToImport = files.size();
-	Vector<Future<void>> tasks;
-
-	constexpr bool parallelImport = !Debug::isDebug();
-
-	for (size_t i = 0; i < files.size(); ++i) {
-		auto importFunc = [&, i] () {
-			if (isCancelled()) {
-				return;
-			}
-
-			setProgressLabel(files[i].assetId);
-			if (doImportAsset(files[i])) {
-				++assetsImported;
-				setProgress(float(assetsImported) * 0.98f / float(assetsToImport));
-			}
-
-			auto now = std::chrono::steady_clock::now();
-			if (now - lastSave > 1s) {
-				db.save();
-				lastSave = now;
-			}
-		};
+	filesFinished = 0;
 
-		if (parallelImport) {
-			tasks.push_back(Concurrent::execute(Executors::getCPUAux(), importFunc));
-		} else {
-			importFunc();
-		}
+	for (auto& file: files) {
+		schedule([this, &file] () {
+			startImport(file);
+		});
 	}
 
-	Concurrent::whenAll(tasks.begin(), tasks.end()).wait();
+	writeToDatabase();
 	db.save();
 
 	if (!isCancelled()) {
@@ -93,30 +139,153 @@ void ImportAssetsTask::run()
 	timer.pause();
 	const Time realTime = timer.elapsedNanoseconds() / 1000000000.0;
 	const Time importTime = totalImportTime / 1000000000.0;
-	logInfo("Import took " + toString(realTime) + " seconds, on which " + toString(importTime) + " seconds of work were performed (" + toString(importTime / realTime) + "x realtime)");
+	logInfo("Import took " + toString(realTime) + " seconds, on which " + toString(importTime) + " seconds of work were performed (" + toString(importTime / realTime) + "x realtime)" + getCacheStats());
+	if (!importerTimes.empty()) {
+		logInfo("Time per importer: " + getImporterTimes());
+	}
 }
 
-bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
+void ImportAssetsTask::schedule(std::function<void()> f)
 {
-	auto& fs = project.getFileSystemCache();
-	Stopwatch timer;
+	constexpr bool parallelImport = !Debug::isDebug();
+	if (parallelImport) {
+		Executors::getCPUAux().addToQueue(std::move(f));
+	} else {
+		f();
+	}
+}
+
+void ImportAssetsTask::startImport(ImportAssetsDatabaseEntry& asset)
+{
+	auto pending = std::make_shared<PendingImport>(asset);
+	if (isCancelled()) {
+		onImportFinished(nullptr, false);
+		return;
+	}
+
+	setProgressLabel(asset.assetId + getCacheStats());
+
+	try {
+		// Load files from disk
+		auto& importingAsset = pending->root.asset;
+		importingAsset.assetId = asset.assetId;
+		importingAsset.assetType = asset.assetType;
+		for (const auto& f: asset.inputFiles) {
+			auto meta = db.getMetadata(f.getPath());
+			auto data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+			if (data.empty()) {
+				// Give it a bit and try again if it was empty
+				using namespace std::chrono_literals;
+				std::this_thread::sleep_for(5ms);
+				data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+
+				if (data.empty()) {
+					logError("Data for \"" + toString(asset.srcDir / f.getPath()) + "\" is empty.");
+				}
+			}
+			importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
+		}
+
+		// Reuse a previous import of the exact same inputs, if there is one
+		if (cache && asset.assetType != ImportAssetType::Codegen) {
+			pending->cacheKey = cache->getKey(importingAsset, importer->getImporters(asset.assetType));
+			if (pending->cacheKey) {
+				if (auto cached = cache->load(*pending->cacheKey)) {
+					++cacheHits;
+					pending->cachedResult = std::move(cached);
+					finishImport(*pending);
+					return;
+				}
+				++cacheMisses;
+			}
+		}
+	} catch (const Exception& e) {
+		pending->fail(e.getMessage());
+	} catch (const std::exception& e) {
+		pending->fail(e.what());
+	}
+
+	auto& root = pending->root;
+	importNode(std::move(pending), root);
+}
+
+void ImportAssetsTask::importNode(std::shared_ptr<PendingImport> pending, ImportNode& node)
+{
+	if (!pending->hasFailed() && !isCancelled()) {
+		Stopwatch timer;
+		try {
+			AssetCollector collector(node.asset, assetsPath, importer->getAssetsSrc(), [=] (float, const String&) -> bool { return !isCancelled(); });
+
+			for (const auto& assetImporter: importer->getImporters(node.asset.assetType)) {
+				Stopwatch importerTimer;
+				try {
+					assetImporter.get().import(node.asset, collector);
+				} catch (...) {
+					addImporterTime(assetImporter, importerTimer);
+					node.additionalInputs = collector.getAdditionalInputs();
+					throw;
+				}
+				addImporterTime(assetImporter, importerTimer);
+			}
+
+			node.outFiles = collector.collectOutFiles();
+			node.out = collector.getAssets();
+			node.additionalInputs = collector.getAdditionalInputs();
+
+			// Children are all created before any is scheduled, so nothing else touches this node once they start
+			for (auto& additional: collector.collectAdditionalAssets()) {
+				node.children.push_back(std::make_unique<ImportNode>());
+				node.children.back()->asset = std::move(additional);
+			}
+
+			// Nodes are kept until the whole import is done, but their inputs aren't needed anymore
+			node.asset.inputFiles.clear();
+		} catch (const Exception& e) {
+			pending->fail(e.getMessage());
+		} catch (const std::exception& e) {
+			pending->fail(e.what());
+		}
+
+		timer.pause();
+		totalImportTime += timer.elapsedNanoseconds();
+
+		pending->nodesLeft += int(node.children.size());
+		for (auto& child: node.children) {
+			schedule([this, pending, child = child.get()] () {
+				importNode(pending, *child);
+			});
+		}
+	}
+
+	if (--pending->nodesLeft == 0) {
+		finishImport(*pending);
+	}
+}
+
+void ImportAssetsTask::finishImport(PendingImport& pending)
+{
+	auto& asset = pending.entry;
+	auto result = pending.cachedResult ? std::move(*pending.cachedResult) : pending.collectResult();
 
-	auto result = importAsset(asset, [&] (const Path& path) { return db.getMetadata(path); }, *importer, assetsPath, [=] (float, const String&) -> bool { return !isCancelled(); });
-	
 	if (!result.success) {
 		logError("\"" + asset.assetId + "\" - " + result.errorMsg);
 		asset.additionalInputFiles = std::move(result.additionalInputs);
-		db.markFailed(asset);
-
-		return false;
+		onImportFinished(&asset, false);
+		return;
 	}
-	
+
 	// Check if it didn't get cancelled
 	if (isCancelled()) {
-		return false;
+		onImportFinished(nullptr, false);
+		return;
+	}
+
+	if (pending.cacheKey && !pending.cachedResult) {
+		cache->store(*pending.cacheKey, result);
 	}
 
 	// Retrieve previous output from this asset, and remove any files which went missing
+	auto& fs = project.getFileSystemCache();
 	HashSet<Path> outFiles;
 	outFiles.reserve(result.outFiles.size());
 	for (const auto& p: result.outFiles) {
@@ -126,7 +295,6 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	for (auto& f: previous) {
 		for (auto& v: f.platformVersions) {
 			const Path& curPath = v.second.filepath;
-			//if (!std_ex::contains(result.outFiles, [&] (const std::pair<Path, Bytes>& r) { return r.first == curPath; })) {
 			if (!outFiles.contains(curPath)) {
 				// File no longer exists as part of this asset, remove it
 				fs.remove(assetsPath / curPath);
@@ -138,7 +306,6 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	for (auto& outFile: result.outFiles) {
 		if (outFile.second) {
 			auto path = assetsPath / outFile.first;
-			//logInfo("- " + asset.assetId + " -> " + path + " (" + String::prettySize(outFile.second.size()) + ")");
 			fs.writeFile(path, std::move(*outFile.second));
 		}
 	}
@@ -151,89 +318,88 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 		}
 	}
 
-	// Store output in db
 	asset.additionalInputFiles = std::move(result.additionalInputs);
 	asset.outputFiles = std::move(result.out);
-	db.markAsImported(asset);
-
-	timer.pause();
-	totalImportTime += timer.elapsedNanoseconds();
 
-	return true;
+	++assetsImported;
+	setProgress(float(assetsImported) * 0.98f / float(assetsToImport));
+	onImportFinished(&asset, true);
 }
 
-ImportAssetsTask::ImportResult ImportAssetsTask::importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter)
+void ImportAssetsTask::onImportFinished(ImportAssetsDatabaseEntry* asset, bool success)
 {
-	ImportResult result;
-	
-	try {
-		// Create queue
-		std::list<ImportingAsset> toLoad;
+	{
+		std::unique_lock<std::mutex> lock(dbMutex);
+		if (asset) {
+			dbPending.emplace_back(asset, success);
+		}
+		++filesFinished;
+	}
+	dbCondition.notify_one();
+}
 
-		// Load files from disk
-		ImportingAsset importingAsset;
-		importingAsset.assetId = asset.assetId;
-		importingAsset.assetType = asset.assetType;
-		for (const auto& f: asset.inputFiles) {
-			auto meta = metadataFetcher(f.getPath());
-			auto data = FileSystem::readFile(asset.srcDir / f.getDataPath());
-			if (data.empty()) {
-				// Give it a bit and try again if it was empty
-				using namespace std::chrono_literals;
-				std::this_thread::sleep_for(5ms);
-				data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+void ImportAssetsTask::writeToDatabase()
+{
+	using namespace std::chrono_literals;
+	auto lastSave = std::chrono::steady_clock::now();
+	Vector<std::pair<ImportAssetsDatabaseEntry*, bool>> batch;
+
+	bool done = false;
+	while (!done) {
+		{
+			std::unique_lock<std::mutex> lock(dbMutex);
+			dbCondition.wait_for(lock, 100ms, [&] { return !dbPending.empty() || filesFinished == files.size(); });
+			std::swap(batch, dbPending);
+			done = filesFinished == files.size();
+		}
 
-				if (data.empty()) {
-					logError("Data for \"" + toString(asset.srcDir / f.getPath()) + "\" is empty.");
-				}
+		for (auto& [asset, success]: batch) {
+			if (success) {
+				db.markAsImported(*asset);
+			} else {
+				db.markFailed(*asset);
 			}
-			importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
 		}
-		toLoad.emplace_back(std::move(importingAsset));
+		batch.clear();
 
-		// Import
-		while (!toLoad.empty()) {
-			auto cur = std::move(toLoad.front());
-			toLoad.pop_front();
-			
-			AssetCollector collector(cur, assetsPath, importer.getAssetsSrc(), progressReporter);
+		const auto now = std::chrono::steady_clock::now();
+		if (!done && now - lastSave > 1s) {
+			db.save();
+			lastSave = now;
+		}
+	}
+}
 
-			for (const auto& assetImporter: importer.getImporters(cur.assetType)) {
-				try {
-					assetImporter.get().import(cur, collector);
-				} catch (...) {
-					for (const auto& i: collector.getAdditionalInputs()) {
-						result.additionalInputs.push_back(i);
-					}
-					throw;
-				}
-			}
-			
-			for (auto& additional: collector.collectAdditionalAssets()) {
-				toLoad.emplace_front(std::move(additional));
-			}
+String ImportAssetsTask::getCacheStats() const
+{
+	const size_t hits = cacheHits;
+	const size_t total = hits + cacheMisses;
+	if (total == 0) {
+		return "";
+	}
+	return " [cache hits: " + toString(hits) + "/" + toString(total) + ", " + toString(hits * 100 / total) + "%]";
+}
 
-			for (auto& outFile: collector.collectOutFiles()) {
-				result.outFiles.push_back(std::move(outFile));
-			}
+void ImportAssetsTask::addImporterTime(const IAssetImporter& assetImporter, Stopwatch& timer)
+{
+	timer.pause();
+	std::unique_lock<std::mutex> lock(timesMutex);
+	auto& time = importerTimes[&assetImporter];
+	time.nanoseconds += timer.elapsedNanoseconds();
+	++time.count;
+}
 
-			for (const auto& o: collector.getAssets()) {
-				result.out.push_back(o);
-			}
+String ImportAssetsTask::getImporterTimes() const
+{
+	Vector<std::pair<const IAssetImporter*, ImporterTime>> times(importerTimes.begin(), importerTimes.end());
+	std::sort(times.begin(), times.end(), [] (const auto& a, const auto& b) { return a.second.nanoseconds > b.second.nanoseconds; });
 
-			for (const auto& i: collector.getAdditionalInputs()) {
-				result.additionalInputs.push_back(i);
-			}
+	String result;
+	for (const auto& [assetImporter, time]: times) {
+		if (!result.isEmpty()) {
+			result += ", ";
 		}
-		
-		result.success = true;
-	} catch (const Exception& e) {
-		result.errorMsg = e.getMessage();
-		result.success = false;
-	} catch (const std::exception& e) {
-		result.errorMsg = e.what();
-		result.success = false;
+		result += toString(assetImporter->getType()) + ": " + toString(time.nanoseconds / 1000000) + " ms (" + toString(time.count) + ")";
 	}
-
 	return result;
 }
@@ -0,0 +1,168 @@
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/support/logger.h"
+#include "halley/utils/hash.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+namespace {
+	constexpr int cacheFormatVersion = 2;
+
+	uint64_t hashFile(const Path& path)
+	{
+		return Hash::hash(FileSystem::readFile(path));
+	}
+
+	struct CacheEntry {
+		int formatVersion = cacheFormatVersion;
+		Vector<std::pair<String, uint64_t>> additionalInputs; // Path relative to the assets source, and content hash
+		Vector<AssetResource> out;
+		Vector<std::pair<String, Bytes>> outFiles;
+
+		void serialize(Serializer& s) const
+		{
+			s << formatVersion;
+			s << additionalInputs;
+			s << out;
+			s << outFiles;
+		}
+
+		void deserialize(Deserializer& s)
+		{
+			s >> formatVersion;
+			if (formatVersion == cacheFormatVersion) {
+				s >> additionalInputs;
+				s >> out;
+				s >> outFiles;
+			}
+		}
+	};
+}
+
+ImportCache::ImportCache(Path directory, Vector<Path> assetsSrc, uint64_t salt)
+	: directory(std::move(directory))
+	, assetsSrc(std::move(assetsSrc))
+	, salt(salt)
+{
+}
+
+std::optional<uint64_t> ImportCache::getKey(const ImportingAsset& asset, const Vector<std::reference_wrapper<IAssetImporter>>& importers) const
+{
+	if (std_ex::contains_if(importers, [] (const IAssetImporter& importer) { return importer.getVersion() == 0; })) {
+		return std::nullopt;
+	}
+
+	Hash::Hasher hasher;
+	hasher.feed(salt);
+	hasher.feed(asset.assetId);
+	hasher.feed(asset.assetType);
+	for (const auto& importer: importers) {
+		hasher.feed(importer.get().getType());
+		hasher.feed(importer.get().getVersion());
+	}
+	asset.options.feedToHash(hasher);
+
+	for (const auto& file: asset.inputFiles) {
+		hasher.feed(file.name.getString());
+		hasher.feed(file.data.size());
+		hasher.feedBytes(file.data.byte_span());
+		hasher.feedBytes(Serializer::toBytes(file.metadata).byte_span());
+	}
+
+	return hasher.digest();
+}
+
+std::optional<ImportAssetsTask::ImportResult> ImportCache::load(uint64_t key) const
+{
+	const auto path = getEntryPath(key);
+	if (!FileSystem::exists(path)) {
+		return std::nullopt;
+	}
+
+	CacheEntry entry;
+	try {
+		Deserializer::fromBytes(entry, FileSystem::readFile(path));
+	} catch (const std::exception& e) {
+		Logger::logWarning("Ignoring invalid import cache entry " + path.getString() + ": " + e.what());
+		return std::nullopt;
+	}
+	if (entry.formatVersion != cacheFormatVersion) {
+		return std::nullopt;
+	}
+
+	ImportAssetsTask::ImportResult result;
+	for (const auto& [relativePath, hash]: entry.additionalInputs) {
+		const auto filePath = resolveInAssetsSrc(relativePath);
+		if (!filePath || hashFile(*filePath) != hash) {
+			return std::nullopt;
+		}
+		result.additionalInputs.emplace_back(*filePath, FileSystem::getLastWriteTime(*filePath));
+	}
+
+	result.out = std::move(entry.out);
+	for (auto& [filePath, data]: entry.outFiles) {
+		result.outFiles.emplace_back(Path(filePath), std::move(data));
+	}
+	result.success = true;
+	return result;
+}
+
+bool ImportCache::store(uint64_t key, const ImportAssetsTask::ImportResult& result)
+{
+	if (!result.success) {
+		return false;
+	}
+
+	CacheEntry entry;
+	for (const auto& [filePath, data]: result.outFiles) {
+		if (!data) {
+			return false;
+		}
+		entry.outFiles.emplace_back(filePath.getString(), *data);
+	}
+	for (const auto& input: result.additionalInputs) {
+		const auto relativePath = makeRelativeToAssetsSrc(input.first);
+		if (!relativePath) {
+			return false;
+		}
+		entry.additionalInputs.emplace_back(relativePath->getString(), hashFile(input.first));
+	}
+	entry.out = result.out;
+
+	// Other processes sharing the cache might be reading or storing this entry too, so it must never be seen half written
+	return FileSystem::replaceFile(getEntryPath(key), Serializer::toBytes(entry));
+}
+
+Path ImportCache::getEntryPath(uint64_t key) const
+{
+	const auto name = toString(key, 16, 16);
+	return directory / name.left(2) / (name + ".dat");
+}
+
+std::optional<Path> ImportCache::makeRelativeToAssetsSrc(const Path& path) const
+{
+	// Paths recorded by AssetCollector::readAdditionalFile are always root / relativePath
+	const auto& parts = path.getParts();
+	for (const auto& root: assetsSrc) {
+		const auto& rootParts = root.getParts();
+		const size_t n = rootParts.size() - (root.isDirectory() ? 1 : 0);
+		if (parts.size() > n && std::equal(rootParts.begin(), rootParts.begin() + n, parts.begin())) {
+			return path.dropFront(int(n));
+		}
+	}
+	return std::nullopt;
+}
+
+std::optional<Path> ImportCache::resolveInAssetsSrc(const Path& relativePath) const
+{
+	// Same lookup as AssetCollector::readAdditionalFile
+	for (const auto& root: assetsSrc) {
+		auto path = root / relativePath;
+		if (FileSystem::exists(path)) {
+			return path;
+		}
+	}
+	return std::nullopt;
+}
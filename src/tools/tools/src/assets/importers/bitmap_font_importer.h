@@ -9,6 +9,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::BitmapFont; }
+		int getVersion() const override { return 1; }
 
 		String getAssetId(const Path& file, const std::optional<Metadata>& metadata) const override;
 
@@ -7,6 +7,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::Codegen; }
+		int getVersion() const override { return 1; }
 
 		String getAssetId(const Path& file, const std::optional<Metadata>& metadata) const override;
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
@@ -10,6 +10,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::ConfigFile; }
+		int getVersion() const override { return 2; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
@@ -18,6 +19,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::Prefab; }
+		int getVersion() const override { return 2; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
@@ -26,6 +28,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::Scene; }
+		int getVersion() const override { return 2; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
@@ -34,6 +37,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::NavmeshSet; }
+		int getVersion() const override { return 2; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
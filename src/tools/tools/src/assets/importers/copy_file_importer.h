@@ -9,6 +9,7 @@ namespace Halley
 		CopyFileImporter(ImportAssetType importType, AssetType outputType);
 		
 		ImportAssetType getType() const override { return importType; }
+		int getVersion() const override { return 1; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 		int dropFrontCount() const override { return 0; }
@@ -12,7 +12,7 @@ void GamePropertiesImporter::import(const ImportingAsset& asset, IAssetCollector
 	ConfigFile config = YAMLConvert::parseConfig(gsl::as_bytes(gsl::span<const Byte>(asset.inputFiles.at(0).data)));
 	
 	Metadata meta = asset.inputFiles.at(0).metadata;
-	meta.set("asset_compression", "lz4");
+	meta.set("asset_compression", "auto");
 
 	auto properties = GameProperties(config.getRoot());
 
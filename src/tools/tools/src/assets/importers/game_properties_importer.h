@@ -7,6 +7,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::GameProperties; }
+		int getVersion() const override { return 2; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
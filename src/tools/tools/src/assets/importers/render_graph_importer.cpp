@@ -11,7 +11,7 @@ void RenderGraphImporter::import(const ImportingAsset& asset, IAssetCollector& c
 	ConfigFile config = YAMLConvert::parseConfig(gsl::as_bytes(gsl::span<const Byte>(asset.inputFiles.at(0).data)));
 	
 	Metadata meta = asset.inputFiles.at(0).metadata;
-	meta.set("asset_compression", "lz4");
+	meta.set("asset_compression", "auto");
 
 	auto renderGraph = RenderGraphDefinition(config.getRoot());
 
@@ -10,6 +10,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::Shader; }
+		int getVersion() const override { return 1; }
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 
 		static Bytes convertHLSL(const String& name, ShaderType type, const Bytes& data, const String& dstLanguage);
@@ -15,6 +15,7 @@ namespace Halley
 		using ImageData = SpriteSheet::ImageData;
 
 		ImportAssetType getType() const override { return ImportAssetType::Sprite; }
+		int getVersion() const override { return 1; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 		String getAssetId(const Path& file, const std::optional<Metadata>& metadata) const override;
@@ -12,7 +12,7 @@ void SpriteSheetImporter::import(const ImportingAsset& asset, IAssetCollector& c
 	sheet.load(YAMLConvert::parseConfig(asset.inputFiles.at(0).data).getRoot());
 
 	Metadata meta = asset.inputFiles.at(0).metadata;
-	meta.set("asset_compression", "lz4");
+	meta.set("asset_compression", "auto");
 
 	const auto dstPath = Path(asset.assetId).replaceExtension("").string();
 	collector.output(dstPath, AssetType::SpriteSheet, Serializer::toBytes(sheet, SerializerOptions(SerializerOptions::maxVersion)), meta);
@@ -214,6 +214,7 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 	String serializeBody = "using namespace Halley::EntitySerialization;" + lineBreak + "Halley::ConfigNode _node = Halley::ConfigNode::MapType();" + lineBreak;
 	String deserializeBody = "using namespace Halley::EntitySerialization;" + lineBreak;
 	String sanitizeBody = "using namespace Halley::EntitySerialization;" + lineBreak;
+	String feedToHashBody = "using namespace Halley::EntitySerialization;";
 	{
 		bool first = true;
 		for (auto& member: component.members) {
@@ -238,6 +239,7 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 			serializeBody += "Halley::EntityConfigNodeSerializer<decltype(" + member.name + ")>::serialize(" + member.name + ", " + CPPClassGenerator::getAnonString(member) + ", _context, _node, componentName, \"" + member.name + "\", " + mask + ");";
 			deserializeBody += "Halley::EntityConfigNodeSerializer<decltype(" + member.name + ")>::deserialize(" + member.name + ", " + CPPClassGenerator::getAnonString(member) + ", _context, _node, componentName, \"" + member.name + "\", " + mask + ");";
 			sanitizeBody += "if ((_mask & " + mask + ") == 0) _node.removeKey(\"" + member.name + "\");";
+			feedToHashBody += lineBreak + "Halley::EntityConfigNodeSerializer<decltype(" + member.name + ")>::feedToHash(" + member.name + ", _context, _hasher, " + mask + ");";
 		}
 	}
 	serializeBody += lineBreak + "return _node;";
@@ -331,6 +333,10 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 			VariableSchema(TypeSchema("Halley::ConfigNode&"), "_node"), VariableSchema(TypeSchema("int"), "_mask")
 		}, "sanitize"), sanitizeBody)
 		.addBlankLine()
+		.addMethodDefinition(MethodSchema(TypeSchema("void"), {
+			VariableSchema(TypeSchema("Halley::EntitySerializationContext&", true), "_context"), VariableSchema(TypeSchema("Halley::Hash::Hasher&"), "_hasher")
+		}, "feedToHash", true), feedToHashBody)
+		.addBlankLine()
 		.addMethodDefinition(MethodSchema(TypeSchema("Halley::ConfigNode"), {
 			VariableSchema(TypeSchema("Halley::EntitySerializationContext&", true), "_context"), VariableSchema(TypeSchema("std::string_view"), "_fieldName")
 		}, "serializeField", true), serializeFieldBody)
@@ -496,7 +502,8 @@ Vector<String> CodegenCPP::generateSystemHeader(SystemSchema& system, const Hash
 				.addBlankLine()
 				.addTypeDefinition("Type", "Halley::FamilyType<" + String::concatList(convert<ComponentReferenceSchema, String>(fam.components, [](auto& comp)
 				{
-					return comp.optional ? "Halley::MaybeRef<" + comp.name + "Component>" : comp.name + "Component";
+					const String type = (comp.write ? "" : "const ") + comp.name + "Component";
+					return comp.optional ? "Halley::MaybeRef<" + type + ">" : type;
 				}), ", ") + ">")
 				.addBlankLine()
 				.addMethodDefinition(MethodSchema(TypeSchema("void"), {}, "prefetch", true), prefetchBody)
@@ -746,11 +753,23 @@ Vector<String> CodegenCPP::generateSystemHeader(SystemSchema& system, const Hash
 			}, "canHandleSystemMessage", true, false, true, true), canReceiveBody);
 	}
 
+	Vector<String> constructorBody = { "static_assert(std::is_final_v<T>, \"System must be final.\");" };
+	if (system.concurrent) {
+		Vector<String> entityMsgsSent;
+		for (auto& msg : system.messages) {
+			if (msg.send) {
+				entityMsgsSent.push_back(msg.name + "Message::messageIndex");
+			}
+		}
+		const auto servicesUsed = convert<ServiceSchema, String>(system.services, [](auto& service) { return "\"" + service.name + "\""; });
+		constructorBody.push_back("declareConcurrentAccess({" + String::concatList(entityMsgsSent, ", ") + "}, {" + String::concatList(servicesUsed, ", ") + "});");
+	}
+
 	sysClassGen
 		.setAccessLevel(MemberAccess::Public)
 		.addCustomConstructor({}, {
 			VariableSchema(TypeSchema(""), "System", "{" + String::concatList(convert<FamilySchema, String>(system.families, [](auto& fam) { return "&" + fam.name + "Family"; }), ", ") + "}, {" + String::concatList(entityMsgsReceived, ", ") + "}")
-		}, { "static_assert(std::is_final_v<T>, \"System must be final.\");" })
+		}, constructorBody)
 		.finish()
 		.writeTo(contents);
 
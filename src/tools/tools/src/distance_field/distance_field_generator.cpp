@@ -2,6 +2,7 @@
 #include <cassert>
 #include <halley/file_formats/image.h>
 #include <gsl/assert>
+#include <halley/concurrency/concurrent.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -12,37 +13,85 @@
 using namespace Halley;
 
 namespace {
-	float getDistanceAt(const int* src, int srcW, int srcH, int xCentre, int yCentre, float radius)
+	constexpr float edtInfinity = 1e20f;
+
+	// Felzenszwalb-Huttenlocher 1D distance transform: dst[q] = min over p of (q - p)^2 + f[p]
+	// v, z and fCopy are scratch space of size n, n + 1 and n.
+	void distanceTransform1D(float* f, size_t stride, int n, int* v, float* z, float* fCopy)
 	{
-		auto getAlpha = [&](int x, int y) { return (src[x + y * srcW] & 0xFF000000) >> 24; };
-		bool isInside = getAlpha(xCentre, yCentre) > 127;
-		if (radius < 0.001f) {
-			return isInside ? 1.0f : 0.0f;
+		for (int q = 0; q < n; ++q) {
+			fCopy[q] = f[q * stride];
 		}
 
-		int iRadius = int(ceil(radius));
-		int x0 = std::max(0, xCentre - iRadius);
-		int x1 = std::min(xCentre + iRadius, srcW - 1);
-		int y0 = std::max(0, yCentre - iRadius);
-		int y1 = std::min(yCentre + iRadius, srcH - 1);
-
-		int bestDistSqr = 2147483647;
-		for (int y = y0; y <= y1; y++) {
-			for (int x = x0; x <= x1; x++) {
-				bool thisInside = getAlpha(x, y) > 127;
-				if (isInside != thisInside) {
-					// Candidate for best neighbour
-					int distSqr = (x - xCentre) * (x - xCentre) + (y - yCentre) * (y - yCentre);
-					bestDistSqr = std::min(distSqr, bestDistSqr);
+		// Lower envelope of the parabolas rooted at each point
+		int k = 0;
+		v[0] = 0;
+		z[0] = -edtInfinity;
+		z[1] = edtInfinity;
+		for (int q = 1; q < n; ++q) {
+			if (fCopy[q] >= edtInfinity) {
+				// Never the closest, no point adding it
+				continue;
+			}
+			if (k == 0 && fCopy[v[0]] >= edtInfinity) {
+				v[0] = q;
+				continue;
+			}
+			double s;
+			while (true) {
+				const int p = v[k];
+				s = ((double(fCopy[q]) + double(q) * q) - (double(fCopy[p]) + double(p) * p)) / (2.0 * (q - p));
+				if (s > z[k] || k == 0) {
+					break;
 				}
+				--k;
+			}
+			++k;
+			v[k] = q;
+			z[k] = float(s);
+			z[k + 1] = edtInfinity;
+		}
+
+		k = 0;
+		for (int q = 0; q < n; ++q) {
+			while (z[k + 1] < float(q)) {
+				++k;
 			}
+			const int p = v[k];
+			f[q * stride] = fCopy[p] >= edtInfinity ? edtInfinity : float(q - p) * float(q - p) + fCopy[p];
 		}
+	}
 
-		const float dist = float(sqrt(bestDistSqr));
-		const float normalDistance = (2 * dist - 1) / (2 * radius);
-		const float finalValue = 0.5f * (isInside ? 1.0f + normalDistance : 1.0f - normalDistance);
+	// For every pixel, squared distance to the closest pixel where isTarget is true
+	template <typename F>
+	Vector<float> squaredDistanceTransform(int w, int h, F isTarget)
+	{
+		Vector<float> dist(size_t(w) * size_t(h));
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				dist[x + y * w] = isTarget(x, y) ? 0.0f : edtInfinity;
+			}
+		}
 
-		return finalValue;
+		// Columns, then rows; each line is independent
+		Concurrent::parallelFor(size_t(w), 0, [&] (size_t start, size_t end) {
+			Vector<int> v(h);
+			Vector<float> z(h + 1);
+			Vector<float> f(h);
+			for (size_t x = start; x < end; ++x) {
+				distanceTransform1D(dist.data() + x, size_t(w), h, v.data(), z.data(), f.data());
+			}
+		});
+		Concurrent::parallelFor(size_t(h), 0, [&] (size_t start, size_t end) {
+			Vector<int> v(w);
+			Vector<float> z(w + 1);
+			Vector<float> f(w);
+			for (size_t y = start; y < end; ++y) {
+				distanceTransform1D(dist.data() + y * w, 1, w, v.data(), z.data(), f.data());
+			}
+		});
+
+		return dist;
 	}
 
 	std::unique_ptr<Image> generateSDFInternal(Image& srcImg, Vector2i size, float radius)
@@ -59,24 +108,46 @@ namespace {
 		const int h = size.y;
 		const auto dstStart = dstImg->getPixelBytes();
 
-		int texelW = srcW / w;
-		int texelH = srcH / h;
-
-		for (int y = 0; y < h; y++) {
-			for (int x = 0; x < w; x++) {
-				unsigned char* dst = &dstStart[x + y * w];
-				float distAcc = 0;
-				// For each sub-pixel, compute the distance to closest pixel of the opposite value
-				// Then average it all
-				for (int j = 0; j < texelH; j++) {
-					for (int i = 0; i < texelW; i++) {
-						distAcc += getDistanceAt(src.data(), srcW, srcH, x * srcW / w + i, y * srcH / h + j, radius * srcW / w);
+		const int texelW = srcW / w;
+		const int texelH = srcH / h;
+		const float srcRadius = radius * srcW / w;
+
+		auto isInside = [&] (int x, int y) { return ((src[x + y * srcW] & 0xFF000000) >> 24) > 127; };
+
+		// Distance from every source pixel to the closest one of the opposite value, computed once for the whole image
+		const auto distToInside = squaredDistanceTransform(srcW, srcH, isInside);
+		const auto distToOutside = squaredDistanceTransform(srcW, srcH, [&] (int x, int y) { return !isInside(x, y); });
+
+		auto getDistanceAt = [&] (int x, int y)
+		{
+			const bool inside = isInside(x, y);
+			if (srcRadius < 0.001f) {
+				return inside ? 1.0f : 0.0f;
+			}
+
+			// Same cap as an integer squared distance, for when there's nothing of the opposite value
+			const float distSqr = std::min((inside ? distToOutside : distToInside)[x + y * srcW], 2147483647.0f);
+			const float dist = std::sqrt(distSqr);
+			const float normalDistance = (2 * dist - 1) / (2 * srcRadius);
+			return 0.5f * (inside ? 1.0f + normalDistance : 1.0f - normalDistance);
+		};
+
+		Concurrent::parallelFor(size_t(h), 0, [&] (size_t start, size_t end) {
+			for (int y = int(start); y < int(end); y++) {
+				for (int x = 0; x < w; x++) {
+					unsigned char* dst = &dstStart[x + y * w];
+					float distAcc = 0;
+					// Average the distance of each sub-pixel
+					for (int j = 0; j < texelH; j++) {
+						for (int i = 0; i < texelW; i++) {
+							distAcc += getDistanceAt(x * srcW / w + i, y * srcH / h + j);
+						}
 					}
+					int distance = clamp(int(distAcc * 255 / (texelW * texelH)), 0, 255);
+					*dst = static_cast<unsigned char>(distance);
 				}
-				int distance = clamp(int(distAcc * 255 / (texelW * texelH)), 0, 255);
-				*dst = static_cast<unsigned char>(distance);
 			}
-		}
+		});
 
 		return dstImg;
 	}
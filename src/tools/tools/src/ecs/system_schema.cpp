@@ -165,6 +165,13 @@ SystemSchema::SystemSchema(YAML::Node node, bool generate)
 			services.push_back(ServiceSchema(serviceEntry.as<std::string>()));
 		}
 	}
+
+	// Systems that can reach the world or the API outside of their families, or that send system messages, can't be safely scheduled concurrently
+	// Parallel systems are also excluded, as they would be waiting on the same thread pool
+	const bool sendsSystemMessages = std::any_of(systemMessages.begin(), systemMessages.end(), [] (const MessageReferenceSchema& msg) { return msg.send; });
+	const bool exclusiveAccess = (int(access) & (int(SystemAccess::World) | int(SystemAccess::API) | int(SystemAccess::MessageBridge))) != 0;
+	const bool canBeConcurrent = method == SystemMethod::Update && language == CodegenLanguage::CPlusPlus && strategy != SystemStrategy::Parallel && !exclusiveAccess && !sendsSystemMessages;
+	concurrent = node["concurrent"].as<bool>(canBeConcurrent);
 }
 
 bool SystemSchema::operator<(const SystemSchema& other) const
@@ -8,6 +8,8 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#else
+#include <unistd.h>
 #endif
 
 using namespace Halley;
@@ -18,6 +20,15 @@ static path getNative(const Path& p)
 	return path(p.string());
 }
 
+static uint32_t getProcessId()
+{
+#ifdef _WIN32
+	return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+	return static_cast<uint32_t>(getpid());
+#endif
+}
+
 bool FileSystem::exists(const Path& p)
 {
 	std::error_code ec;
@@ -94,9 +105,8 @@ bool FileSystem::writeFile(const Path& path, gsl::span<const gsl::byte> data)
 		return false;
 	}
 
-	fwrite(data.data(), 1, data.size(), fp);
-	fclose(fp);
-	return true;
+	const bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+	return fclose(fp) == 0 && ok;
 }
 
 bool FileSystem::writeFile(const Path& path, const Bytes& data)
@@ -109,6 +119,28 @@ bool FileSystem::writeFile(const Path& path, const String& data)
 	return writeFile(path, as_bytes(gsl::span<const char>(data.c_str(), data.length())));
 }
 
+bool FileSystem::replaceFile(const Path& path, gsl::span<const gsl::byte> data)
+{
+	// Several processes (and threads) might be replacing the same file at once
+	const auto tmpPath = Path(path.getString() + ".tmp" + toString(getProcessId(), 16) + "_" + toString(Random::getGlobal().getRawInt(), 16));
+	if (!writeFile(tmpPath, data)) {
+		remove(tmpPath);
+		return false;
+	}
+
+	// Renaming over the old file replaces it atomically, and anyone who still has it open or mapped keeps the old contents
+	if (!rename(tmpPath, path)) {
+		remove(tmpPath);
+		return false;
+	}
+	return true;
+}
+
+bool FileSystem::replaceFile(const Path& path, const Bytes& data)
+{
+	return replaceFile(path, as_bytes(gsl::span<const Byte>(data)));
+}
+
 Bytes FileSystem::readFile(const Path& path)
 {
 	Bytes result;
@@ -268,12 +268,13 @@ void AssetPacker::generatePack(Project& project, const String& packId, const Ass
 
 	// Write pack
 	const auto packData = pack.writeOut();
-	bool packed = FileSystem::writeFile(dst, packData);
+	// Never write over the pack in place: a running game might have it mapped
+	bool packed = FileSystem::replaceFile(dst, packData);
 	if (!packed) {
 		// Try again
 		using namespace std::chrono_literals;
 		std::this_thread::sleep_for(200ms);
-		packed = FileSystem::writeFile(dst, packData);
+		packed = FileSystem::replaceFile(dst, packData);
 	}
 
 	if (packed) {
@@ -1,5 +1,6 @@
 #include <utility>
 #include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/assets/import_cache.h"
 #include "halley/tools/project/project.h"
 
 #include "halley/api/halley_api.h"
@@ -23,6 +24,8 @@
 #include "halley/tools/file/filesystem_cache.h"
 #include "halley/tools/project/project_comments.h"
 #include "halley/utils/algorithm.h"
+#include "halley/utils/hash.h"
+#include "halley/version/version.h"
 
 using namespace Halley;
 
@@ -77,6 +80,20 @@ void Project::setupImporter(Vector<HalleyPluginPtr> plugins, const ConfigNode& i
 	if (plugins != this->plugins || !assetImporter) {
 		this->plugins = std::move(plugins);
 		assetImporter = std::make_shared<AssetImporter>(*this, Vector<Path>{getSharedAssetsSrcPath(), getAssetsSrcPath()}, ConfigNode(importerOptions));
+
+		const auto& cachePath = properties->getImportCache();
+		if (!cachePath.isEmpty()) {
+			Hash::Hasher hasher;
+			hasher.feed(getHalleyVersion());
+			hasher.feed(currentAssetVersion);
+			for (const auto& platform: platforms) {
+				hasher.feed(platform);
+			}
+			importerOptions.feedToHash(hasher);
+			importCache = std::make_shared<ImportCache>(rootPath / cachePath, assetImporter->getAssetsSrc(), hasher.digest());
+		} else {
+			importCache = {};
+		}
 	}
 }
 
@@ -232,6 +249,11 @@ const std::shared_ptr<AssetImporter>& Project::getAssetImporter() const
 	return assetImporter;
 }
 
+const std::shared_ptr<ImportCache>& Project::getImportCache() const
+{
+	return importCache;
+}
+
 Vector<std::unique_ptr<IAssetImporter>> Project::getAssetImportersFromPlugins(ImportAssetType type) const
 {
 	Vector<std::unique_ptr<IAssetImporter>> result;
@@ -72,6 +72,17 @@ void ProjectProperties::setImportByExtension(bool enabled)
 	dirty = true;
 }
 
+const String& ProjectProperties::getImportCache() const
+{
+	return importCache;
+}
+
+void ProjectProperties::setImportCache(String path)
+{
+	importCache = std::move(path);
+	dirty = true;
+}
+
 void ProjectProperties::setDefaultZoom(float zoom)
 {
 	defaultZoom = zoom;
@@ -100,6 +111,7 @@ void ProjectProperties::loadDefaults()
 	assetPackManifest = "halley_project/asset_manifest.yaml";
 	binName = "";
 	importByExtension = false;
+	importCache = "";
 	defaultZoom = 1.0f;
 	platforms = {"pc"};
 	originalLanguage = I18NLanguage("en");
@@ -131,6 +143,9 @@ void ProjectProperties::load()
 		if (node.hasKey("importByExtension")) {
 			importByExtension = node["importByExtension"].asBool();
 		}
+		if (node.hasKey("importCache")) {
+			importCache = node["importCache"].asString();
+		}
 		if (node.hasKey("defaultZoom")) {
 			defaultZoom = node["defaultZoom"].asFloat();
 		}
@@ -155,6 +170,9 @@ void ProjectProperties::save()
 	node["assetPackManifest"] = assetPackManifest;
 	node["binName"] = binName;
 	node["importByExtension"] = importByExtension;
+	if (!importCache.isEmpty()) {
+		node["importCache"] = importCache;
+	}
 	node["defaultZoom"] = defaultZoom;
 	node["platforms"] = platforms;
 	node["originalLanguage"] = originalLanguage;